@@ -23,6 +23,7 @@
 #include "common/list_utils.h"
 #include "common/mp4.h"
 #include "common/strings/formatting.h"
+#include "common/sync_word_searcher.h"
 
 namespace aac {
 
@@ -763,16 +764,20 @@ parser_c::find_consecutive_frames(unsigned char const *buffer,
                                   size_t num_required_frames) {
   static auto s_debug = debugging_option_c{"aac_consecutive_frames"};
 
-  for (size_t base = 0; (base + 8) < buffer_size; ++base) {
+  // Speeding up checks by only going through the parser at positions
+  // with supported header types (ADTS and LOAS/LATM) instead of at
+  // each byte position.
+  static auto const s_searcher = mtx::sync_word_searcher_c{
+    { AAC_ADTS_SYNC_WORD, AAC_ADTS_SYNC_WORD_MASK, 3 },
+    { AAC_LOAS_SYNC_WORD, AAC_LOAS_SYNC_WORD_MASK, 3 },
+  };
+
+  auto end = buffer_size > 8 ? buffer_size - 8 : 0;
+
+  for (auto base = s_searcher.find(buffer, buffer_size, 0, end); std::string::npos != base; base = s_searcher.find(buffer, buffer_size, base + 1, end)) {
     mxdebug_if(s_debug, boost::format("Starting search for %2% headers with base %1%, buffer size %3%\n") % base % num_required_frames % buffer_size);
 
     auto value = get_uint24_be(&buffer[base]);
-    // Speeding up checks by using shortcuts here instead of going
-    // through the parser for each byte position: check for supported
-    // header types (ADTS and LOAS/LATM).
-    if (   ((value & AAC_ADTS_SYNC_WORD_MASK) != AAC_ADTS_SYNC_WORD)
-        && ((value & AAC_LOAS_SYNC_WORD_MASK) != AAC_LOAS_SYNC_WORD))
-      continue;
 
     if ((value & AAC_LOAS_SYNC_WORD_MASK) == AAC_LOAS_SYNC_WORD) {
       // Check for second LOAS header right after the current one.
@@ -21,6 +21,15 @@
 #include "common/byte_buffer.h"
 #include "common/checksums/base.h"
 #include "common/endian.h"
+#include "common/sync_word_searcher.h"
+
+namespace {
+
+mtx::sync_word_searcher_c const s_sync_word_searcher{
+  { AC3_SYNC_WORD, 0xffff, 2 },
+};
+
+}
 
 ac3::frame_c::frame_c() {
   init();
@@ -200,7 +209,7 @@ ac3::frame_c::find_in(memory_cptr const &buffer) {
 int
 ac3::frame_c::find_in(unsigned char const *buffer,
                       size_t buffer_size) {
-  for (size_t offset = 0; offset < buffer_size; ++offset)
+  for (auto offset = s_sync_word_searcher.find(buffer, buffer_size); std::string::npos != offset; offset = s_sync_word_searcher.find(buffer, buffer_size, offset + 1))
     if (decode_header(&buffer[offset], buffer_size - offset))
       return offset;
   return -1;
@@ -350,16 +359,19 @@ ac3::parser_c::find_consecutive_frames(unsigned char const *buffer,
   do {
     mxdebug_if(s_debug, boost::format("Starting search for %2% headers with base %1%, buffer size %3%\n") % base % num_required_headers % buffer_size);
 
-    size_t position = base;
+    auto end      = buffer_size > 8 ? buffer_size - 8 : 0;
+    auto position = s_sync_word_searcher.find(buffer, buffer_size, base, end);
 
     ac3::frame_c first_frame;
-    while (((position + 8) < buffer_size) && !first_frame.decode_header(&buffer[position], buffer_size - position))
-      ++position;
+    while ((std::string::npos != position) && !first_frame.decode_header(&buffer[position], buffer_size - position))
+      position = s_sync_word_searcher.find(buffer, buffer_size, position + 1, end);
 
-    mxdebug_if(s_debug, boost::format("First frame at %1% valid %2%\n") % position % first_frame.m_valid);
-
-    if (!first_frame.m_valid)
+    if (std::string::npos == position) {
+      mxdebug_if(s_debug, boost::format("No valid first frame found\n"));
       return -1;
+    }
+
+    mxdebug_if(s_debug, boost::format("First frame at %1% valid %2%\n") % position % first_frame.m_valid);
 
     size_t offset            = position + first_frame.m_bytes;
     size_t num_headers_found = 1;
@@ -17,16 +17,29 @@
 
 #include "common/common_pch.h"
 
+#include "common/math.h"
 #include "common/mm_io_x.h"
 
+/* The reader keeps up to 64 bits in a cache. The next bit to read is
+   the cache's most significant bit; m_cache_bits is the number of
+   valid bits. m_byte_position points to the first byte that hasn't
+   been loaded into the cache yet. Bits below the valid ones are either
+   zero or already contain the following bytes' bits at their final
+   positions so that refilling can simply OR new bytes in. */
+
 class bit_reader_c {
 private:
   const unsigned char *m_end_of_data;
   const unsigned char *m_byte_position;
   const unsigned char *m_start_of_data;
-  std::size_t m_bits_valid;
+  uint64_t m_cache;
+  std::size_t m_cache_bits;
   bool m_out_of_data;
 
+  // The maximum number of bits that a single refill guarantees to be
+  // available if there's enough data left.
+  static std::size_t const s_max_bits_per_refill = 56;
+
 public:
   bit_reader_c(unsigned char const *data, std::size_t len) {
     init(data, len);
@@ -36,7 +49,8 @@ public:
     m_end_of_data   = data + len;
     m_byte_position = data;
     m_start_of_data = data;
-    m_bits_valid    = len ? 8 : 0;
+    m_cache         = 0;
+    m_cache_bits    = 0;
     m_out_of_data   = m_byte_position >= m_end_of_data;
   }
 
@@ -45,39 +59,31 @@ public:
   }
 
   uint64_t get_bits(std::size_t n) {
-    uint64_t r = 0;
-
-    while (n > 0) {
-      if (m_byte_position >= m_end_of_data) {
-        m_out_of_data = true;
-        throw mtx::mm_io::end_of_file_x();
-      }
-
-      std::size_t b = 8; // number of bits to extract from the current byte
-      if (b > n)
-        b = n;
-      if (b > m_bits_valid)
-        b = m_bits_valid;
-
-      std::size_t rshift = m_bits_valid - b;
-
-      r <<= b;
-      r  |= ((*m_byte_position) >> rshift) & (0xff >> (8 - b));
+    if (!n)
+      return 0;
 
-      m_bits_valid -= b;
-      if (0 == m_bits_valid) {
-        m_bits_valid     = 8;
-        m_byte_position += 1;
-      }
+    if (n > s_max_bits_per_refill) {
+      auto high = get_bits(n - 32);
+      return (high << 32) | get_bits(32);
+    }
 
-      n -= b;
+    if (n > m_cache_bits) {
+      refill();
+      if (n > m_cache_bits)
+        throw_end_of_data();
     }
 
-    return r;
+    return consume(n);
   }
 
   inline int get_bit() {
-    return get_bits(1);
+    if (!m_cache_bits) {
+      refill();
+      if (!m_cache_bits)
+        throw_end_of_data();
+    }
+
+    return consume(1);
   }
 
   inline int get_unary(bool stop,
@@ -97,14 +103,28 @@ public:
   }
 
   inline uint64_t get_unsigned_golomb() {
+    if (m_cache_bits < 32)
+      refill();
+
+    // Fast path: the leading zeros, the marker bit and the value bits
+    // are all in the cache.
+    if (m_cache) {
+      auto num_bits = 2 * mtx::math::count_leading_zeros(m_cache) + 1;
+      if (num_bits <= m_cache_bits)
+        return consume(num_bits) - 1;
+    }
+
     int n = 0;
 
+    // More than 63 leading zeros cannot be the start of a valid code;
+    // the value wouldn't fit into 64 bits.
     while (get_bit() == 0)
-      ++n;
+      if (++n > 63)
+        throw mtx::mm_io::end_of_file_x();
 
     auto bits = get_bits(n);
 
-    return (1u << n) - 1 + bits;
+    return (1ull << n) - 1 + bits;
   }
 
   inline int64_t get_signed_golomb() {
@@ -113,53 +133,69 @@ public:
   }
 
   uint64_t peek_bits(std::size_t n) {
-    uint64_t r                             = 0;
-    const unsigned char *tmp_byte_position = m_byte_position;
-    std::size_t tmp_bits_valid                  = m_bits_valid;
-
-    while (0 < n) {
-      if (tmp_byte_position >= m_end_of_data)
-        throw mtx::mm_io::end_of_file_x();
-
-      std::size_t b = 8; // number of bits to extract from the current byte
-      if (b > n)
-        b = n;
-      if (b > tmp_bits_valid)
-        b = tmp_bits_valid;
-
-      std::size_t rshift = tmp_bits_valid - b;
-
-      r <<= b;
-      r  |= ((*tmp_byte_position) >> rshift) & (0xff >> (8 - b));
+    if (!n)
+      return 0;
 
-      tmp_bits_valid -= b;
-      if (0 == tmp_bits_valid) {
-        tmp_bits_valid     = 8;
-        tmp_byte_position += 1;
+    if (n <= s_max_bits_per_refill) {
+      if (n > m_cache_bits) {
+        refill();
+        if (n > m_cache_bits)
+          throw mtx::mm_io::end_of_file_x();
       }
 
-      n -= b;
+      return m_cache >> (64 - n);
     }
 
-    return r;
+    auto byte_position = m_byte_position;
+    auto cache         = m_cache;
+    auto cache_bits    = m_cache_bits;
+    auto out_of_data   = m_out_of_data;
+
+    auto restore = [&]() {
+      m_byte_position = byte_position;
+      m_cache         = cache;
+      m_cache_bits    = cache_bits;
+      m_out_of_data   = out_of_data;
+    };
+
+    try {
+      auto value = get_bits(n);
+      restore();
+      return value;
+
+    } catch (mtx::mm_io::end_of_file_x &) {
+      restore();
+      throw;
+    }
   }
 
   void get_bytes(unsigned char *buf, std::size_t n) {
-    if (8 == m_bits_valid) {
-      get_bytes_byte_aligned(buf, n);
+    if (m_cache_bits % 8) {
+      for (auto idx = 0u; idx < n; ++idx)
+        buf[idx] = get_bits(8);
       return;
     }
 
-    for (auto idx = 0u; idx < n; ++idx)
-      buf[idx] = get_bits(8);
+    // Byte aligned: hand out what's left in the cache, then copy the
+    // rest directly.
+    auto idx = 0u;
+    for (; (idx < n) && m_cache_bits; ++idx)
+      buf[idx] = consume(8);
+
+    if (idx < n)
+      get_bytes_byte_aligned(buf + idx, n - idx);
   }
 
   void byte_align() {
-    if (8 != m_bits_valid)
-      skip_bits(m_bits_valid);
+    auto to_skip = m_cache_bits % 8;
+    if (to_skip)
+      consume(to_skip);
   }
 
   void set_bit_position(std::size_t pos) {
+    m_cache      = 0;
+    m_cache_bits = 0;
+
     if (pos > (static_cast<std::size_t>(m_end_of_data - m_start_of_data) * 8)) {
       m_byte_position = m_end_of_data;
       m_out_of_data   = true;
@@ -168,23 +204,33 @@ public:
     }
 
     m_byte_position = m_start_of_data + (pos / 8);
-    m_bits_valid    = 8 - (pos % 8);
+
+    if (pos % 8) {
+      refill();
+      consume(pos % 8);
+    }
   }
 
   int get_bit_position() const {
-    return (m_byte_position - m_start_of_data) * 8 + 8 - m_bits_valid;
+    return (m_byte_position - m_start_of_data) * 8 - static_cast<int>(m_cache_bits);
   }
 
   int get_remaining_bits() const {
-    return (m_end_of_data - m_byte_position) * 8 - 8 + m_bits_valid;
+    return (m_end_of_data - m_byte_position) * 8 + static_cast<int>(m_cache_bits);
   }
 
   void skip_bits(std::size_t num) {
-    set_bit_position(get_bit_position() + num);
+    if (!num)
+      return;
+
+    if (num < m_cache_bits)
+      consume(num);
+    else
+      set_bit_position(get_bit_position() + num);
   }
 
   void skip_bit() {
-    set_bit_position(get_bit_position() + 1);
+    skip_bits(1);
   }
 
   uint64_t skip_get_bits(std::size_t to_skip,
@@ -194,11 +240,61 @@ public:
   }
 
 protected:
+  // Loads as many whole bytes as fit into the cache. Afterwards at
+  // least s_max_bits_per_refill bits are valid unless the end of the
+  // data has been reached. Must only be called if the cache isn't
+  // full.
+  void refill() {
+    if ((m_end_of_data - m_byte_position) >= 8) {
+      auto word = (static_cast<uint64_t>(m_byte_position[0]) << 56)
+                | (static_cast<uint64_t>(m_byte_position[1]) << 48)
+                | (static_cast<uint64_t>(m_byte_position[2]) << 40)
+                | (static_cast<uint64_t>(m_byte_position[3]) << 32)
+                | (static_cast<uint64_t>(m_byte_position[4]) << 24)
+                | (static_cast<uint64_t>(m_byte_position[5]) << 16)
+                | (static_cast<uint64_t>(m_byte_position[6]) <<  8)
+                |  static_cast<uint64_t>(m_byte_position[7]);
+      auto num_bytes   = (63 - m_cache_bits) / 8;
+
+      m_cache         |= word >> m_cache_bits;
+      m_byte_position += num_bytes;
+      m_cache_bits    += num_bytes * 8;
+
+      return;
+    }
+
+    while ((m_cache_bits <= 56) && (m_byte_position < m_end_of_data)) {
+      m_cache      |= static_cast<uint64_t>(*m_byte_position) << (56 - m_cache_bits);
+      m_cache_bits += 8;
+      ++m_byte_position;
+    }
+  }
+
+  // Removes n bits from the cache and returns them. n must be
+  // between 1 and 63 and not exceed the number of valid bits.
+  uint64_t consume(std::size_t n) {
+    auto value     = m_cache >> (64 - n);
+    m_cache      <<= n;
+    m_cache_bits  -= n;
+
+    return value;
+  }
+
+  void throw_end_of_data() {
+    m_byte_position = m_end_of_data;
+    m_cache         = 0;
+    m_cache_bits    = 0;
+    m_out_of_data   = true;
+
+    throw mtx::mm_io::end_of_file_x();
+  }
+
   void get_bytes_byte_aligned(unsigned char *buf, std::size_t n) {
     auto bytes_to_copy = std::min<std::size_t>(n, m_end_of_data - m_byte_position);
     std::memcpy(buf, m_byte_position, bytes_to_copy);
 
     m_byte_position += bytes_to_copy;
+    m_cache          = 0;
 
     if (bytes_to_copy < n) {
       m_out_of_data = true;
@@ -18,10 +18,31 @@
 
 #include "common/bswap.h"
 #include "common/checksums/crc.h"
+#include "common/cpu_features.h"
 #include "common/endian.h"
 
+#if defined(MTX_HAVE_X86_SIMD)
+# include <emmintrin.h>
+# include <wmmintrin.h>
+#endif
+
 namespace mtx { namespace checksum {
 
+namespace {
+
+// Compilers turn this into a single load on little-endian
+// architectures, which get_uint32_le() doesn't allow due to not being
+// inline.
+inline uint32_t
+load_uint32_le(unsigned char const *buffer) {
+  return  static_cast<uint32_t>(buffer[0])
+       | (static_cast<uint32_t>(buffer[1]) <<  8)
+       | (static_cast<uint32_t>(buffer[2]) << 16)
+       | (static_cast<uint32_t>(buffer[3]) << 24);
+}
+
+}
+
 crc_base_c::table_parameters_t const crc_base_c::ms_table_parameters[5] = {
   { 0,  8,       0x07 },
   { 0, 16,     0x8005 },
@@ -31,52 +52,74 @@ crc_base_c::table_parameters_t const crc_base_c::ms_table_parameters[5] = {
 };
 
 crc_base_c::crc_base_c(type_e type,
-                       table_t &table,
                        uint32_t crc)
   : m_type{type}
-  , m_table(table)              // No initializer-list syntax here due to gcc bug 50025.
+  , m_table(table_for(type))    // No initializer-list syntax here due to gcc bug 50025.
   , m_crc{crc}
   , m_xor_result{}
   , m_result_in_le{}
+  , m_implementation{}
 {
-  if (m_table.empty())
-    init_table();
+  set_implementation(implementation_e::automatic);
 }
 
 crc_base_c::~crc_base_c() {
 }
 
+crc_base_c::table_t const &
+crc_base_c::table_for(type_e type) {
+  // Function-local statics are initialized in a thread-safe manner.
+  static std::vector<table_t> const s_tables{
+    create_table(crc_8_atm),
+    create_table(crc_16_ansi),
+    create_table(crc_16_ccitt),
+    create_table(crc_32_ieee),
+    create_table(crc_32_ieee_le),
+  };
+
+  return s_tables[type];
+}
+
 #ifdef COMP_MSC
 #pragma warning(disable:4146)	//unary minus operator applied to unsigned type, result still unsigned
 #endif
 
-void
-crc_base_c::init_table() {
-  auto &parameters = ms_table_parameters[m_type];
+crc_base_c::table_t
+crc_base_c::create_table(type_e type) {
+  auto &parameters = ms_table_parameters[type];
 
   if ((parameters.bits < 8) || (parameters.bits > 32) || (parameters.poly >= (1LL<<parameters.bits)))
     throw std::domain_error{"Invalid CRC parameters"};
 
-  m_table.resize(256);
+  auto table = table_t(16 * 256);
 
   for (auto i = 0u; i < 256u; i++) {
     if (parameters.le) {
       uint32_t c = i;
       for (auto j = 0u; j < 8u; j++)
         c = (c >> 1) ^ (parameters.poly & (-(c & 1)));
-      m_table[i] = c;
+      table[i] = c;
 
     } else {
       uint32_t c = i << 24;
       for (auto j = 0u; j < 8u; j++)
         c = (c << 1) ^ ((parameters.poly << (32 - parameters.bits)) & (static_cast<int32_t>(c) >> 31));
-      m_table[i] = mtx::bswap_32(c);
+      table[i] = mtx::bswap_32(c);
     }
   }
 
+  // Sub-table n contains the CRC of byte i followed by n zero bytes.
+  for (auto i = 0u; i < 256u; i++)
+    for (auto n = 1u; n < 16u; n++) {
+      auto previous      = table[(n - 1) * 256 + i];
+      table[n * 256 + i] = (previous >> 8) ^ table[previous & 0xff];
+    }
+
   // for (auto row = 0u; row < (256u / 4); ++row)
   //   mxinfo(boost::format("0x%|1$08x| 0x%|2$08x| 0x%|3$08x| 0x%|4$08x|\n")
-  //          % m_table[row * 4 + 0] % m_table[row * 4 + 1] % m_table[row * 4 + 2] % m_table[row * 4 + 3]);
+  //          % table[row * 4 + 0] % table[row * 4 + 1] % table[row * 4 + 2] % table[row * 4 + 3]);
+
+  return table;
 }
 
 memory_cptr
@@ -124,9 +167,64 @@ crc_base_c::set_result_in_le(bool result_in_le) {
   m_result_in_le = result_in_le;
 }
 
+bool
+crc_base_c::is_implementation_supported(implementation_e implementation)
+  const {
+  if (implementation != implementation_e::pclmulqdq)
+    return true;
+
+#if defined(MTX_HAVE_X86_SIMD)
+  return (crc_32_ieee_le == m_type) && mtx::cpu::has(mtx::cpu::feature_e::sse2) && mtx::cpu::has(mtx::cpu::feature_e::pclmulqdq);
+#else
+  return false;
+#endif
+}
+
+void
+crc_base_c::set_implementation(implementation_e implementation) {
+  if (implementation == implementation_e::automatic)
+    implementation = is_implementation_supported(implementation_e::pclmulqdq) ? implementation_e::pclmulqdq : implementation_e::slice_by_16;
+
+  if (!is_implementation_supported(implementation))
+    throw std::domain_error{"CRC implementation not supported for this CRC type or CPU"};
+
+  m_implementation = implementation;
+}
+
+crc_base_c::implementation_e
+crc_base_c::get_implementation()
+  const {
+  return m_implementation;
+}
+
+std::string
+crc_base_c::implementation_name(implementation_e implementation) {
+  return implementation == implementation_e::byte_wise   ? "byte-wise"
+       : implementation == implementation_e::slice_by_8  ? "slice-by-8"
+       : implementation == implementation_e::slice_by_16 ? "slice-by-16"
+       : implementation == implementation_e::pclmulqdq   ? "PCLMULQDQ"
+       :                                                   "automatic";
+}
+
 void
 crc_base_c::add_impl(unsigned char const *buffer,
                      size_t size) {
+  if (implementation_e::pclmulqdq == m_implementation)
+    add_pclmulqdq(buffer, size);
+
+  else if (implementation_e::slice_by_16 == m_implementation)
+    add_slice_by_16(buffer, size);
+
+  else if (implementation_e::slice_by_8 == m_implementation)
+    add_slice_by_8(buffer, size);
+
+  else
+    add_byte_wise(buffer, size);
+}
+
+void
+crc_base_c::add_byte_wise(unsigned char const *buffer,
+                          size_t size) {
   auto end = buffer + size;
 
   while (buffer < end) {
@@ -135,12 +233,174 @@ crc_base_c::add_impl(unsigned char const *buffer,
   }
 }
 
-// ----------------------------------------------------------------------
+void
+crc_base_c::add_slice_by_8(unsigned char const *buffer,
+                           size_t size) {
+  auto t   = m_table.data();
+  auto crc = m_crc;
+
+  for (; size >= 8; buffer += 8, size -= 8) {
+    auto one = load_uint32_le(&buffer[0]) ^ crc;
+    auto two = load_uint32_le(&buffer[4]);
+
+    crc = t[7 * 256 + ( one        & 0xff)] ^ t[6 * 256 + ((one >>  8) & 0xff)]
+        ^ t[5 * 256 + ((one >> 16) & 0xff)] ^ t[4 * 256 + ( one >> 24        )]
+        ^ t[3 * 256 + ( two        & 0xff)] ^ t[2 * 256 + ((two >>  8) & 0xff)]
+        ^ t[1 * 256 + ((two >> 16) & 0xff)] ^ t[0 * 256 + ( two >> 24        )];
+  }
+
+  m_crc = crc;
 
-crc_base_c::table_t crc8_atm_c::ms_table;
+  add_byte_wise(buffer, size);
+}
+
+void
+crc_base_c::add_slice_by_16(unsigned char const *buffer,
+                            size_t size) {
+  auto t   = m_table.data();
+  auto crc = m_crc;
+
+  for (; size >= 16; buffer += 16, size -= 16) {
+    auto one   = load_uint32_le(&buffer[ 0]) ^ crc;
+    auto two   = load_uint32_le(&buffer[ 4]);
+    auto three = load_uint32_le(&buffer[ 8]);
+    auto four  = load_uint32_le(&buffer[12]);
+
+    crc = t[15 * 256 + ( one          & 0xff)] ^ t[14 * 256 + ((one   >>  8) & 0xff)]
+        ^ t[13 * 256 + ((one   >> 16) & 0xff)] ^ t[12 * 256 + ( one   >> 24        )]
+        ^ t[11 * 256 + ( two          & 0xff)] ^ t[10 * 256 + ((two   >>  8) & 0xff)]
+        ^ t[ 9 * 256 + ((two   >> 16) & 0xff)] ^ t[ 8 * 256 + ( two   >> 24        )]
+        ^ t[ 7 * 256 + ( three        & 0xff)] ^ t[ 6 * 256 + ((three >>  8) & 0xff)]
+        ^ t[ 5 * 256 + ((three >> 16) & 0xff)] ^ t[ 4 * 256 + ( three >> 24        )]
+        ^ t[ 3 * 256 + ( four         & 0xff)] ^ t[ 2 * 256 + ((four  >>  8) & 0xff)]
+        ^ t[ 1 * 256 + ((four  >> 16) & 0xff)] ^ t[ 0 * 256 + ( four  >> 24        )];
+  }
+
+  m_crc = crc;
+
+  add_byte_wise(buffer, size);
+}
+
+#if defined(MTX_HAVE_X86_SIMD)
+
+namespace {
+
+MTX_TARGET_X86("sse2")
+inline __m128i
+load_unaligned(unsigned char const *buffer) {
+  return _mm_loadu_si128(reinterpret_cast<__m128i const *>(buffer));
+}
+
+MTX_TARGET_X86("sse2,pclmul")
+inline __m128i
+fold_128(__m128i lane,
+         __m128i next,
+         __m128i constants) {
+  auto low = _mm_clmulepi64_si128(lane, constants, 0x00);
+  return _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(lane, constants, 0x11), next), low);
+}
+
+// Folding with carry-less multiplication as described in Intel's
+// paper "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ
+// Instruction". The constants are only valid for the bit-reflected
+// CRC-32 polynomial 0xedb88320. Requires size >= 64 and size being a
+// multiple of 16.
+MTX_TARGET_X86("sse2,pclmul")
+uint32_t
+crc32_ieee_le_pclmulqdq(unsigned char const *buffer,
+                        size_t size,
+                        uint32_t crc) {
+  alignas(16) static uint64_t const s_k1k2[] = { 0x0154442bd4, 0x01c6e41596 };
+  alignas(16) static uint64_t const s_k3k4[] = { 0x01751997d0, 0x00ccaa009e };
+  alignas(16) static uint64_t const s_k5k0[] = { 0x0163cd6124, 0x0000000000 };
+  alignas(16) static uint64_t const s_poly[] = { 0x01db710641, 0x01f7011641 };
+
+  auto x1 = _mm_xor_si128(load_unaligned(buffer), _mm_cvtsi32_si128(crc));
+  auto x2 = load_unaligned(buffer + 0x10);
+  auto x3 = load_unaligned(buffer + 0x20);
+  auto x4 = load_unaligned(buffer + 0x30);
+  auto x0 = _mm_load_si128(reinterpret_cast<__m128i const *>(s_k1k2));
+
+  buffer += 64;
+  size   -= 64;
+
+  // Fold four 128-bit lanes in parallel.
+  for (; size >= 64; buffer += 64, size -= 64) {
+    auto x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    auto x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    auto x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+    auto x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+    x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+    x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), load_unaligned(buffer + 0x00));
+    x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), load_unaligned(buffer + 0x10));
+    x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), load_unaligned(buffer + 0x20));
+    x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), load_unaligned(buffer + 0x30));
+  }
+
+  // Fold the four lanes into a single one.
+  x0 = _mm_load_si128(reinterpret_cast<__m128i const *>(s_k3k4));
+
+  x1 = fold_128(x1, x2, x0);
+  x1 = fold_128(x1, x3, x0);
+  x1 = fold_128(x1, x4, x0);
+
+  for (; size >= 16; buffer += 16, size -= 16)
+    x1 = fold_128(x1, load_unaligned(buffer), x0);
+
+  // Fold 128 bits to 64 bits.
+  auto mask = _mm_setr_epi32(~0, 0, ~0, 0);
+
+  x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+  x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+
+  x0 = _mm_loadl_epi64(reinterpret_cast<__m128i const *>(s_k5k0));
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask), x0, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  // Barrett reduction to 32 bits.
+  x0 = _mm_load_si128(reinterpret_cast<__m128i const *>(s_poly));
+  x2 = _mm_clmulepi64_si128(_mm_and_si128(x1, mask), x0, 0x10);
+  x2 = _mm_clmulepi64_si128(_mm_and_si128(x2, mask), x0, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  return _mm_cvtsi128_si32(_mm_srli_si128(x1, 4));
+}
+
+}
+
+void
+crc_base_c::add_pclmulqdq(unsigned char const *buffer,
+                          size_t size) {
+  if (size >= 64) {
+    auto to_fold = size & ~static_cast<size_t>(15);
+    m_crc        = crc32_ieee_le_pclmulqdq(buffer, to_fold, m_crc);
+    buffer      += to_fold;
+    size        -= to_fold;
+  }
+
+  add_slice_by_16(buffer, size);
+}
+
+#else  // MTX_HAVE_X86_SIMD
+
+void
+crc_base_c::add_pclmulqdq(unsigned char const *buffer,
+                          size_t size) {
+  add_slice_by_16(buffer, size);
+}
+
+#endif  // MTX_HAVE_X86_SIMD
+
+// ----------------------------------------------------------------------
 
 crc8_atm_c::crc8_atm_c(uint32_t initial_value)
-  : crc_base_c{crc_8_atm, ms_table, initial_value}
+  : crc_base_c{crc_8_atm, initial_value}
 {
 }
 
@@ -149,10 +409,8 @@ crc8_atm_c::~crc8_atm_c() {
 
 // ----------------------------------------------------------------------
 
-crc_base_c::table_t crc16_ansi_c::ms_table;
-
 crc16_ansi_c::crc16_ansi_c(uint32_t initial_value)
-  : crc_base_c{crc_16_ansi, ms_table, initial_value}
+  : crc_base_c{crc_16_ansi, initial_value}
 {
 }
 
@@ -161,10 +419,8 @@ crc16_ansi_c::~crc16_ansi_c() {
 
 // ----------------------------------------------------------------------
 
-crc_base_c::table_t crc16_ccitt_c::ms_table;
-
 crc16_ccitt_c::crc16_ccitt_c(uint32_t initial_value)
-  : crc_base_c{crc_16_ccitt, ms_table, initial_value}
+  : crc_base_c{crc_16_ccitt, initial_value}
 {
 }
 
@@ -173,10 +429,8 @@ crc16_ccitt_c::~crc16_ccitt_c() {
 
 // ----------------------------------------------------------------------
 
-crc_base_c::table_t crc32_ieee_c::ms_table;
-
 crc32_ieee_c::crc32_ieee_c(uint32_t initial_value)
-  : crc_base_c{crc_32_ieee, ms_table, initial_value}
+  : crc_base_c{crc_32_ieee, initial_value}
 {
 }
 
@@ -185,10 +439,8 @@ crc32_ieee_c::~crc32_ieee_c() {
 
 // ----------------------------------------------------------------------
 
-crc_base_c::table_t crc32_ieee_le_c::ms_table;
-
 crc32_ieee_le_c::crc32_ieee_le_c(uint32_t initial_value)
-  : crc_base_c{crc_32_ieee_le, ms_table, initial_value}
+  : crc_base_c{crc_32_ieee_le, initial_value}
 {
 }
 
@@ -21,6 +21,15 @@
 namespace mtx { namespace checksum {
 
 class crc_base_c: public base_c, public uint_result_c, public set_initial_value_c {
+public:
+  enum class implementation_e {
+    automatic,
+    byte_wise,
+    slice_by_8,
+    slice_by_16,
+    pclmulqdq,
+  };
+
 protected:
   enum type_e {
     crc_8_atm      = 0,
@@ -30,6 +39,9 @@ protected:
     crc_32_ieee_le = 4,
   };
 
+  // Sixteen sub-tables of 256 entries each: the first one is the
+  // classic byte-wise table, the remaining ones are used for
+  // processing eight or sixteen bytes per iteration.
   using table_t = std::vector<uint32_t>;
 
   struct table_parameters_t {
@@ -42,15 +54,14 @@ protected:
 
 protected:
   type_e m_type;
-  table_t &m_table;
+  table_t const &m_table;
   uint32_t m_crc;
   uint64_t m_xor_result;
   bool m_result_in_le;
+  implementation_e m_implementation;
 
 protected:
-  crc_base_c(type_e type, table_t &table, uint32_t crc);
-
-  void init_table();
+  crc_base_c(type_e type, uint32_t crc);
 
 public:
   virtual ~crc_base_c();
@@ -61,53 +72,53 @@ public:
   virtual void set_xor_result(uint64_t xor_result);
   virtual void set_result_in_le(bool result_in_le);
 
+  virtual void set_implementation(implementation_e implementation);
+  virtual implementation_e get_implementation() const;
+  virtual bool is_implementation_supported(implementation_e implementation) const;
+
 protected:
   virtual void add_impl(unsigned char const *buffer, size_t size);
 
+  void add_byte_wise(unsigned char const *buffer, size_t size);
+  void add_slice_by_8(unsigned char const *buffer, size_t size);
+  void add_slice_by_16(unsigned char const *buffer, size_t size);
+  void add_pclmulqdq(unsigned char const *buffer, size_t size);
+
   virtual void set_initial_value_impl(uint64_t initial_value) ;
   virtual void set_initial_value_impl(unsigned char const *buffer, size_t size);
+
+  static table_t const &table_for(type_e type);
+  static table_t create_table(type_e type);
+
+public:
+  static std::string implementation_name(implementation_e implementation);
 };
 
 class crc8_atm_c: public crc_base_c {
-protected:
-  static table_t ms_table;
-
 public:
   crc8_atm_c(uint32_t initial_value = 0);
   virtual ~crc8_atm_c();
 };
 
 class crc16_ansi_c: public crc_base_c {
-protected:
-  static table_t ms_table;
-
 public:
   crc16_ansi_c(uint32_t initial_value = 0);
   virtual ~crc16_ansi_c();
 };
 
 class crc16_ccitt_c: public crc_base_c {
-protected:
-  static table_t ms_table;
-
 public:
   crc16_ccitt_c(uint32_t initial_value = 0);
   virtual ~crc16_ccitt_c();
 };
 
 class crc32_ieee_c: public crc_base_c {
-protected:
-  static table_t ms_table;
-
 public:
   crc32_ieee_c(uint32_t initial_value = 0);
   virtual ~crc32_ieee_c();
 };
 
 class crc32_ieee_le_c: public crc_base_c {
-protected:
-  static table_t ms_table;
-
 public:
   crc32_ieee_le_c(uint32_t initial_value = 0);
   virtual ~crc32_ieee_le_c();
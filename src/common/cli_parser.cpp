@@ -88,7 +88,7 @@ cli_parser_c::cli_parser_c(std::vector<std::string> const &args)
 void
 cli_parser_c::parse_args() {
   set_usage();
-  while (!m_no_common_cli_args && handle_common_cli_args(m_args, ""))
+  while (!m_no_common_cli_args && handle_common_cli_args(m_args, "", &m_common_args))
     set_usage();
 
   run_hooks(cli_parser_c::ht_common_options_parsed);
@@ -51,7 +51,7 @@ protected:
 
   std::map<std::string, option_t> m_option_map;
   std::vector<option_t> m_options;
-  std::vector<std::string> m_args;
+  std::vector<std::string> m_args, m_common_args;
 
   std::string m_current_arg, m_next_arg;
 
@@ -231,12 +231,22 @@ std::string usage_text, version_info;
    \param redirect_output_short The name of the short option that is
      recognized for --redirect-output. If left empty then no short
      version is accepted.
+   \param handled_args If given then the handled arguments are appended
+     to it in the order in which they're handled, each option followed
+     by its argument.
    \returns \c true if the locale has changed and the function should be
      called again and \c false otherwise.
 */
 bool
 handle_common_cli_args(std::vector<std::string> &args,
-                       const std::string &redirect_output_short) {
+                       const std::string &redirect_output_short,
+                       std::vector<std::string> *handled_args) {
+  auto consume = [&args, handled_args](size_t idx, size_t num_args) {
+    if (handled_args)
+      handled_args->insert(handled_args->end(), args.begin() + idx, args.begin() + idx + num_args);
+    args.erase(args.begin() + idx, args.begin() + idx + num_args);
+  };
+
   size_t i = 0;
 
   while (args.size() > i) {
@@ -245,18 +255,18 @@ handle_common_cli_args(std::vector<std::string> &args,
         mxerror("Missing argument for '--debug'.\n");
 
       debugging_c::request(args[i + 1]);
-      args.erase(args.begin() + i, args.begin() + i + 2);
+      consume(i, 2);
 
     } else if (args[i] == "--engage") {
       if ((i + 1) == args.size())
         mxerror(Y("'--engage' lacks its argument.\n"));
 
       engage_hacks(args[i + 1]);
-      args.erase(args.begin() + i, args.begin() + i + 2);
+      consume(i, 2);
 
     } else if (args[i] == "--gui-mode") {
       g_gui_mode = true;
-      args.erase(args.begin() + i, args.begin() + i + 1);
+      consume(i, 1);
 
     } else
       ++i;
@@ -269,7 +279,7 @@ handle_common_cli_args(std::vector<std::string> &args,
       if ((i + 1) == args.size())
         mxerror(Y("Missing argument for '--output-charset'.\n"));
       set_cc_stdio(args[i + 1]);
-      args.erase(args.begin() + i, args.begin() + i + 2);
+      consume(i, 2);
     } else
       ++i;
   }
@@ -288,7 +298,7 @@ handle_common_cli_args(std::vector<std::string> &args,
           file->write_bom(g_stdio_charset);
           redirect_stdio(file);
         }
-        args.erase(args.begin() + i, args.begin() + i + 2);
+        consume(i, 2);
       } catch(mtx::mm_io::exception &) {
         mxerror(boost::format(Y("Could not open the file '%1%' for directing the output.\n")) % args[i + 1]);
       }
@@ -318,7 +328,7 @@ handle_common_cli_args(std::vector<std::string> &args,
 
       init_locales(args[i + 1]);
 
-      args.erase(args.begin() + i, args.begin() + i + 2);
+      consume(i, 2);
 
       return true;
     } else
@@ -334,12 +344,12 @@ handle_common_cli_args(std::vector<std::string> &args,
 
     } else if ((args[i] == "-v") || (args[i] == "--verbose")) {
       ++verbose;
-      args.erase(args.begin() + i, args.begin() + i + 1);
+      consume(i, 1);
 
     } else if ((args[i] == "-q") || (args[i] == "--quiet")) {
       verbose         = 0;
       g_suppress_info = true;
-      args.erase(args.begin() + i, args.begin() + i + 1);
+      consume(i, 1);
 
     } else if ((args[i] == "-h") || (args[i] == "-?") || (args[i] == "--help"))
       usage();
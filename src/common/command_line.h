@@ -20,6 +20,6 @@ extern std::string usage_text, version_info;
 extern bool g_gui_mode;
 
 void usage(int exit_code = 0);
-bool handle_common_cli_args(std::vector<std::string> &args, const std::string &redirect_output_short);
+bool handle_common_cli_args(std::vector<std::string> &args, const std::string &redirect_output_short, std::vector<std::string> *handled_args = nullptr);
 
 #endif  // MTX_COMMON_COMMAND_LINE_H
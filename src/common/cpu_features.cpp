@@ -0,0 +1,60 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   run-time detection of CPU features
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "common/cpu_features.h"
+
+#if defined(MTX_HAVE_X86_SIMD)
+# include <cpuid.h>
+#endif
+
+namespace mtx { namespace cpu {
+
+namespace {
+
+unsigned int
+detect() {
+  auto features = 0u;
+
+#if defined(MTX_HAVE_X86_SIMD)
+  unsigned int eax{}, ebx{}, ecx{}, edx{};
+
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    return features;
+
+  auto add = [&features](feature_e feature, bool present) {
+    if (present)
+      features |= 1u << static_cast<unsigned int>(feature);
+  };
+
+  add(feature_e::sse2,      edx & (1u << 26));
+  add(feature_e::ssse3,     ecx & (1u <<  9));
+  add(feature_e::sse4_1,    ecx & (1u << 19));
+  add(feature_e::sse4_2,    ecx & (1u << 20));
+  add(feature_e::pclmulqdq, ecx & (1u <<  1));
+#endif
+
+  return features;
+}
+
+}
+
+bool
+has(feature_e feature) {
+  static auto s_features = detect();
+
+  return !!(s_features & (1u << static_cast<unsigned int>(feature)));
+}
+
+}}
@@ -0,0 +1,42 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   run-time detection of CPU features
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_CPU_FEATURES_H
+#define MTX_COMMON_CPU_FEATURES_H
+
+#include "common/common_pch.h"
+
+// Functions using instruction set extensions that aren't enabled for
+// the whole build are marked with MTX_TARGET_X86(…) and may only be
+// called after checking mtx::cpu::has() for the corresponding
+// features.
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+# define MTX_HAVE_X86_SIMD 1
+# define MTX_TARGET_X86(features) __attribute__((target(features)))
+#endif
+
+namespace mtx { namespace cpu {
+
+enum class feature_e {
+  sse2,
+  ssse3,
+  sse4_1,
+  sse4_2,
+  pclmulqdq,
+};
+
+bool has(feature_e feature);
+
+}}
+
+#endif  // MTX_COMMON_CPU_FEATURES_H
@@ -16,10 +16,14 @@
 
 #include "common/common_pch.h"
 
+#include <atomic>
+#include <deque>
+#include <mutex>
 #include <sstream>
 #include <unordered_map>
 
 #include "common/memory.h"
+#include "common/strings/fast_format.h"
 
 class debugging_c {
 protected:
@@ -33,6 +37,14 @@ public:
     output(msg.str());
   }
 
+  static void output(char const *file, unsigned int line, std::string const &msg);
+  static void output(char const *file, unsigned int line, boost::format const &msg) {
+    output(file, line, msg.str());
+  }
+  static void output(char const *file, unsigned int line, fast_format_c const &msg) {
+    output(file, line, msg.str());
+  }
+
   static void hexdump(const void *buffer_to_dump, size_t lenth);
   static void hexdump(memory_c const &buffer_to_dump, boost::optional<std::size_t> max_length = boost::none);
   static void hexdump(memory_cptr const &buffer_to_dump, boost::optional<std::size_t> max_length = boost::none);
@@ -45,61 +57,93 @@ public:
   static void init();
 };
 
+// Debugging options are evaluated lazily and cached. Both registering
+// an option and evaluating it may happen from several threads at
+// once, e.g. from parsers running concurrently. Requesting options via
+// debugging_c::request() must not happen concurrently with that.
 class debugging_option_c {
   struct option_c {
-    boost::tribool m_requested;
+    static int const s_unknown = -1;
+
+    std::atomic<int> m_requested;
     std::string m_option;
 
     option_c(std::string const &option)
-      : m_requested{boost::logic::indeterminate}
+      : m_requested{s_unknown}
       , m_option{option}
     {
     }
 
     bool get() {
-      if (boost::logic::indeterminate(m_requested))
-        m_requested = debugging_c::requested(m_option);
+      auto requested = m_requested.load();
 
-      return m_requested;
+      // Evaluating the option concurrently yields the same result in
+      // each thread; storing it more than once doesn't hurt.
+      if (s_unknown == requested) {
+        requested = debugging_c::requested(m_option) ? 1 : 0;
+        m_requested.store(requested);
+      }
+
+      return !!requested;
     }
   };
 
 protected:
-  mutable size_t m_registered_idx;
+  mutable std::atomic<option_c *> m_registered_option;
   std::string m_option;
 
 private:
-  static std::vector<option_c> ms_registered_options;
+  // A deque so that references to registered options stay valid when
+  // other options are registered later on, possibly from other threads.
+  static std::deque<option_c> ms_registered_options;
+  static std::mutex ms_mutex;
 
 public:
   debugging_option_c(std::string const &option)
-    : m_registered_idx{std::numeric_limits<size_t>::max()}
+    : m_registered_option{}
     , m_option{option}
   {
   }
 
+  debugging_option_c(debugging_option_c const &other)
+    : m_registered_option{other.m_registered_option.load()}
+    , m_option{other.m_option}
+  {
+  }
+
+  debugging_option_c &operator =(debugging_option_c const &other) {
+    m_registered_option.store(other.m_registered_option.load());
+    m_option = other.m_option;
+    return *this;
+  }
+
   operator bool() const {
-    return ms_registered_options.at(get_idx()).get();
+    return get_option().get();
   }
 
   void set(boost::tribool requested) {
-    ms_registered_options.at(get_idx()).m_requested = requested;
+    get_option().m_requested.store(boost::logic::indeterminate(requested) ? option_c::s_unknown : requested ? 1 : 0);
   }
 
 protected:
-  std::size_t get_idx() const {
-    if (m_registered_idx == std::numeric_limits<size_t>::max())
-      m_registered_idx = register_option(m_option);
+  option_c &get_option() const {
+    auto option = m_registered_option.load();
 
-    return m_registered_idx;
+    if (!option) {
+      option = &register_option(m_option);
+      m_registered_option.store(option);
+    }
+
+    return *option;
   }
 
+  static option_c &register_option(std::string const &option);
+
 public:
-  static size_t register_option(std::string const &option);
   static void invalidate_cache();
 };
 
-#define mxdebug(msg) debugging_c::output((boost::format("Debug> %1%:%|2$04d|: %3%") % __FILE__ % __LINE__ % (msg)).str())
+#define mxdebug(msg) debugging_c::output(__FILE__, __LINE__, (msg))
 
 #define mxdebug_if(condition, msg) \
   if (condition) {                 \
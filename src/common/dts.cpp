@@ -23,6 +23,7 @@
 #include "common/endian.h"
 #include "common/list_utils.h"
 #include "common/math.h"
+#include "common/sync_word_searcher.h"
 
 // ---------------------------------------------------------------------------
 
@@ -93,20 +94,15 @@ find_sync_word(unsigned char const *buf,
     // not enough data for one header
     return -1;
 
-  unsigned int offset = 0;
-  auto sync_word      = static_cast<sync_word_e>(get_uint32_be(buf));
-  auto sync_word_ok   = false;
-
-  while ((offset + 4) < size) {
-    sync_word_ok = (sync_word_e::core == sync_word) || (sync_word_e::exss == sync_word);
-    if (sync_word_ok)
-      break;
+  static auto const s_searcher = mtx::sync_word_searcher_c{
+    { static_cast<uint32_t>(sync_word_e::core), 0xffffffff, 4 },
+    { static_cast<uint32_t>(sync_word_e::exss), 0xffffffff, 4 },
+  };
 
-    sync_word = static_cast<sync_word_e>((static_cast<uint32_t>(sync_word) << 8) | buf[offset + 4]);
-    ++offset;
-  }
+  // A header ending right at the end of the buffer isn't reported.
+  auto offset = s_searcher.find(buf, size, 0, size - 4);
 
-  return sync_word_ok ? offset : -1;
+  return std::string::npos != offset ? static_cast<int>(offset) : -1;
 }
 
 static int
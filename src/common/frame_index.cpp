@@ -0,0 +1,209 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   compact storage for the frame index of a track
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "common/frame_index.h"
+
+namespace {
+
+// Wrapping arithmetic so that arbitrary values survive the encoding.
+int64_t
+wrapping_add(int64_t a,
+             int64_t b) {
+  return static_cast<int64_t>(static_cast<uint64_t>(a) + static_cast<uint64_t>(b));
+}
+
+int64_t
+wrapping_sub(int64_t a,
+             int64_t b) {
+  return static_cast<int64_t>(static_cast<uint64_t>(a) - static_cast<uint64_t>(b));
+}
+
+void
+put_difference(std::vector<unsigned char> &data,
+               int64_t actual,
+               int64_t predicted) {
+  auto difference = wrapping_sub(actual, predicted);
+  auto value      = (static_cast<uint64_t>(difference) << 1) ^ static_cast<uint64_t>(difference >> 63);
+
+  while (value >= 0x80) {
+    data.push_back((value & 0x7f) | 0x80);
+    value >>= 7;
+  }
+
+  data.push_back(value);
+}
+
+int64_t
+get_with_difference(unsigned char const *&data,
+                    int64_t predicted) {
+  auto value = uint64_t{};
+  auto shift = 0u;
+
+  while (*data & 0x80) {
+    value |= static_cast<uint64_t>(*data++ & 0x7f) << shift;
+    shift += 7;
+  }
+
+  value |= static_cast<uint64_t>(*data++) << shift;
+
+  return wrapping_add(predicted, static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1)));
+}
+
+}
+
+namespace mtx {
+
+std::size_t const frame_index_c::s_block_size;
+
+frame_index_c::entry_t
+frame_index_c::block_start_entry(block_t const &block) {
+  return { block.file_pos, 0, block.timecode, 0, false };
+}
+
+void
+frame_index_c::push_back(entry_t const &entry) {
+  auto idx_in_block = m_size % s_block_size;
+
+  if (!idx_in_block) {
+    m_blocks.emplace_back();
+    m_blocks.back().file_pos   = entry.file_pos;
+    m_blocks.back().timecode   = entry.timecode;
+    m_blocks.back().data_start = m_data.size();
+    m_last_entry               = block_start_entry(m_blocks.back());
+  }
+
+  put_difference(m_data, entry.size,     m_last_entry.size);
+  put_difference(m_data, entry.file_pos, wrapping_add(m_last_entry.file_pos, m_last_entry.size));
+  put_difference(m_data, entry.duration, m_last_entry.duration);
+  put_difference(m_data, entry.timecode, wrapping_add(m_last_entry.timecode, m_last_entry.duration));
+
+  if (entry.is_keyframe)
+    m_blocks.back().keyframes |= 1ull << idx_in_block;
+
+  m_last_entry = entry;
+  ++m_size;
+}
+
+frame_index_c::entry_t
+frame_index_c::operator [](std::size_t idx)
+  const {
+  auto const &block = m_blocks[idx / s_block_size];
+  auto first_idx    = idx - idx % s_block_size;
+
+  // Continue from the cached position if its previous entry lies
+  // within the same block as the requested one and not after it.
+  if ((m_cursor.next_idx <= first_idx) || (m_cursor.next_idx > (idx + 1)))
+    m_cursor = cursor_t{ first_idx, block.data_start, block_start_entry(block) };
+
+  auto data      = m_data.data() + m_cursor.data_pos;
+  auto &previous = m_cursor.previous;
+
+  for (; m_cursor.next_idx <= idx; ++m_cursor.next_idx) {
+    auto size         = get_with_difference(data, previous.size);
+    auto file_pos     = get_with_difference(data, wrapping_add(previous.file_pos, previous.size));
+    auto duration     = get_with_difference(data, previous.duration);
+    auto timecode     = get_with_difference(data, wrapping_add(previous.timecode, previous.duration));
+
+    previous.size     = size;
+    previous.file_pos = file_pos;
+    previous.duration = duration;
+    previous.timecode = timecode;
+  }
+
+  m_cursor.data_pos = data - m_data.data();
+
+  auto entry        = previous;
+  entry.is_keyframe = !!(block.keyframes & (1ull << (idx - first_idx)));
+
+  return entry;
+}
+
+void
+frame_index_c::mark_as_keyframe(std::size_t idx) {
+  m_blocks[idx / s_block_size].keyframes |= 1ull << (idx % s_block_size);
+}
+
+void
+frame_index_c::adjust_timecodes(int64_t delta) {
+  for (auto &block : m_blocks)
+    block.timecode += delta;
+
+  m_last_entry.timecode += delta;
+  m_cursor               = cursor_t{};
+}
+
+void
+frame_index_c::erase_front(std::size_t num_entries) {
+  auto num_remaining = size() - std::min(num_entries, size());
+  frame_index_c remaining;
+
+  remaining.reserve(num_remaining);
+  for (auto idx = size() - num_remaining, end = size(); idx < end; ++idx)
+    remaining.push_back((*this)[idx]);
+
+  *this = std::move(remaining);
+}
+
+void
+frame_index_c::reserve(std::size_t num_entries) {
+  m_blocks.reserve((num_entries + s_block_size - 1) / s_block_size);
+}
+
+void
+frame_index_c::shrink_to_fit() {
+  m_blocks.shrink_to_fit();
+  m_data.shrink_to_fit();
+}
+
+void
+frame_index_c::clear() {
+  m_blocks.clear();
+  m_data.clear();
+  m_size   = 0;
+  m_cursor = cursor_t{};
+}
+
+std::size_t
+frame_index_c::size()
+  const {
+  return m_size;
+}
+
+bool
+frame_index_c::empty()
+  const {
+  return !m_size;
+}
+
+std::size_t
+frame_index_c::get_memory_usage()
+  const {
+  return m_blocks.capacity() * sizeof(block_t)
+       + m_data.capacity();
+}
+
+frame_index_c::const_iterator
+frame_index_c::begin()
+  const {
+  return const_iterator{*this, 0};
+}
+
+frame_index_c::const_iterator
+frame_index_c::end()
+  const {
+  return const_iterator{*this, size()};
+}
+
+}
@@ -0,0 +1,165 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   compact storage for the frame index of a track
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_FRAME_INDEX_H
+#define MTX_COMMON_FRAME_INDEX_H
+
+#include "common/common_pch.h"
+
+namespace mtx {
+
+/** \brief Stores position, size, timestamp, duration and key frame
+    flag of each frame of a track
+
+   The entries are stored in blocks of 64. Each block stores the
+   position and timestamp of its first entry, the key frame flags of
+   its entries as a bit mask and where its entries start in a byte
+   stream. For each entry the byte stream contains the differences
+   between its size, position, duration and timestamp and the values
+   predicted from the previous entry: the same size, the position
+   right after the previous frame, the same duration and the
+   timestamp right after the previous frame's end. The differences
+   are stored as variable-length numbers using one byte for each
+   seven bits. Regular frames therefore need between four and about
+   ten bytes instead of 40; there are no limits on the values.
+
+   Accessing an entry decodes the entries of its block up to it. The
+   position reached is cached so that sequential access decodes each
+   entry only once. Due to this cache even the const member functions
+   must not be called concurrently.
+*/
+class frame_index_c {
+public:
+  struct entry_t {
+    int64_t file_pos, size;
+    int64_t timecode, duration;
+    bool    is_keyframe;
+
+    entry_t()
+      : file_pos{}
+      , size{}
+      , timecode{}
+      , duration{}
+      , is_keyframe{}
+    {
+    }
+
+    entry_t(int64_t p_file_pos, int64_t p_size, int64_t p_timecode, int64_t p_duration, bool p_is_keyframe)
+      : file_pos{p_file_pos}
+      , size{p_size}
+      , timecode{p_timecode}
+      , duration{p_duration}
+      , is_keyframe{p_is_keyframe}
+    {
+    }
+  };
+
+  class const_iterator {
+  protected:
+    frame_index_c const *m_index;
+    std::size_t m_idx;
+
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type        = entry_t;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = entry_t const *;
+    using reference         = entry_t;
+
+    const_iterator(frame_index_c const &index, std::size_t idx)
+      : m_index{&index}
+      , m_idx{idx}
+    {
+    }
+
+    entry_t operator *() const {
+      return (*m_index)[m_idx];
+    }
+
+    const_iterator &operator ++() {
+      ++m_idx;
+      return *this;
+    }
+
+    const_iterator operator ++(int) {
+      auto copy = *this;
+      ++m_idx;
+      return copy;
+    }
+
+    bool operator ==(const_iterator const &other) const {
+      return m_idx == other.m_idx;
+    }
+
+    bool operator !=(const_iterator const &other) const {
+      return m_idx != other.m_idx;
+    }
+  };
+
+  using iterator = const_iterator;
+
+protected:
+  static std::size_t const s_block_size = 64;
+
+  struct block_t {
+    int64_t file_pos{}, timecode{};
+    uint64_t keyframes{};
+    std::size_t data_start{};
+  };
+
+  // The entry before next_idx and the position of next_idx's data. A
+  // next_idx of 0 means that nothing has been decoded yet.
+  struct cursor_t {
+    std::size_t next_idx{}, data_pos{};
+    entry_t previous;
+  };
+
+  std::vector<block_t> m_blocks;
+  std::vector<unsigned char> m_data;
+  entry_t m_last_entry;
+  std::size_t m_size{};
+  mutable cursor_t m_cursor;
+
+public:
+  void push_back(entry_t const &entry);
+
+  template<typename... Targs>
+  void
+  emplace_back(Targs &&... args) {
+    push_back(entry_t(std::forward<Targs>(args)...));
+  }
+
+  entry_t operator [](std::size_t idx) const;
+
+  void mark_as_keyframe(std::size_t idx);
+  void adjust_timecodes(int64_t delta);
+  void erase_front(std::size_t num_entries);
+
+  void reserve(std::size_t num_entries);
+  void shrink_to_fit();
+  void clear();
+
+  std::size_t size() const;
+  bool empty() const;
+  std::size_t get_memory_usage() const;
+
+  const_iterator begin() const;
+  const_iterator end() const;
+
+protected:
+  static entry_t block_start_entry(block_t const &block);
+};
+
+}
+
+#endif  // MTX_COMMON_FRAME_INDEX_H
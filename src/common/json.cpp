@@ -38,4 +38,75 @@ dump(nlohmann::json const &json,
   return json.dump(indentation);
 }
 
+object_writer_c::object_writer_c()
+{
+  m_out.reserve(256);
+}
+
+void
+object_writer_c::add_key(char const *key) {
+  m_out += m_out.empty() ? "{\"" : ",\"";
+  m_out += key;
+  m_out += "\":";
+}
+
+object_writer_c &
+object_writer_c::add(char const *key,
+                     std::string const &value) {
+  add_key(key);
+
+  // Most strings don't require escaping. Avoid the comparatively slow
+  // round trip through nlohmann::json for them.
+  auto needs_escaping = std::find_if(value.begin(), value.end(), [](char c) {
+    return (static_cast<unsigned char>(c) < 0x20) || (c == '"') || (c == '\\');
+  }) != value.end();
+
+  if (needs_escaping)
+    m_out += nlohmann::json(value).dump();
+
+  else {
+    m_out += '"';
+    m_out += value;
+    m_out += '"';
+  }
+
+  return *this;
+}
+
+object_writer_c &
+object_writer_c::add(char const *key,
+                     char const *value) {
+  return add(key, std::string{value});
+}
+
+object_writer_c &
+object_writer_c::add(char const *key,
+                     bool value) {
+  add_key(key);
+  m_out += value ? "true" : "false";
+  return *this;
+}
+
+object_writer_c &
+object_writer_c::add(char const *key,
+                     double value) {
+  add_key(key);
+  m_out += dump(nlohmann::json(value));
+  return *this;
+}
+
+object_writer_c &
+object_writer_c::add(char const *key,
+                     nlohmann::json const &value) {
+  add_key(key);
+  m_out += dump(value);
+  return *this;
+}
+
+std::string
+object_writer_c::str()
+  const {
+  return m_out.empty() ? std::string{"{}"} : m_out + "}";
+}
+
 }} // namespace mtx::json
@@ -27,6 +27,38 @@ namespace mtx { namespace json {
 nlohmann::json parse(nlohmann::json::string_t const &data, nlohmann::json::parser_callback_t callback = nullptr);
 nlohmann::json::string_t dump(nlohmann::json const &json, int indentation = 0);
 
+// Creates the textual representation of a single JSON object member by
+// member without building a nlohmann::json object first. Meant for
+// emitting large numbers of small objects, e.g. one per line. Keys
+// are written as they are and must not require escaping.
+class object_writer_c {
+protected:
+  std::string m_out;
+
+public:
+  object_writer_c();
+
+  object_writer_c &add(char const *key, std::string const &value);
+  object_writer_c &add(char const *key, char const *value);
+  object_writer_c &add(char const *key, bool value);
+  object_writer_c &add(char const *key, double value);
+  object_writer_c &add(char const *key, nlohmann::json const &value);
+
+  template<typename T>
+  typename std::enable_if<std::is_integral<T>::value, object_writer_c &>::type
+  add(char const *key,
+      T value) {
+    add_key(key);
+    m_out += std::to_string(value);
+    return *this;
+  }
+
+  std::string str() const;
+
+protected:
+  void add_key(char const *key);
+};
+
 }} // namespace mtx::json
 
 #endif // MTX_COMMON_JSON_H
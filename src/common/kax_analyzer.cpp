@@ -1472,6 +1472,12 @@ kax_analyzer_c::get_segment_data_start_pos()
   return m_segment->GetElementPosition() + m_segment->HeadSize();
 }
 
+uint64_t
+kax_analyzer_c::get_segment_end()
+  const {
+  return m_segment_end;
+}
+
 bitvalue_cptr
 kax_analyzer_c::read_segment_uid_from(std::string const &file_name) {
   try {
@@ -132,6 +132,9 @@ public:
   virtual ebml_element_cptr read_element(unsigned int pos);
 
   virtual void with_elements(const EbmlId &id, std::function<void(kax_analyzer_data_c const &)> worker) const;
+  virtual std::vector<kax_analyzer_data_cptr> const &get_elements() const {
+    return m_data;
+  }
   virtual int find(EbmlId const &id);
 
   virtual EbmlHead &get_ebml_head();
@@ -139,6 +142,7 @@ public:
 
   virtual uint64_t get_segment_pos() const;
   virtual uint64_t get_segment_data_start_pos() const;
+  virtual uint64_t get_segment_end() const;
 
   virtual kax_analyzer_c &set_parse_mode(parse_mode_e parse_mode);
   virtual kax_analyzer_c &set_open_mode(open_mode mode);
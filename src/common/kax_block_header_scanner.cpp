@@ -0,0 +1,351 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   reading only the headers of all blocks in all clusters
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include <ebml/EbmlCrc32.h>
+#include <ebml/EbmlVoid.h>
+#include <matroska/KaxBlock.h>
+#include <matroska/KaxCluster.h>
+
+#include "common/endian.h"
+#include "common/kax_block_header_scanner.h"
+#include "common/mm_io_x.h"
+#include "common/vint.h"
+
+using namespace libebml;
+using namespace libmatroska;
+
+namespace {
+
+bool
+is_id_in_context(EbmlSemanticContext const &context,
+                 vint_c const &id) {
+  for (size_t idx = 0, end = EBML_CTX_SIZE(context); end > idx; ++idx)
+    if (EBML_ID_VALUE(EBML_CTX_IDX_ID(context, idx)) == id.m_value)
+      return true;
+
+  return (EBML_ID_VALUE(EBML_ID(EbmlVoid))  == id.m_value)
+    ||   (EBML_ID_VALUE(EBML_ID(EbmlCrc32)) == id.m_value);
+}
+
+// Reads an EBML variable-length integer from the buffer. Returns its
+// length or 0 if it isn't fully contained in the buffer or invalid.
+std::size_t
+read_vint(unsigned char const *buffer,
+          std::size_t buffer_size,
+          uint64_t &value) {
+  if (!buffer_size || !buffer[0])
+    return 0;
+
+  auto length = 1u;
+  auto mask   = 0x80u;
+
+  while (!(buffer[0] & mask)) {
+    mask >>= 1;
+    ++length;
+  }
+
+  if (length > buffer_size)
+    return 0;
+
+  value = buffer[0] & (mask - 1);
+  for (auto idx = 1u; idx < length; ++idx)
+    value = (value << 8) | buffer[idx];
+
+  return length;
+}
+
+uint64_t
+read_uint(mm_io_c &in,
+          uint64_t size) {
+  if (8 < size)
+    throw mtx::mm_io::end_of_file_x{};
+
+  auto value = uint64_t{};
+  while (size--)
+    value = (value << 8) | in.read_uint8();
+
+  return value;
+}
+
+}
+
+kax_block_header_scanner_c::kax_block_header_scanner_c(mm_io_c &in,
+                                                       int64_t timestamp_scale)
+  : m_in(in)
+  , m_timestamp_scale{timestamp_scale}
+{
+}
+
+kax_block_header_scanner_c &
+kax_block_header_scanner_c::set_progress_callback(progress_cb_t const &callback) {
+  m_progress_cb = callback;
+  return *this;
+}
+
+kax_block_header_scanner_c::header_result_e
+kax_block_header_scanner_c::parse_block_header(unsigned char const *buffer,
+                                               std::size_t buffer_size,
+                                               uint64_t block_size,
+                                               block_t &block) {
+  auto missing = [buffer_size, block_size]() {
+    return buffer_size < block_size ? header_result_e::need_more_data : header_result_e::invalid;
+  };
+
+  buffer_size = static_cast<std::size_t>(std::min<uint64_t>(buffer_size, block_size));
+
+  auto pos    = read_vint(buffer, buffer_size, block.m_track_number);
+  if (!pos)
+    return buffer_size && !buffer[0] ? header_result_e::invalid : missing();
+
+  if ((pos + 3) > buffer_size)
+    return missing();
+
+  block.m_relative_timestamp = static_cast<int16_t>(get_uint16_be(&buffer[pos]));
+  auto lacing                = (buffer[pos + 2] >> 1) & 0x03;
+  pos                       += 3;
+
+  block.m_frame_sizes.clear();
+
+  if (!lacing) {
+    block.m_frame_sizes.push_back(block_size - pos);
+    return header_result_e::ok;
+  }
+
+  if (pos >= buffer_size)
+    return missing();
+
+  auto num_frames = static_cast<unsigned int>(buffer[pos]) + 1;
+  auto laced_size = uint64_t{};
+  ++pos;
+
+  if (0x01 == lacing) {         // Xiph lacing
+    for (auto frame = 1u; frame < num_frames; ++frame) {
+      auto frame_size = uint64_t{};
+      auto byte       = 0xffu;
+
+      while (0xff == byte) {
+        if (pos >= buffer_size)
+          return missing();
+
+        byte        = buffer[pos++];
+        frame_size += byte;
+      }
+
+      block.m_frame_sizes.push_back(frame_size);
+      laced_size += frame_size;
+    }
+
+  } else if (0x03 == lacing) {  // EBML lacing
+    auto frame_size = uint64_t{};
+
+    for (auto frame = 1u; frame < num_frames; ++frame) {
+      auto value  = uint64_t{};
+      auto length = read_vint(&buffer[pos], buffer_size - pos, value);
+
+      if (!length)
+        return (pos < buffer_size) && !buffer[pos] ? header_result_e::invalid : missing();
+
+      pos += length;
+
+      if (1 == frame)
+        frame_size = value;
+
+      else {
+        auto delta = static_cast<int64_t>(value) - ((int64_t{1} << (7 * length - 1)) - 1);
+        if ((delta < 0) && (static_cast<uint64_t>(-delta) > frame_size))
+          return header_result_e::invalid;
+        frame_size += delta;
+      }
+
+      block.m_frame_sizes.push_back(frame_size);
+      laced_size += frame_size;
+    }
+
+  } else {                      // fixed-size lacing
+    if ((block_size - pos) % num_frames)
+      return header_result_e::invalid;
+
+    block.m_frame_sizes.assign(num_frames, (block_size - pos) / num_frames);
+    return header_result_e::ok;
+  }
+
+  if ((pos + laced_size) > block_size)
+    return header_result_e::invalid;
+
+  block.m_frame_sizes.push_back(block_size - pos - laced_size);
+
+  return header_result_e::ok;
+}
+
+bool
+kax_block_header_scanner_c::read_block_header(uint64_t block_size) {
+  auto block_start = m_in.getFilePointer();
+  auto to_read     = std::min<uint64_t>(block_size, s_header_read_size);
+
+  while (true) {
+    m_header_buffer.resize(to_read);
+    if (m_in.read(m_header_buffer.data(), to_read) != to_read)
+      return false;
+
+    auto result = parse_block_header(m_header_buffer.data(), to_read, block_size, m_block);
+    if (header_result_e::need_more_data != result)
+      return header_result_e::ok == result;
+
+    // Extremely large lacing headers. Read the whole block.
+    to_read = block_size;
+    m_in.setFilePointer(block_start);
+  }
+}
+
+bool
+kax_block_header_scanner_c::scan_block_group(uint64_t data_end,
+                                             int64_t cluster_timestamp,
+                                             block_cb_t const &callback) {
+  auto block_found = false;
+  auto duration    = boost::optional<uint64_t>{};
+
+  while (m_in.getFilePointer() < data_end) {
+    auto id   = vint_c::read_ebml_id(m_in);
+    auto size = vint_c::read(m_in);
+
+    if (!id.is_valid() || size.is_unknown())
+      return false;
+
+    auto child_end = m_in.getFilePointer() + size.m_value;
+    if (child_end > data_end)
+      return false;
+
+    if (EBML_ID_VALUE(EBML_ID(KaxBlock)) == id.m_value) {
+      if (!read_block_header(size.m_value))
+        return false;
+      block_found = true;
+
+    } else if (EBML_ID_VALUE(EBML_ID(KaxBlockDuration)) == id.m_value)
+      duration = read_uint(m_in, size.m_value);
+
+    m_in.setFilePointer(child_end);
+  }
+
+  if (!block_found)
+    return true;
+
+  m_block.m_duration  = duration;
+  m_block.m_timestamp = (cluster_timestamp + m_block.m_relative_timestamp) * m_timestamp_scale;
+
+  callback(m_block);
+
+  return true;
+}
+
+bool
+kax_block_header_scanner_c::scan_cluster(uint64_t data_start,
+                                         boost::optional<uint64_t> data_end,
+                                         uint64_t end_pos,
+                                         block_cb_t const &callback) {
+  auto cluster_timestamp = int64_t{};
+  auto cluster_end       = data_end ? std::min(*data_end, end_pos) : end_pos;
+
+  m_in.setFilePointer(data_start);
+
+  while (m_in.getFilePointer() < cluster_end) {
+    auto element_start = m_in.getFilePointer();
+    auto id            = vint_c::read_ebml_id(m_in);
+    auto size          = vint_c::read(m_in);
+
+    if (!id.is_valid() || !size.is_valid())
+      return false;
+
+    // A cluster with an unknown size ends with the first element that
+    // cannot be one of its children.
+    if (!data_end && !is_id_in_context(EBML_CLASS_CONTEXT(KaxCluster), id)) {
+      m_in.setFilePointer(element_start);
+      return true;
+    }
+
+    if (size.is_unknown())
+      return false;
+
+    auto child_end = m_in.getFilePointer() + size.m_value;
+    if (child_end > cluster_end)
+      return false;
+
+    if (EBML_ID_VALUE(EBML_ID(KaxClusterTimecode)) == id.m_value)
+      cluster_timestamp = read_uint(m_in, size.m_value);
+
+    else if (EBML_ID_VALUE(EBML_ID(KaxSimpleBlock)) == id.m_value) {
+      if (!read_block_header(size.m_value))
+        return false;
+
+      m_block.m_duration.reset();
+      m_block.m_timestamp = (cluster_timestamp + m_block.m_relative_timestamp) * m_timestamp_scale;
+
+      callback(m_block);
+
+    } else if (EBML_ID_VALUE(EBML_ID(KaxBlockGroup)) == id.m_value) {
+      if (!scan_block_group(child_end, cluster_timestamp, callback))
+        return false;
+    }
+
+    // Skipping the frame data: seeking within a buffered file is
+    // cheap; larger payloads are skipped by actual seeks.
+    m_in.setFilePointer(child_end);
+  }
+
+  return true;
+}
+
+bool
+kax_block_header_scanner_c::scan(uint64_t start_pos,
+                                 uint64_t end_pos,
+                                 block_cb_t const &callback) {
+  try {
+    auto file_size = static_cast<uint64_t>(m_in.get_size());
+    end_pos        = !end_pos ? file_size : std::min(end_pos, file_size);
+
+    m_in.setFilePointer(start_pos);
+
+    while (m_in.getFilePointer() < end_pos) {
+      auto id   = vint_c::read_ebml_id(m_in);
+      auto size = vint_c::read(m_in);
+
+      if (!id.is_valid() || !size.is_valid())
+        return false;
+
+      auto data_start = m_in.getFilePointer();
+
+      if (EBML_ID_VALUE(EBML_ID(KaxCluster)) == id.m_value) {
+        auto data_end = size.is_unknown() ? boost::optional<uint64_t>{} : data_start + size.m_value;
+        if (!scan_cluster(data_start, data_end, end_pos, callback))
+          return false;
+
+        if (data_end)
+          m_in.setFilePointer(std::min(*data_end, end_pos));
+
+      } else if (size.is_unknown())
+        return false;
+
+      else
+        m_in.setFilePointer(std::min(data_start + size.m_value, end_pos));
+
+      if (m_progress_cb)
+        m_progress_cb(m_in.getFilePointer());
+    }
+
+    return true;
+
+  } catch (mtx::mm_io::exception &) {
+    return false;
+  }
+}
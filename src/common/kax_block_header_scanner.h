@@ -0,0 +1,81 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   reading only the headers of all blocks in all clusters
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_KAX_BLOCK_HEADER_SCANNER_H
+#define MTX_COMMON_KAX_BLOCK_HEADER_SCANNER_H
+
+#include "common/common_pch.h"
+
+#include <boost/optional.hpp>
+
+#include "common/mm_io.h"
+
+class kax_block_header_scanner_c {
+public:
+  enum class header_result_e {
+    ok,
+    need_more_data,
+    invalid,
+  };
+
+  struct block_t {
+    uint64_t m_track_number{};
+    int16_t m_relative_timestamp{};
+    int64_t m_timestamp{};              // absolute, in nanoseconds
+    boost::optional<uint64_t> m_duration; // value of the BlockDuration element, if present
+    std::vector<uint64_t> m_frame_sizes;
+  };
+
+  using block_cb_t    = std::function<void(block_t const &)>;
+  using progress_cb_t = std::function<void(uint64_t)>;
+
+  // The maximum number of bytes read at the start of each block for
+  // parsing its header. Only blocks whose lacing header is larger
+  // than this will be read a second time.
+  static std::size_t const s_header_read_size = 1024;
+
+protected:
+  mm_io_c &m_in;
+  int64_t m_timestamp_scale;
+  progress_cb_t m_progress_cb;
+  std::vector<unsigned char> m_header_buffer;
+  block_t m_block;
+
+public:
+  kax_block_header_scanner_c(mm_io_c &in, int64_t timestamp_scale);
+
+  kax_block_header_scanner_c &set_progress_callback(progress_cb_t const &callback);
+
+  // Walks over all level 1 elements between start_pos and end_pos
+  // (0 meaning the end of the file) and calls the callback for each
+  // Block and SimpleBlock found in a cluster. Only the element and
+  // block headers are read; the frame data is skipped. Returns false
+  // if the file structure could not be parsed, e.g. due to damaged
+  // elements or level 1 elements other than clusters with an unknown
+  // size. The callback may have been called for some blocks already
+  // in that case.
+  bool scan(uint64_t start_pos, uint64_t end_pos, block_cb_t const &callback);
+
+  // Parses the header of a Block or SimpleBlock: the track number, the
+  // relative timestamp, the flags and the lacing information. buffer
+  // contains the first buffer_size bytes of the block's data whose
+  // total size is block_size.
+  static header_result_e parse_block_header(unsigned char const *buffer, std::size_t buffer_size, uint64_t block_size, block_t &block);
+
+protected:
+  bool scan_cluster(uint64_t data_start, boost::optional<uint64_t> data_end, uint64_t end_pos, block_cb_t const &callback);
+  bool scan_block_group(uint64_t data_end, int64_t cluster_timestamp, block_cb_t const &callback);
+  bool read_block_header(uint64_t block_size);
+};
+
+#endif  // MTX_COMMON_KAX_BLOCK_HEADER_SCANNER_H
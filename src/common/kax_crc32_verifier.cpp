@@ -0,0 +1,137 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   verification of the CRC-32 elements of level 1 elements
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include <ebml/EbmlCrc32.h>
+
+#include "common/checksums/base.h"
+#include "common/endian.h"
+#include "common/kax_crc32_verifier.h"
+#include "common/mm_io_x.h"
+#include "common/parallel.h"
+#include "common/vint.h"
+
+kax_crc32_verifier_c::kax_crc32_verifier_c(std::string const &file_name,
+                                           std::vector<kax_analyzer_data_cptr> const &elements)
+  : m_file_name{file_name}
+{
+  m_results.reserve(elements.size());
+
+  for (auto const &element : elements)
+    m_results.push_back({ element->m_id, element->m_pos, element->m_size, element->m_size_known ? result_e::no_crc32 : result_e::size_unknown, 0, 0 });
+}
+
+kax_crc32_verifier_c &
+kax_crc32_verifier_c::set_num_threads(unsigned int num_threads) {
+  m_num_threads = num_threads;
+  return *this;
+}
+
+std::vector<kax_crc32_verifier_c::element_result_t> const &
+kax_crc32_verifier_c::get_results()
+  const {
+  return m_results;
+}
+
+std::size_t
+kax_crc32_verifier_c::count(result_e result)
+  const {
+  return boost::count_if(m_results, [result](element_result_t const &element) { return element.m_result == result; });
+}
+
+void
+kax_crc32_verifier_c::verify() {
+  // Hand out contiguous runs of elements so that each file handle
+  // reads mostly sequentially while still leaving enough work items
+  // for balancing the load between the threads.
+  auto num_threads = m_num_threads ? m_num_threads : mtx::parallel::default_num_threads();
+  auto num_batches = std::min<std::size_t>(m_results.size(), num_threads * 8);
+
+  mtx::parallel::for_each_index(num_batches, [this, num_batches](std::size_t batch_idx) {
+    auto first = m_results.size() *  batch_idx      / num_batches;
+    auto last  = m_results.size() * (batch_idx + 1) / num_batches;
+
+    mm_file_io_c file{m_file_name};
+
+    for (auto idx = first; idx < last; ++idx)
+      verify_element(file, m_results[idx]);
+
+  }, num_threads);
+}
+
+void
+kax_crc32_verifier_c::verify_element(mm_io_c &file,
+                                     element_result_t &result)
+  const {
+  if (result_e::size_unknown == result.m_result)
+    return;
+
+  try {
+    file.setFilePointer(result.m_pos);
+
+    auto id   = vint_c::read_ebml_id(file);
+    auto size = vint_c::read(file);
+
+    if (!id.is_valid() || !size.is_valid()) {
+      result.m_result = result_e::read_error;
+      return;
+    }
+
+    if (size.is_unknown()) {
+      result.m_result = result_e::size_unknown;
+      return;
+    }
+
+    // The CRC-32 element must be the first child. Its content covers
+    // all of the parent's data following the CRC-32 element.
+    auto data_end = file.getFilePointer() + size.m_value;
+    auto crc_id   = vint_c::read_ebml_id(file);
+
+    if (!crc_id.is_valid() || !(static_cast<EbmlId>(crc_id) == EBML_ID(EbmlCrc32))) {
+      result.m_result = result_e::no_crc32;
+      return;
+    }
+
+    auto crc_size = vint_c::read(file);
+    if (!crc_size.is_valid() || (4 != crc_size.m_value) || ((file.getFilePointer() + 4) > data_end)) {
+      result.m_result = result_e::mismatch;
+      return;
+    }
+
+    result.m_stored_crc = file.read_uint32_le();
+
+    auto checker   = mtx::checksum::for_algorithm(mtx::checksum::algorithm_e::crc32_ieee_le, 0xffffffff);
+    auto remaining = data_end - file.getFilePointer();
+    auto buffer    = memory_c::alloc(std::min<uint64_t>(remaining, 1024 * 1024));
+
+    while (remaining) {
+      auto to_read = std::min<uint64_t>(remaining, buffer->get_size());
+      if (file.read(buffer->get_buffer(), to_read) != to_read) {
+        result.m_result = result_e::read_error;
+        return;
+      }
+
+      checker->add(buffer->get_buffer(), to_read);
+      remaining -= to_read;
+    }
+
+    checker->finish();
+
+    result.m_calculated_crc = 0xffffffff ^ dynamic_cast<mtx::checksum::uint_result_c &>(*checker).get_result_as_uint();
+    result.m_result         = result.m_calculated_crc == result.m_stored_crc ? result_e::ok : result_e::mismatch;
+
+  } catch (mtx::mm_io::exception &) {
+    result.m_result = result_e::read_error;
+  }
+}
@@ -0,0 +1,61 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   verification of the CRC-32 elements of level 1 elements
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_KAX_CRC32_VERIFIER_H
+#define MTX_COMMON_KAX_CRC32_VERIFIER_H
+
+#include "common/common_pch.h"
+
+#include "common/kax_analyzer.h"
+
+class kax_crc32_verifier_c {
+public:
+  enum class result_e {
+    no_crc32,
+    ok,
+    mismatch,
+    size_unknown,
+    read_error,
+  };
+
+  struct element_result_t {
+    EbmlId m_id;
+    uint64_t m_pos;
+    int64_t m_size;
+    result_e m_result;
+    uint32_t m_stored_crc, m_calculated_crc;
+  };
+
+protected:
+  std::string m_file_name;
+  std::vector<element_result_t> m_results;
+  unsigned int m_num_threads{};
+
+public:
+  kax_crc32_verifier_c(std::string const &file_name, std::vector<kax_analyzer_data_cptr> const &elements);
+
+  kax_crc32_verifier_c &set_num_threads(unsigned int num_threads);
+
+  // Reads all elements and compares their stored CRC-32 values with
+  // the calculated ones. The elements are distributed to several
+  // threads each of which uses its own file handle.
+  void verify();
+
+  std::vector<element_result_t> const &get_results() const;
+  std::size_t count(result_e result) const;
+
+protected:
+  void verify_element(mm_io_c &file, element_result_t &result) const;
+};
+
+#endif  // MTX_COMMON_KAX_CRC32_VERIFIER_H
@@ -15,16 +15,23 @@
 
 #include <typeinfo>
 
+#include <boost/optional.hpp>
+
 #include <ebml/EbmlCrc32.h>
 #include <ebml/EbmlStream.h>
 #include <ebml/EbmlVoid.h>
 
 #include "common/ebml.h"
+#include "common/endian.h"
 #include "common/fs_sys_helpers.h"
 #include "common/kax_file.h"
 #include "common/mm_io_x.h"
 #include "common/strings/formatting.h"
 
+uint64_t const kax_file_c::s_resync_window_size;
+int64_t const kax_file_c::s_max_timecode_rewind;
+uint64_t const kax_file_c::s_max_implausible_skip;
+
 kax_file_c::kax_file_c(mm_io_c &in)
   : m_in(in)
   , m_resynced{}
@@ -201,12 +208,14 @@ kax_file_c::resync_to_level1_element_internal(uint32_t wanted_id) {
   if (m_segment_end && (m_in.getFilePointer() >= m_segment_end))
     return nullptr;
 
-  m_resynced         = true;
-  m_resync_start_pos = m_in.getFilePointer();
+  m_resynced          = true;
+  m_resync_start_pos  = m_in.getFilePointer();
+  m_resync_statistics = resync_statistics_t{};
 
-  auto actual_id     = m_in.read_uint32_be();
-  auto start_time    = mtx::sys::get_current_time_millis();
-  auto is_cluster_id = !wanted_id || (EBML_ID_VALUE(EBML_ID(KaxCluster)) == wanted_id); // 0 means: any level 1 element will do
+  auto start_time     = mtx::sys::get_current_time_millis();
+  auto report_time    = start_time;
+  auto is_cluster_id  = !wanted_id || (EBML_ID_VALUE(EBML_ID(KaxCluster)) == wanted_id); // 0 means: any level 1 element will do
+  auto last_timecode  = m_last_timecode;
 
   report(boost::format(Y("%1%: Error in the Matroska file structure at position %2%. Resyncing to the next level 1 element.\n"))
          % m_in.get_file_name() % m_resync_start_pos);
@@ -217,74 +226,223 @@ kax_file_c::resync_to_level1_element_internal(uint32_t wanted_id) {
   }
 
   if (m_debug_resync)
-    mxinfo(boost::format("kax_file::resync_to_level1_element(): starting at %1% potential ID %|2$08x|\n") % m_resync_start_pos % actual_id);
-
-  while (m_in.getFilePointer() < m_file_size) {
+    mxinfo(boost::format("kax_file::resync_to_level1_element(): starting at %1% wanted ID %|2$x|\n") % m_resync_start_pos % wanted_id);
+
+  // Search whole windows for the four-byte level 1 IDs instead of
+  // checking each position. Consecutive windows overlap by three
+  // bytes so that IDs spanning two windows are found, too. The
+  // position the error occurred at is not a valid candidate.
+  auto searcher     = create_resync_searcher(wanted_id);
+  auto buffer       = memory_c::alloc(s_resync_window_size);
+  auto data         = buffer->get_buffer();
+  auto window_start = m_resync_start_pos;
+  auto search_start = std::size_t{1};
+  boost::optional<uint64_t> fallback_pos;
+
+  while (window_start < m_file_size) {
     auto now = mtx::sys::get_current_time_millis();
-    if ((now - start_time) >= 10000) {
-      report(boost::format("Still resyncing at position %1%.\n") % m_in.getFilePointer());
-      start_time = now;
+    if ((now - report_time) >= 10000) {
+      report(boost::format("Still resyncing at position %1%.\n") % window_start);
+      report_time = now;
     }
 
-    actual_id = (actual_id << 8) | m_in.read_uint8();
+    m_in.setFilePointer(window_start, seek_beginning);
+    auto num_read = static_cast<std::size_t>(m_in.read(data, std::min(s_resync_window_size, m_file_size - window_start)));
 
-    if (   ((0 != wanted_id) && (wanted_id != actual_id))
-        || ((0 == wanted_id) && !is_level1_element_id(vint_c(actual_id, 4))))
-      continue;
+    if (4 > num_read)
+      break;
 
-    auto current_start_pos  = m_in.getFilePointer() - 4;
-    auto element_pos        = current_start_pos;
-    auto num_headers        = 1u;
-    auto valid_unknown_size = false;
+    for (auto pos = searcher.find(data, num_read, search_start); std::string::npos != pos; pos = searcher.find(data, num_read, pos + 1)) {
+      auto candidate_pos = window_start + pos;
+      auto candidate_id  = get_uint32_be(&data[pos]);
 
-    if (m_debug_resync)
-      mxinfo(boost::format("kax_file::resync_to_level1_element(): byte-for-byte search, found level 1 ID %|2$x| at %1%\n") % current_start_pos % actual_id);
+      ++m_resync_statistics.m_num_candidates;
 
-    try {
-      for (auto idx = 0; 3 > idx; ++idx) {
-        auto length = vint_c::read(m_in);
+      auto result = check_resync_candidate(candidate_pos, candidate_id, wanted_id, last_timecode);
 
-        if (m_debug_resync)
-          mxinfo(boost::format("kax_file::resync_to_level1_element():   read ebml length %1%/%2% valid? %3% unknown? %4%\n")
-                 % length.m_value % length.m_coded_size % length.is_valid() % length.is_unknown());
+      if (resync_candidate_e::valid == result)
+        return finish_resync(candidate_pos, wanted_id, is_cluster_id, start_time);
 
-        if (length.is_unknown()) {
-          valid_unknown_size = true;
-          break;
-        }
+      if (resync_candidate_e::invalid == result)
+        ++m_resync_statistics.m_num_rejected_candidates;
 
-        if (   !length.is_valid()
-            || ((element_pos + length.m_value + length.m_coded_size + 2 * 4) >= m_file_size)
-            || !m_in.setFilePointer2(element_pos + 4 + length.m_value + length.m_coded_size, seek_beginning))
-          break;
+      else {
+        ++m_resync_statistics.m_num_implausible_candidates;
+        if (!fallback_pos)
+          fallback_pos = candidate_pos;
+      }
+    }
+
+    window_start += num_read - 3;
+    search_start  = 0;
 
-        element_pos  = m_in.getFilePointer();
-        auto next_id = m_in.read_uint32_be();
+    if (fallback_pos && ((window_start - *fallback_pos) >= s_max_implausible_skip))
+      break;
+  }
 
-        if (m_debug_resync)
-          mxinfo(boost::format("kax_file::resync_to_level1_element():   next ID is %|1$x| at %2%\n") % next_id % element_pos);
+  if (fallback_pos)
+    return finish_resync(*fallback_pos, wanted_id, is_cluster_id, start_time);
 
-        if (   ((0 != wanted_id) && (wanted_id != next_id))
-            || ((0 == wanted_id) && !is_level1_element_id(vint_c(next_id, 4))))
-          break;
+  m_resync_statistics.m_num_bytes_skipped = m_file_size - m_resync_start_pos;
+  m_resync_statistics.m_duration_ms       = mtx::sys::get_current_time_millis() - start_time;
 
-        ++num_headers;
+  report(Y("Resync failed: no valid Matroska level 1 element found.\n"));
+  report_resync_statistics();
+
+  return nullptr;
+}
+
+mtx::sync_word_searcher_c
+kax_file_c::create_resync_searcher(uint32_t wanted_id)
+  const {
+  std::vector<mtx::sync_word_searcher_c::sync_word_t> ids;
+
+  if (wanted_id)
+    ids.push_back({ wanted_id, 0xffffffff, 4 });
+
+  else {
+    auto &context = EBML_CLASS_CONTEXT(KaxSegment);
+    for (size_t segment_idx = 0, end = EBML_CTX_SIZE(context); end > segment_idx; ++segment_idx)
+      ids.push_back({ static_cast<uint32_t>(EBML_ID_VALUE(EBML_CTX_IDX_ID(context,segment_idx))), 0xffffffff, 4 });
+  }
+
+  return mtx::sync_word_searcher_c(ids);
+}
+
+kax_file_c::resync_candidate_e
+kax_file_c::check_resync_candidate(uint64_t candidate_pos,
+                                   uint32_t candidate_id,
+                                   uint32_t wanted_id,
+                                   int64_t last_timecode) {
+  auto element_pos        = candidate_pos;
+  auto num_headers        = 1u;
+  auto valid_unknown_size = false;
+
+  if (m_debug_resync)
+    mxinfo(boost::format("kax_file::resync_to_level1_element(): found level 1 ID %|2$x| at %1%\n") % candidate_pos % candidate_id);
+
+  // Try to locate at least three valid ID/sizes following the
+  // candidate, not just one ID.
+  try {
+    m_in.setFilePointer(candidate_pos + 4, seek_beginning);
+
+    for (auto idx = 0; 3 > idx; ++idx) {
+      auto length = vint_c::read(m_in);
+
+      if (m_debug_resync)
+        mxinfo(boost::format("kax_file::resync_to_level1_element():   read ebml length %1%/%2% valid? %3% unknown? %4%\n")
+               % length.m_value % length.m_coded_size % length.is_valid() % length.is_unknown());
+
+      if (length.is_unknown()) {
+        valid_unknown_size = true;
+        break;
       }
-    } catch (...) {
+
+      if (   !length.is_valid()
+          || ((element_pos + length.m_value + length.m_coded_size + 2 * 4) >= m_file_size)
+          || !m_in.setFilePointer2(element_pos + 4 + length.m_value + length.m_coded_size, seek_beginning))
+        break;
+
+      element_pos  = m_in.getFilePointer();
+      auto next_id = m_in.read_uint32_be();
+
+      if (m_debug_resync)
+        mxinfo(boost::format("kax_file::resync_to_level1_element():   next ID is %|1$x| at %2%\n") % next_id % element_pos);
+
+      if (   ((0 != wanted_id) && (wanted_id != next_id))
+          || ((0 == wanted_id) && !is_level1_element_id(vint_c(next_id, 4))))
+        break;
+
+      ++num_headers;
     }
+  } catch (...) {
+  }
+
+  if ((4 != num_headers) && !valid_unknown_size)
+    return resync_candidate_e::invalid;
+
+  if (   (EBML_ID_VALUE(EBML_ID(KaxCluster)) == candidate_id)
+      && !is_cluster_timecode_plausible(candidate_pos, last_timecode)) {
+    if (m_debug_resync)
+      mxinfo(boost::format("kax_file::resync_to_level1_element():   cluster timestamp missing or implausible\n"));
+    return resync_candidate_e::implausible;
+  }
+
+  return resync_candidate_e::valid;
+}
+
+bool
+kax_file_c::is_cluster_timecode_plausible(uint64_t cluster_pos,
+                                          int64_t last_timecode) {
+  try {
+    m_in.setFilePointer(cluster_pos + 4, seek_beginning);
+
+    auto cluster_size = vint_c::read(m_in);
+    auto cluster_end  = cluster_pos + 4 + cluster_size.m_coded_size + cluster_size.m_value;
+    auto child_id     = vint_c::read_ebml_id(m_in);
+
+    // The cluster timestamp must be the first child apart from CRC-32
+    // and Void elements.
+    while (child_id.is_valid() && is_global_element_id(child_id)) {
+      auto child_size = vint_c::read(m_in);
+      if (!child_size.is_valid() || child_size.is_unknown())
+        return false;
 
-    if ((4 == num_headers) || valid_unknown_size) {
-      report(boost::format(Y("Resyncing successful at position %1%.\n")) % current_start_pos);
-      m_in.setFilePointer(current_start_pos, seek_beginning);
-      return read_next_level1_element(wanted_id, is_cluster_id);
+      m_in.skip(child_size.m_value);
+      child_id = vint_c::read_ebml_id(m_in);
     }
 
-    m_in.setFilePointer(current_start_pos + 4, seek_beginning);
+    if (!child_id.is_valid() || (EBML_ID_VALUE(EBML_ID(KaxClusterTimecode)) != child_id.m_value))
+      return false;
+
+    auto timecode_size = vint_c::read(m_in);
+    if (   !timecode_size.is_valid()
+        || timecode_size.is_unknown()
+        || (8 < timecode_size.m_value)
+        || (!cluster_size.is_unknown() && ((m_in.getFilePointer() + timecode_size.m_value) > cluster_end)))
+      return false;
+
+    auto timecode = uint64_t{};
+    for (auto idx = 0; idx < timecode_size.m_value; ++idx)
+      timecode = (timecode << 8) | m_in.read_uint8();
+
+    if (m_debug_resync)
+      mxinfo(boost::format("kax_file::resync_to_level1_element():   cluster timestamp %1% last timestamp %2%\n") % timecode % last_timecode);
+
+    if ((0 >= m_timecode_scale) || (-1 == last_timecode))
+      return true;
+
+    if (timecode > static_cast<uint64_t>(std::numeric_limits<int64_t>::max() / m_timecode_scale))
+      return false;
+
+    return (static_cast<int64_t>(timecode) * m_timecode_scale + s_max_timecode_rewind) >= last_timecode;
+
+  } catch (...) {
+    return false;
   }
+}
 
-  report(Y("Resync failed: no valid Matroska level 1 element found.\n"));
+EbmlElement *
+kax_file_c::finish_resync(uint64_t element_pos,
+                          uint32_t wanted_id,
+                          bool is_cluster_id,
+                          int64_t start_time) {
+  m_resync_statistics.m_num_bytes_skipped = element_pos - m_resync_start_pos;
+  m_resync_statistics.m_duration_ms       = mtx::sys::get_current_time_millis() - start_time;
+
+  report(boost::format(Y("Resyncing successful at position %1%.\n")) % element_pos);
+  report_resync_statistics();
+
+  m_in.setFilePointer(element_pos, seek_beginning);
+  return read_next_level1_element(wanted_id, is_cluster_id);
+}
 
-  return nullptr;
+void
+kax_file_c::report_resync_statistics() {
+  auto const &stats = m_resync_statistics;
+
+  report(boost::format(Y("Resync statistics: %1% bytes skipped, %2% candidate positions checked (%3% rejected, %4% with missing or implausible timestamps) in %5% ms.\n"))
+         % stats.m_num_bytes_skipped % stats.m_num_candidates % stats.m_num_rejected_candidates % stats.m_num_implausible_candidates % stats.m_duration_ms);
 }
 
 KaxCluster *
@@ -307,6 +465,12 @@ kax_file_c::get_resync_start_pos() const {
   return m_resync_start_pos;
 }
 
+kax_file_c::resync_statistics_t const &
+kax_file_c::get_resync_statistics()
+  const {
+  return m_resync_statistics;
+}
+
 unsigned long
 kax_file_c::get_element_size(EbmlElement *e) {
   auto m = dynamic_cast<EbmlMaster *>(e);
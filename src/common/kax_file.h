@@ -19,17 +19,39 @@
 #include <matroska/KaxSegment.h>
 #include <matroska/KaxCluster.h>
 
+#include "common/sync_word_searcher.h"
 #include "common/vint.h"
 
 using namespace libebml;
 using namespace libmatroska;
 
 class kax_file_c {
+public:
+  struct resync_statistics_t {
+    uint64_t m_num_bytes_skipped{}, m_num_candidates{}, m_num_rejected_candidates{}, m_num_implausible_candidates{};
+    int64_t m_duration_ms{};
+  };
+
 protected:
+  // Resyncing reads the file in windows of this size.
+  static uint64_t const s_resync_window_size   = 1024 * 1024;
+  // A cluster whose timestamp lies more than this before the last
+  // timestamp processed is only used if no other cluster follows
+  // within s_max_implausible_skip bytes.
+  static int64_t const s_max_timecode_rewind   = 60000000000ll;
+  static uint64_t const s_max_implausible_skip = 16 * 1024 * 1024;
+
+  enum class resync_candidate_e {
+    valid,
+    invalid,
+    implausible,
+  };
+
   mm_io_c &m_in;
   bool m_resynced, m_reporting_enabled{true};
   uint64_t m_resync_start_pos, m_file_size, m_segment_end;
   int64_t m_timecode_scale, m_last_timecode;
+  resync_statistics_t m_resync_statistics;
   std::shared_ptr<EbmlStream> m_es;
 
   debugging_option_c m_debug_read_next, m_debug_resync;
@@ -40,6 +62,7 @@ public:
 
   virtual bool was_resynced() const;
   virtual int64_t get_resync_start_pos() const;
+  virtual resync_statistics_t const &get_resync_statistics() const;
   virtual bool is_level1_element_id(vint_c id) const;
   virtual bool is_global_element_id(vint_c id) const;
 
@@ -63,6 +86,11 @@ protected:
 
   virtual EbmlElement *read_next_level1_element_internal(uint32_t wanted_id = 0);
   virtual EbmlElement *resync_to_level1_element_internal(uint32_t wanted_id = 0);
+  virtual mtx::sync_word_searcher_c create_resync_searcher(uint32_t wanted_id) const;
+  virtual resync_candidate_e check_resync_candidate(uint64_t candidate_pos, uint32_t candidate_id, uint32_t wanted_id, int64_t last_timecode);
+  virtual bool is_cluster_timecode_plausible(uint64_t cluster_pos, int64_t last_timecode);
+  virtual EbmlElement *finish_resync(uint64_t element_pos, uint32_t wanted_id, bool is_cluster_id, int64_t start_time);
+  virtual void report_resync_statistics();
 
   virtual void report(boost::format const &message);
   virtual void report(std::string const &message);
@@ -27,6 +27,7 @@
 #include "common/memory.h"
 #include "common/mm_io.h"
 #include "common/strings/parsing.h"
+#include "common/strings/utf8.h"
 #ifdef SYS_WINDOWS
 # include "common/fs_sys_helpers.h"
 # include "common/strings/formatting.h"
@@ -38,12 +39,14 @@ std::map<std::string, charset_converter_cptr> charset_converter_c::s_converters;
 
 charset_converter_c::charset_converter_c()
   : m_detect_byte_order_marker(false)
+  , m_ascii_compatible(false)
 {
 }
 
 charset_converter_c::charset_converter_c(const std::string &charset)
   : m_charset(charset)
   , m_detect_byte_order_marker(false)
+  , m_ascii_compatible(false)
 {
 }
 
@@ -114,6 +117,25 @@ charset_converter_c::handle_string_with_bom(const std::string &source,
   return true;
 }
 
+// Most character sets encode the 7-bit ASCII characters the same way
+// UTF-8 does. Strings consisting of such characters only don't have
+// to be converted. Must be called by the derived classes once they're
+// ready to convert strings.
+void
+charset_converter_c::detect_ascii_compatibility() {
+  std::string ascii;
+  for (auto c = 0x01; c < 0x80; ++c)
+    ascii += static_cast<char>(c);
+
+  m_ascii_compatible = (utf8(ascii) == ascii) && (native(ascii) == ascii);
+}
+
+bool
+charset_converter_c::can_skip_conversion(const std::string &source)
+  const {
+  return m_ascii_compatible && is_ascii(source);
+}
+
 // ------------------------------------------------------------
 static iconv_t const s_iconv_t_error_value = reinterpret_cast<iconv_t>(-1);
 
@@ -140,6 +162,8 @@ iconv_charset_converter_c::iconv_charset_converter_c(const std::string &charset)
     mxwarn(boost::format(Y("Could not initialize the iconv library for the conversion from UTF-8 to %1%. "
                            "Some strings cannot be converted from UTF-8 and might be displayed incorrectly (error: %2%, %3%).\n"))
            % charset % errno % strerror(errno));
+
+  detect_ascii_compatibility();
 }
 
 iconv_charset_converter_c::~iconv_charset_converter_c() {
@@ -156,12 +180,12 @@ iconv_charset_converter_c::utf8(const std::string &source) {
   if (handle_string_with_bom(source, recoded))
     return recoded;
 
-  return m_is_utf8 ? source : iconv_charset_converter_c::convert(m_to_utf8_handle, source);
+  return m_is_utf8 || can_skip_conversion(source) ? source : iconv_charset_converter_c::convert(m_to_utf8_handle, source);
 }
 
 std::string
 iconv_charset_converter_c::native(const std::string &source) {
-  return m_is_utf8 ? source : iconv_charset_converter_c::convert(m_from_utf8_handle, source);
+  return m_is_utf8 || can_skip_conversion(source) ? source : iconv_charset_converter_c::convert(m_from_utf8_handle, source);
 }
 
 std::string
@@ -214,6 +238,8 @@ windows_charset_converter_c::windows_charset_converter_c(const std::string &char
   , m_is_utf8(is_utf8_charset_name(charset))
   , m_code_page(extract_code_page(charset))
 {
+  if (!m_is_utf8)
+    detect_ascii_compatibility();
 }
 
 windows_charset_converter_c::~windows_charset_converter_c() {
@@ -225,12 +251,12 @@ windows_charset_converter_c::utf8(const std::string &source) {
   if (handle_string_with_bom(source, recoded))
     return recoded;
 
-  return m_is_utf8 ? source : windows_charset_converter_c::convert(m_code_page, CP_UTF8, source);
+  return m_is_utf8 || can_skip_conversion(source) ? source : windows_charset_converter_c::convert(m_code_page, CP_UTF8, source);
 }
 
 std::string
 windows_charset_converter_c::native(const std::string &source) {
-  return m_is_utf8 ? source : windows_charset_converter_c::convert(CP_UTF8, m_code_page, source);
+  return m_is_utf8 || can_skip_conversion(source) ? source : windows_charset_converter_c::convert(CP_UTF8, m_code_page, source);
 }
 
 std::string
@@ -34,11 +34,7 @@ round_to_nearest_pow2(uint64_t value) {
 
 int
 int_log2(uint64_t value) {
-  for (int bit = 63; bit >= 0; --bit)
-    if (value & (1ull << bit))
-      return bit;
-
-  return -1;
+  return value ? 63 - static_cast<int>(count_leading_zeros(value)) : -1;
 }
 
 double
@@ -17,6 +17,7 @@
 #include "common/common_pch.h"
 
 #include <deque>
+#include <new>
 
 #include "common/error.h"
 
@@ -150,19 +151,31 @@ public:
     return its_counter && its_counter->is_free;
   }
 
-  void grab() {
-    if (!its_counter || its_counter->is_free)
-      return;
+  // Makes sure the buffer is owned by this object by copying it
+  // unless it is already owned or kept alive by an owner (see
+  // slice()). Returns the number of bytes copied.
+  size_t grab() {
+    if (!its_counter || its_counter->is_free || its_counter->owner || its_counter->holds_inline_data())
+      return 0;
 
     its_counter->ptr      = static_cast<unsigned char *>(safememdup(get_buffer(), get_size()));
     its_counter->is_free  = true;
     its_counter->size    -= its_counter->offset;
     its_counter->offset   = 0;
+
+    return its_counter->size;
   }
 
   void lock() {
-    if (its_counter)
-      its_counter->is_free = false;
+    if (!its_counter)
+      return;
+
+    // Whoever locks the buffer takes it over. Buffers stored together
+    // with their counter must therefore be moved out first.
+    if (its_counter->holds_inline_data())
+      its_counter->ptr = static_cast<unsigned char *>(safememdup(its_counter->ptr, its_counter->size));
+
+    its_counter->is_free = false;
   }
 
   void resize(size_t new_size) throw();
@@ -180,13 +193,20 @@ public:
 public:
   static memory_cptr
   alloc(size_t size) {
-    return memory_cptr(new memory_c(static_cast<unsigned char *>(safemalloc(size)), size, true));
+    return std::make_shared<memory_c>(static_cast<unsigned char *>(safemalloc(size)), size, true);
   };
 
+  // Small buffers such as subtitle lines are copied into the same
+  // allocation as the counter.
   static inline memory_cptr
   clone(const void *buffer,
         size_t size) {
-    return memory_cptr(new memory_c(static_cast<unsigned char *>(safememdup(buffer, size)), size, true));
+    if (size > s_max_inline_size)
+      return std::make_shared<memory_c>(static_cast<unsigned char *>(safememdup(buffer, size)), size, true);
+
+    auto mem         = std::make_shared<memory_c>();
+    mem->its_counter = counter::create_with_inline_data(buffer, size);
+    return mem;
   }
 
   static inline memory_cptr
@@ -199,13 +219,37 @@ public:
     return std::make_shared<memory_c>(reinterpret_cast<unsigned char *>(&buffer[0]), buffer.length(), false);
   }
 
+  // Points to a part of a buffer owned by something else, e.g. a large
+  // block read from a file or a Matroska cluster, without copying
+  // it. The owner is kept alive until the slice is destroyed. Its
+  // content must not be changed afterwards.
+  static memory_cptr
+  slice(std::shared_ptr<void> const &owner,
+        void *buffer,
+        size_t size) {
+    auto mem = std::make_shared<memory_c>(buffer, size, false);
+    if (mem->its_counter)
+      mem->its_counter->owner = owner;
+    return mem;
+  }
+
+  static memory_cptr
+  slice(memory_cptr const &parent,
+        size_t offset,
+        size_t size) {
+    return slice(std::static_pointer_cast<void>(parent), parent->get_buffer() + offset, size);
+  }
+
 private:
+  static size_t const s_max_inline_size = 128;
+
   struct counter {
     unsigned char *ptr;
     size_t size;
-    bool is_free;
+    bool is_free, has_inline_storage;
     unsigned count;
     size_t offset;
+    std::shared_ptr<void> owner;
 
     counter(unsigned char *p = nullptr,
             size_t s = 0,
@@ -214,9 +258,45 @@ private:
       : ptr(p)
       , size(s)
       , is_free(f)
+      , has_inline_storage(false)
       , count(c)
       , offset(0)
     { }
+
+    unsigned char *inline_storage() {
+      return reinterpret_cast<unsigned char *>(this + 1);
+    }
+
+    bool holds_inline_data() {
+      return has_inline_storage && (ptr == inline_storage());
+    }
+
+    static counter *
+    create_with_inline_data(void const *buffer,
+                            size_t size) {
+      auto c                = new (safemalloc(sizeof(counter) + size)) counter(nullptr, size, false);
+      c->ptr                = c->inline_storage();
+      c->has_inline_storage = true;
+
+      if (size)
+        std::memcpy(c->ptr, buffer, size);
+
+      return c;
+    }
+
+    static void
+    destroy(counter *c) {
+      if (c->is_free)
+        free(c->ptr);
+
+      if (!c->has_inline_storage) {
+        delete c;
+        return;
+      }
+
+      c->~counter();
+      free(c);
+    }
   } *its_counter;
 
   void acquire(counter *c) throw() { // increment the count
@@ -227,11 +307,8 @@ private:
 
   void release() { // decrement the count, delete if it is 0
     if (its_counter) {
-      if (--its_counter->count == 0) {
-        if (its_counter->is_free)
-          free(its_counter->ptr);
-        delete its_counter;
-      }
+      if (--its_counter->count == 0)
+        counter::destroy(its_counter);
       its_counter = 0;
     }
   }
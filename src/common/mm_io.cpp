@@ -20,6 +20,7 @@
 #ifdef HAVE_UNISTD_H
 #include <unistd.h>
 #endif
+#include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 
@@ -31,6 +32,10 @@
 #include "common/strings/editing.h"
 #include "common/strings/parsing.h"
 
+#if defined(__SSE2__)
+# include <emmintrin.h>
+#endif
+
 union double_to_uint64_t {
   uint64_t i;
   double d;
@@ -41,6 +46,11 @@ mm_file_io_c::mm_file_io_c(const std::string &path,
                            const open_mode mode)
   : m_file_name(path)
   , m_file(nullptr)
+  , m_drop_from_page_cache(false)
+  , m_writing((MODE_WRITE == mode) || (MODE_CREATE == mode))
+  , m_page_cache_drop_start(0)
+  , m_page_cache_writeback_start(0)
+  , m_page_cache_writeback_end(0)
 {
   const char *cmode;
 
@@ -73,6 +83,13 @@ mm_file_io_c::mm_file_io_c(const std::string &path,
 
   if (!m_file)
     throw mtx::mm_io::open_x{mtx::mm_io::make_error_code()};
+
+#if defined(HAVE_POSIX_FADVISE)
+  m_drop_from_page_cache = m_writing ? ms_drop_written_data_from_page_cache : ms_drop_read_data_from_page_cache;
+
+  if (m_drop_from_page_cache && !m_writing)
+    posix_fadvise(fileno((FILE *)m_file), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
 }
 
 void
@@ -82,10 +99,14 @@ mm_file_io_c::setFilePointer(int64 offset,
              : mode == seek_end       ? SEEK_END
              :                          SEEK_CUR;
 
+  if (m_drop_from_page_cache)
+    drop_from_page_cache(1024 * 1024);
+
   if (fseeko((FILE *)m_file, offset, whence) != 0)
     throw mtx::mm_io::seek_x{mtx::mm_io::make_error_code()};
 
-  m_current_position = ftello((FILE *)m_file);
+  m_current_position      = ftello((FILE *)m_file);
+  m_page_cache_drop_start = m_current_position;
 }
 
 size_t
@@ -98,6 +119,9 @@ mm_file_io_c::_write(const void *buffer,
   m_current_position += bwritten;
   m_cached_size       = -1;
 
+  if (m_drop_from_page_cache)
+    drop_from_page_cache(8 * 1024 * 1024);
+
   return bwritten;
 }
 
@@ -108,12 +132,83 @@ mm_file_io_c::_read(void *buffer,
 
   m_current_position += bread;
 
+  if (m_drop_from_page_cache && !m_writing)
+    drop_from_page_cache(1024 * 1024);
+
   return bread;
 }
 
+void
+mm_file_io_c::drop_from_page_cache(int64_t min_size) {
+#if defined(HAVE_POSIX_FADVISE)
+  auto start = m_page_cache_drop_start;
+  auto size  = m_current_position - start;
+
+  if ((0 >= size) || (size < min_size))
+    return;
+
+  m_page_cache_drop_start = m_current_position;
+  auto fd                 = fileno((FILE *)m_file);
+
+  if (!m_writing) {
+    posix_fadvise(fd, start, size, POSIX_FADV_DONTNEED);
+    return;
+  }
+
+  // Dirty pages cannot be dropped. Therefore writeback is started for
+  // the range written since the last call, and the range started the
+  // last time is waited for and dropped afterwards. This way the
+  // amount of dirty data stays low without having to wait for each
+  // write to finish.
+  fflush((FILE *)m_file);
+
+# if defined(HAVE_SYNC_FILE_RANGE)
+  sync_file_range(fd, start, size, SYNC_FILE_RANGE_WRITE);
+
+  if (m_page_cache_writeback_end > m_page_cache_writeback_start) {
+    auto writeback_size = m_page_cache_writeback_end - m_page_cache_writeback_start;
+
+    sync_file_range(fd, m_page_cache_writeback_start, writeback_size, SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+    posix_fadvise(fd, m_page_cache_writeback_start, writeback_size, POSIX_FADV_DONTNEED);
+  }
+
+  m_page_cache_writeback_start = start;
+  m_page_cache_writeback_end   = start + size;
+
+# else
+  posix_fadvise(fd, start, size, POSIX_FADV_DONTNEED);
+# endif
+
+#else
+  (void)min_size;
+#endif
+}
+
+void
+mm_file_io_c::finish_dropping_from_page_cache() {
+#if defined(HAVE_POSIX_FADVISE)
+  drop_from_page_cache(0);
+
+  if (!m_writing)
+    return;
+
+  // Waits for everything written so far, including ranges that have
+  // been overwritten after seeking, e.g. the updated headers.
+  auto fd = fileno((FILE *)m_file);
+
+# if defined(HAVE_SYNC_FILE_RANGE)
+  sync_file_range(fd, 0, 0, SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+# endif
+  posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+}
+
 void
 mm_file_io_c::close() {
   if (m_file) {
+    if (m_drop_from_page_cache)
+      finish_dropping_from_page_cache();
+
     fclose((FILE *)m_file);
     m_file = nullptr;
   }
@@ -143,6 +238,16 @@ mm_file_io_c::setup() {
 
 #endif // !defined(SYS_WINDOWS)
 
+bool mm_file_io_c::ms_drop_read_data_from_page_cache    = false;
+bool mm_file_io_c::ms_drop_written_data_from_page_cache = false;
+
+void
+mm_file_io_c::set_drop_from_page_cache(bool drop_read_data,
+                                       bool drop_written_data) {
+  ms_drop_read_data_from_page_cache    = drop_read_data;
+  ms_drop_written_data_from_page_cache = drop_written_data;
+}
+
 void
 mm_file_io_c::prepare_path(const std::string &path) {
   boost::filesystem::path directory = boost::filesystem::path(path).parent_path();
@@ -887,6 +992,43 @@ mm_mem_io_c::get_content()
    Class for handling UTF-8/UTF-16/UTF-32 text files.
 */
 
+namespace {
+
+// Returns the offset of the first carriage return, newline or, if
+// stop_at_non_ascii is set, byte with the highest bit set.
+std::size_t
+find_line_end_or_special(unsigned char const *buffer,
+                         std::size_t size,
+                         bool stop_at_non_ascii) {
+  std::size_t pos = 0;
+
+#if defined(__SSE2__)
+  auto const carriage_returns = _mm_set1_epi8('\r');
+  auto const newlines         = _mm_set1_epi8('\n');
+
+  for (; (pos + 16) <= size; pos += 16) {
+    auto chunk = _mm_loadu_si128(reinterpret_cast<__m128i const *>(&buffer[pos]));
+    auto mask  = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, carriage_returns), _mm_cmpeq_epi8(chunk, newlines)));
+
+    if (stop_at_non_ascii)
+      mask |= _mm_movemask_epi8(chunk);
+
+    if (mask)
+      return pos + __builtin_ctz(mask);
+  }
+#endif
+
+  for (; pos < size; ++pos)
+    if (   ('\r' == buffer[pos])
+        || ('\n' == buffer[pos])
+        || (stop_at_non_ascii && (buffer[pos] & 0x80)))
+      return pos;
+
+  return size;
+}
+
+}
+
 mm_text_io_c::mm_text_io_c(mm_io_c *in,
                            bool delete_in)
   : mm_proxy_io_c(in, delete_in)
@@ -1078,6 +1220,9 @@ mm_text_io_c::getline(boost::optional<std::size_t> max_chars) {
   if (!m_eol_style_detected)
     detect_eol_style();
 
+  if (!max_chars && ((BO_NONE == m_byte_order) || (BO_UTF8 == m_byte_order)))
+    return getline_from_blocks();
+
   std::string s;
   char utf8char[9];
   bool previous_was_carriage_return = false;
@@ -1117,6 +1262,107 @@ mm_text_io_c::getline(boost::optional<std::size_t> max_chars) {
   }
 }
 
+// Same as getline() for byte-oriented encodings, but reads whole
+// blocks and searches them for the end of the line instead of reading
+// one character at a time. Afterwards the file pointer is positioned
+// right behind the line just as if it had been read character by
+// character.
+std::string
+mm_text_io_c::getline_from_blocks() {
+  static std::size_t const s_min_block_size = 256;
+  static std::size_t const s_max_block_size = 64 * 1024;
+
+  auto is_utf8                      = BO_UTF8 == m_byte_order;
+  auto previous_was_carriage_return = false;
+  auto block_size                   = std::max(m_line_block.size(), s_min_block_size);
+  std::string s;
+
+  while (true) {
+    m_line_block.resize(block_size);
+
+    auto block_start = getFilePointer();
+    auto buffer      = m_line_block.data();
+    auto num_read    = static_cast<std::size_t>(read(buffer, block_size));
+    auto at_end      = num_read < block_size;
+    auto pos         = std::size_t{};
+    auto copy_from   = std::size_t{};
+
+    // Seeking even if the whole block has been used up resets the
+    // end-of-file flag the same way reading character by character
+    // would have left it.
+    auto finish_line = [this, &s, buffer, &copy_from, block_start](std::size_t line_end, std::size_t continue_at) -> std::string {
+      s.append(reinterpret_cast<char const *>(&buffer[copy_from]), line_end - copy_from);
+      mm_proxy_io_c::setFilePointer(block_start + continue_at, seek_beginning);
+      return std::move(s);
+    };
+
+    while (pos < num_read) {
+      if (!previous_was_carriage_return) {
+        pos += find_line_end_or_special(&buffer[pos], num_read - pos, is_utf8);
+        if (pos >= num_read)
+          break;
+      }
+
+      auto c    = buffer[pos];
+      auto size = 1u;
+
+      if (is_utf8 && (c & 0x80)) {
+        size = ((c & 0xe0) == 0xc0) ? 2u
+             : ((c & 0xf0) == 0xe0) ? 3u
+             : ((c & 0xf8) == 0xf0) ? 4u
+             : ((c & 0xfc) == 0xf8) ? 5u
+             : ((c & 0xfe) == 0xfc) ? 6u
+             :                        0u;
+
+        if (!size)
+          throw mtx::mm_io::text::invalid_utf8_char_x(c);
+
+        if ((pos + size) > num_read) {
+          // Incomplete character at the end of the file: drop it just
+          // like read_next_char() does.
+          if (at_end) {
+            s.append(reinterpret_cast<char const *>(&buffer[copy_from]), pos - copy_from);
+            return s;
+          }
+
+          // Otherwise continue with the next block starting at this
+          // character.
+          break;
+        }
+      }
+
+      if ('\r' == c) {
+        if (previous_was_carriage_return && !m_uses_newlines)
+          return finish_line(pos, pos);
+
+        s.append(reinterpret_cast<char const *>(&buffer[copy_from]), pos - copy_from);
+        previous_was_carriage_return = true;
+        copy_from                    = ++pos;
+        continue;
+      }
+
+      if (('\n' == c) && (!m_uses_carriage_returns || previous_was_carriage_return))
+        return finish_line(pos, pos + 1);
+
+      if (previous_was_carriage_return)
+        return finish_line(pos, pos);
+
+      pos += size;
+    }
+
+    s.append(reinterpret_cast<char const *>(&buffer[copy_from]), pos - copy_from);
+
+    if (at_end)
+      return s;
+
+    if (pos < num_read)
+      mm_proxy_io_c::setFilePointer(block_start + pos, seek_beginning);
+
+    // A long line. Continue with larger blocks.
+    block_size = std::min(block_size * 2, s_max_block_size);
+  }
+}
+
 void
 mm_text_io_c::setFilePointer(int64 offset,
                              seek_mode mode) {
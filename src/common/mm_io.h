@@ -114,6 +114,11 @@ public:
   virtual void enable_buffering(bool /* enable */) {
   }
 
+  // Releases file handles and buffers until the next read. Only
+  // implemented by classes able to reopen their files.
+  virtual void suspend() {
+  }
+
 protected:
   virtual uint32 _read(void *buffer, size_t size) = 0;
   virtual size_t _write(const void *buffer, size_t size) = 0;
@@ -124,6 +129,14 @@ protected:
   std::string m_file_name;
   void *m_file;
 
+  // Dropping data from the page cache once it has been read or
+  // written: the start of the range not handed to the kernel yet and
+  // the range whose writeback was started the last time.
+  bool m_drop_from_page_cache, m_writing;
+  int64_t m_page_cache_drop_start, m_page_cache_writeback_start, m_page_cache_writeback_end;
+
+  static bool ms_drop_read_data_from_page_cache, ms_drop_written_data_from_page_cache;
+
 #if defined(SYS_WINDOWS)
   bool m_eof;
 #endif
@@ -154,9 +167,18 @@ public:
   static void cleanup();
   static mm_io_cptr open(const std::string &path, const open_mode mode = MODE_READ);
 
+  // Lets files opened afterwards tell the operating system that data
+  // read from or written to them won't be needed again so that it
+  // doesn't push other data out of the page cache. Only has an effect
+  // on systems supporting posix_fadvise().
+  static void set_drop_from_page_cache(bool drop_read_data, bool drop_written_data);
+
 protected:
   virtual uint32 _read(void *buffer, size_t size);
   virtual size_t _write(const void *buffer, size_t size);
+
+  void drop_from_page_cache(int64_t min_size);
+  void finish_dropping_from_page_cache();
 };
 
 using mm_file_io_cptr = std::shared_ptr<mm_file_io_c>;
@@ -195,6 +217,10 @@ public:
   virtual mm_io_c *get_proxied() const {
     return m_proxy_io;
   }
+  virtual void suspend() {
+    if (m_proxy_io)
+      m_proxy_io->suspend();
+  }
 
 protected:
   virtual uint32 _read(void *buffer, size_t size);
@@ -267,6 +293,7 @@ protected:
   byte_order_e m_byte_order;
   unsigned int m_bom_len;
   bool m_uses_carriage_returns, m_uses_newlines, m_eol_style_detected;
+  std::vector<unsigned char> m_line_block;
 
 public:
   mm_text_io_c(mm_io_c *in, bool delete_in = true);
@@ -289,6 +316,7 @@ public:
 
 protected:
   virtual void detect_eol_style();
+  std::string getline_from_blocks();
 
 public:
   static bool has_byte_order_marker(const std::string &string);
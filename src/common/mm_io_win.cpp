@@ -38,6 +38,11 @@ mm_file_io_c::mm_file_io_c(const std::string &path,
                            const open_mode mode)
   : m_file_name(path)
   , m_file(nullptr)
+  , m_drop_from_page_cache(false)
+  , m_writing(false)
+  , m_page_cache_drop_start(0)
+  , m_page_cache_writeback_start(0)
+  , m_page_cache_writeback_end(0)
   , m_eof(false)
 {
   DWORD access_mode, share_mode, disposition;
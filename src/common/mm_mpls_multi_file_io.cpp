@@ -13,7 +13,7 @@ debugging_option_c mm_mpls_multi_file_io_c::ms_debug{"mpls|mpls_multi_io"};
 mm_mpls_multi_file_io_c::mm_mpls_multi_file_io_c(std::vector<bfs::path> const &file_names,
                                                  std::string const &display_file_name,
                                                  mtx::bluray::mpls::parser_cptr const &mpls_parser)
-  : mm_file_io_c{file_names[0].string()}
+  : mm_reopenable_io_c{[file_name = file_names[0].string()]() { return new mm_file_io_c{file_name}; }}
   , m_files{file_names}
   , m_display_file_name{display_file_name}
   , m_mpls_parser{mpls_parser}
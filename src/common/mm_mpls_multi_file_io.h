@@ -18,9 +18,10 @@
 
 #include "common/mm_mpls_multi_file_io_fwd.h"
 #include "common/mm_multi_file_io.h"
+#include "common/mm_reopenable_io.h"
 #include "common/mpls.h"
 
-class mm_mpls_multi_file_io_c: public mm_file_io_c {
+class mm_mpls_multi_file_io_c: public mm_reopenable_io_c {
 protected:
   std::vector<bfs::path> m_files;
   std::string m_display_file_name;
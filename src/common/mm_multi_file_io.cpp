@@ -18,13 +18,14 @@
 #include "common/id_info.h"
 #include "common/mm_io_x.h"
 #include "common/mm_multi_file_io.h"
+#include "common/mm_reopenable_io.h"
 #include "common/output.h"
 #include "common/strings/editing.h"
 #include "common/strings/parsing.h"
 
 mm_multi_file_io_c::file_t::file_t(const bfs::path &file_name,
                                    uint64_t global_start,
-                                   mm_file_io_cptr file)
+                                   mm_io_cptr file)
   : m_file_name(file_name)
   , m_size(file->get_size())
   , m_global_start(global_start)
@@ -40,11 +41,17 @@ mm_multi_file_io_c::mm_multi_file_io_c(const std::vector<bfs::path> &file_names,
   , m_current_local_pos(0)
   , m_current_file(0)
 {
+  // Only the file currently being read from is kept open so that
+  // long sequences of files don't exhaust the available file handles.
   for (auto &file_name : file_names) {
-    mm_file_io_cptr file(new mm_file_io_c(file_name.string()));
+    auto name = file_name.string();
+    mm_io_cptr file(new mm_reopenable_io_c([name]() { return new mm_file_io_c(name); }));
     m_files.push_back(mm_multi_file_io_c::file_t(file_name, m_total_size, file));
 
     m_total_size += file->get_size();
+
+    if (1 < m_files.size())
+      file->suspend();
   }
 }
 
@@ -68,6 +75,8 @@ mm_multi_file_io_c::setFilePointer(int64 offset,
   if ((0 > new_pos) || (static_cast<int64_t>(m_total_size) < new_pos))
     throw mtx::mm_io::seek_x();
 
+  auto previous_file = m_current_file;
+
   m_current_file = 0;
   for (auto &file : m_files) {
     if ((file.m_global_start + file.m_size) < static_cast<uint64_t>(new_pos)) {
@@ -80,6 +89,9 @@ mm_multi_file_io_c::setFilePointer(int64 offset,
     file.m_file->setFilePointer(m_current_local_pos, seek_beginning);
     break;
   }
+
+  if ((previous_file != m_current_file) && (previous_file < m_files.size()))
+    m_files[previous_file].m_file->suspend();
 }
 
 uint32
@@ -104,6 +116,7 @@ mm_multi_file_io_c::_read(void *buffer,
     }
 
     if ((m_current_local_pos >= file.m_size) && (m_files.size() > (m_current_file + 1))) {
+      file.m_file->suspend();
       ++m_current_file;
       m_current_local_pos = 0;
       m_files[m_current_file].m_file->setFilePointer(0, seek_beginning);
@@ -175,6 +188,12 @@ mm_multi_file_io_c::enable_buffering(bool enable) {
     file.m_file->enable_buffering(enable);
 }
 
+void
+mm_multi_file_io_c::suspend() {
+  if (m_current_file < m_files.size())
+    m_files[m_current_file].m_file->suspend();
+}
+
 struct path_sorter_t {
   bfs::path m_path;
   int m_number;
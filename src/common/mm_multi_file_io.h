@@ -30,9 +30,9 @@ protected:
   struct file_t {
     bfs::path m_file_name;
     uint64_t m_size, m_global_start;
-    mm_file_io_cptr m_file;
+    mm_io_cptr m_file;
 
-    file_t(const bfs::path &file_name, uint64_t global_start, mm_file_io_cptr file);
+    file_t(const bfs::path &file_name, uint64_t global_start, mm_io_cptr file);
   };
 
 protected:
@@ -57,6 +57,7 @@ public:
   virtual void create_verbose_identification_info(mtx::id::info_c &info);
   virtual void display_other_file_info();
   virtual void enable_buffering(bool enable);
+  virtual void suspend();
 
   static mm_io_cptr open_multi(const std::string &display_file_name, bool single_only = false);
 
@@ -137,6 +137,11 @@ mm_read_buffer_io_c::_read(void *buffer,
         break;
       }
 
+      if (!m_af_buffer) {
+        m_af_buffer = memory_c::alloc(m_size);
+        m_buffer    = m_af_buffer->get_buffer();
+      }
+
       int64_t previous_pos = m_proxy_io->getFilePointer();
 
       m_fill = m_proxy_io->read(m_buffer, avail);
@@ -168,3 +173,20 @@ mm_read_buffer_io_c::enable_buffering(bool enable) {
     m_fill   = 0;
   }
 }
+
+void
+mm_read_buffer_io_c::suspend() {
+  if (m_buffering && m_proxy_io) {
+    // Position the underlying file where reading will continue and
+    // free the buffer; _read() allocates a new one.
+    m_offset += m_cursor;
+    m_cursor  = 0;
+    m_fill    = 0;
+    m_proxy_io->setFilePointer(m_offset, seek_beginning);
+
+    m_af_buffer.reset();
+    m_buffer = nullptr;
+  }
+
+  mm_proxy_io_c::suspend();
+}
@@ -41,6 +41,7 @@ public:
   inline virtual bool eof() { return m_eof; }
   virtual void clear_eof() { m_eof = false; }
   virtual void enable_buffering(bool enable);
+  virtual void suspend();
 
 protected:
   virtual uint32 _read(void *buffer, size_t size);
@@ -0,0 +1,134 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   IO callback class for files that are closed while not needed
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "common/mm_io_x.h"
+#include "common/mm_reopenable_io.h"
+
+mm_reopenable_io_c::mm_reopenable_io_c(opener_t const &opener)
+  : m_opener{opener}
+  , m_io{m_opener()}
+  , m_file_name{m_io->get_file_name()}
+  , m_eof{}
+  , m_num_reopens{}
+{
+  m_cached_size = m_io->get_size();
+}
+
+mm_reopenable_io_c::~mm_reopenable_io_c() {
+  close();
+}
+
+mm_io_c &
+mm_reopenable_io_c::get_io() {
+  if (m_io)
+    return *m_io;
+
+  if (!m_opener)
+    throw mtx::mm_io::open_x{};
+
+  m_io.reset(m_opener());
+  m_io->setFilePointer(m_current_position, seek_beginning);
+  ++m_num_reopens;
+
+  return *m_io;
+}
+
+void
+mm_reopenable_io_c::suspend() {
+  if (!m_io)
+    return;
+
+  m_current_position = m_io->getFilePointer();
+  m_eof              = m_io->eof();
+  m_io.reset();
+}
+
+bool
+mm_reopenable_io_c::is_suspended()
+  const {
+  return !m_io;
+}
+
+unsigned int
+mm_reopenable_io_c::get_num_reopens()
+  const {
+  return m_num_reopens;
+}
+
+uint64
+mm_reopenable_io_c::getFilePointer() {
+  return m_io ? m_io->getFilePointer() : m_current_position;
+}
+
+void
+mm_reopenable_io_c::setFilePointer(int64 offset,
+                                   seek_mode mode) {
+  if (m_io) {
+    m_io->setFilePointer(offset, mode);
+    return;
+  }
+
+  int64_t new_pos
+    = seek_beginning == mode ? offset
+    : seek_end       == mode ? m_cached_size      + offset // offsets from the end are negative already
+    :                          m_current_position + offset;
+
+  if ((0 > new_pos) || (m_cached_size < new_pos))
+    throw mtx::mm_io::seek_x();
+
+  m_current_position = new_pos;
+  m_eof              = false;
+}
+
+bool
+mm_reopenable_io_c::eof() {
+  return m_io ? m_io->eof() : m_eof;
+}
+
+void
+mm_reopenable_io_c::clear_eof() {
+  if (m_io)
+    m_io->clear_eof();
+  m_eof = false;
+}
+
+int64_t
+mm_reopenable_io_c::get_size() {
+  return m_cached_size;
+}
+
+std::string
+mm_reopenable_io_c::get_file_name()
+  const {
+  return m_file_name;
+}
+
+void
+mm_reopenable_io_c::close() {
+  m_io.reset();
+  m_opener = nullptr;
+}
+
+uint32
+mm_reopenable_io_c::_read(void *buffer,
+                          size_t size) {
+  return get_io().read(buffer, size);
+}
+
+size_t
+mm_reopenable_io_c::_write(const void *,
+                           size_t) {
+  throw mtx::mm_io::wrong_read_write_access_x();
+}
@@ -0,0 +1,63 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   IO callback class for files that are closed while not needed
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_MM_REOPENABLE_IO_H
+#define MTX_COMMON_MM_REOPENABLE_IO_H
+
+#include "common/common_pch.h"
+
+#include "common/mm_io.h"
+
+/** \brief Read-only I/O on a file that can be closed and reopened transparently
+
+   The file is opened with the opener function right away. Calling
+   \c suspend() closes it while remembering the current position,
+   its size and its EOF state. The next read reopens the file and
+   seeks back to that position. Seeking while suspended only records
+   the new position.
+*/
+class mm_reopenable_io_c: public mm_io_c {
+public:
+  using opener_t = std::function<mm_io_c *()>;
+
+protected:
+  opener_t m_opener;
+  std::unique_ptr<mm_io_c> m_io;
+  std::string m_file_name;
+  bool m_eof;
+  unsigned int m_num_reopens;
+
+public:
+  mm_reopenable_io_c(opener_t const &opener);
+  virtual ~mm_reopenable_io_c();
+
+  virtual uint64 getFilePointer();
+  virtual void setFilePointer(int64 offset, seek_mode mode = seek_beginning);
+  virtual bool eof();
+  virtual void clear_eof();
+  virtual int64_t get_size();
+  virtual void close();
+  virtual std::string get_file_name() const;
+
+  virtual void suspend();
+  bool is_suspended() const;
+  unsigned int get_num_reopens() const;
+
+protected:
+  mm_io_c &get_io();
+
+  virtual uint32 _read(void *buffer, size_t size);
+  virtual size_t _write(const void *buffer, size_t size);
+};
+
+#endif  // MTX_COMMON_MM_REOPENABLE_IO_H
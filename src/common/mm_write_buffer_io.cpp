@@ -25,6 +25,7 @@ mm_write_buffer_io_c::mm_write_buffer_io_c(mm_io_c *out,
   , m_buffer(m_af_buffer->get_buffer())
   , m_fill(0)
   , m_size(buffer_size)
+  , m_direct_write_min_size(std::min<size_t>(buffer_size, 256 * 1024))
   , m_debug_seek{ "write_buffer_io|write_buffer_io_read"}
   , m_debug_write{"write_buffer_io|write_buffer_io_write"}
 {
@@ -92,6 +93,24 @@ mm_write_buffer_io_c::_write(const void *buffer,
   const char *buf = static_cast<const char *>(buffer);
   size_t remain   = size;
 
+  // Large chunks, e.g. video frames rendered by libmatroska, are
+  // written straight from the caller's memory after the content
+  // buffered so far instead of being copied into the buffer first.
+  if (size >= m_direct_write_min_size) {
+    flush_buffer();
+
+    auto written = mm_proxy_io_c::_write(buf, size);
+
+    mxdebug_if(m_debug_write, boost::format("_write() direct at %1% for %2% written %3%\n") % (mm_proxy_io_c::getFilePointer() - written) % size % written);
+
+    if (written != size)
+      throw mtx::mm_io::insufficient_space_x();
+
+    m_cached_size = -1;
+
+    return size;
+  }
+
   // whole blocks
   while (remain >= (avail = m_size - m_fill)) {
     if (m_fill) {
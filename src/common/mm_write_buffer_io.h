@@ -24,7 +24,7 @@ protected:
   memory_cptr m_af_buffer;
   unsigned char *m_buffer;
   size_t m_fill;
-  const size_t m_size;
+  const size_t m_size, m_direct_write_min_size;
   debugging_option_c m_debug_seek, m_debug_write;
 
 public:
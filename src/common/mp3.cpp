@@ -12,7 +12,9 @@
 */
 
 #include "common/common_pch.h"
+#include "common/endian.h"
 #include "common/mp3.h"
+#include "common/sync_word_searcher.h"
 
 // Synch word for a frame is 0xFFE0 (first 11 bits must be set)
 // Frame valuable information (for parsing) are stored in the first 4 bytes :
@@ -139,13 +141,20 @@ static int mp3_samples_per_channel[3][3] = {
 int
 find_mp3_header(const unsigned char *buf,
                 int size) {
-  int i, pos;
+  static auto const s_searcher = mtx::sync_word_searcher_c{
+    { 0x494433, 0xffffff, 3 }, // "ID3"
+    { 0x544147, 0xffffff, 3 }, // "TAG"
+    { 0xffe0,   0xffe0,   2 }, // frame sync: first eleven bits set
+  };
+
   unsigned long header;
 
   if (size < 4)
     return -1;
 
-  for (pos = 0; pos < (size - 4); pos++) {
+  for (auto candidate = s_searcher.find(buf, size, 0, size - 4); std::string::npos != candidate; candidate = s_searcher.find(buf, size, candidate + 1, size - 4)) {
+    int pos = candidate;
+
     if ((buf[pos] == 'I') && (buf[pos + 1] == 'D') && (buf[pos + 2] == '3')) {
       if ((pos + 10) >= size)
         return -1;
@@ -155,16 +164,8 @@ find_mp3_header(const unsigned char *buf,
     if ((buf[pos] == 'T') && (buf[pos + 1] == 'A') && (buf[pos + 2] == 'G'))
       return pos;
 
-    for (i = 0, header = 0; i < 4; i++) {
-      header <<= 8;
-      header |= buf[i + pos];
-    }
-
-    if (header == FOURCC('R', 'I', 'F', 'F'))
-      continue;
+    header = get_uint32_be(&buf[pos]);
 
-    if ((header & 0xffe00000) != 0xffe00000)
-      continue;
     if (((header >> 17) & 3) == 0)
       continue;
     if (((header >> 12) & 0xf) == 0xf)
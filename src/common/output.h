@@ -23,6 +23,7 @@
 #include "common/json.h"
 #include "common/locale.h"
 #include "common/mm_io.h"
+#include "common/strings/fast_format.h"
 
 using namespace libebml;
 
@@ -54,6 +55,9 @@ void mxinfo(const std::string &info);
 inline void mxinfo(const boost::format &info) {
   mxinfo(info.str());
 }
+inline void mxinfo(fast_format_c const &info) {
+  mxinfo(info.str());
+}
 inline void mxinfo(char const *info) {
   mxinfo(std::string{info});
 }
@@ -0,0 +1,83 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   helper functions for running independent work items concurrently
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "common/parallel.h"
+
+namespace mtx { namespace parallel {
+
+unsigned int
+default_num_threads() {
+  return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+void
+for_each_index(std::size_t num_items,
+               std::function<void(std::size_t)> const &worker,
+               unsigned int num_threads) {
+  if (!num_threads)
+    num_threads = default_num_threads();
+
+  num_threads = std::min<std::size_t>(num_threads, num_items);
+
+  if (num_threads <= 1) {
+    for (std::size_t idx = 0; idx < num_items; ++idx)
+      worker(idx);
+    return;
+  }
+
+  std::atomic<std::size_t> next_idx{0};
+  std::atomic<bool> failed{false};
+  std::exception_ptr first_exception;
+  std::mutex exception_mutex;
+
+  auto run = [&]() {
+    while (!failed) {
+      auto idx = next_idx++;
+      if (idx >= num_items)
+        return;
+
+      try {
+        worker(idx);
+
+      } catch (...) {
+        std::lock_guard<std::mutex> lock{exception_mutex};
+        if (!first_exception)
+          first_exception = std::current_exception();
+        failed = true;
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads - 1);
+
+  for (auto thread_idx = 1u; thread_idx < num_threads; ++thread_idx)
+    threads.emplace_back(run);
+
+  run();
+
+  for (auto &thread : threads)
+    thread.join();
+
+  if (first_exception)
+    std::rethrow_exception(first_exception);
+}
+
+}}
@@ -0,0 +1,35 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   helper functions for running independent work items concurrently
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_PARALLEL_H
+#define MTX_COMMON_PARALLEL_H
+
+#include "common/common_pch.h"
+
+namespace mtx { namespace parallel {
+
+// The number of worker threads used if the caller doesn't request a
+// specific number: the number of hardware threads, at least one.
+unsigned int default_num_threads();
+
+// Calls worker(idx) for each idx in [0, num_items) using up to
+// num_threads threads (0 = default_num_threads()). Items are handed
+// out in ascending order; the order in which they finish is
+// unspecified. If a worker throws then no further items are started,
+// and the first exception is re-thrown in the calling thread after
+// all threads have finished.
+void for_each_index(std::size_t num_items, std::function<void(std::size_t)> const &worker, unsigned int num_threads = 0);
+
+}}
+
+#endif  // MTX_COMMON_PARALLEL_H
@@ -0,0 +1,258 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   a faster replacement for boost::format on frequently used paths
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include <cstdio>
+
+#include "common/strings/fast_format.h"
+
+namespace {
+
+bool
+parse_number(std::string const &format,
+             std::size_t &pos,
+             int &number) {
+  auto start = pos;
+  number     = 0;
+
+  while ((pos < format.size()) && isdigit(static_cast<unsigned char>(format[pos]))) {
+    number = number * 10 + (format[pos] - '0');
+    ++pos;
+  }
+
+  return pos != start;
+}
+
+void
+append_unsigned(std::string &out,
+                uint64_t value,
+                bool hex,
+                bool upper_case) {
+  char buffer[24];
+  auto end    = buffer + sizeof(buffer);
+  auto ptr    = end;
+  auto digits = upper_case ? "0123456789ABCDEF" : "0123456789abcdef";
+  auto base   = hex ? 16u : 10u;
+
+  do {
+    *--ptr  = digits[value % base];
+    value  /= base;
+  } while (value);
+
+  out.append(ptr, end);
+}
+
+}
+
+fast_format_c::fast_format_c(std::string const &format) {
+  if (!parse(format))
+    m_fallback = std::make_shared<boost::format>(format);
+}
+
+bool
+fast_format_c::parse(std::string const &format) {
+  auto text = std::string{};
+  auto pos  = std::size_t{};
+
+  while (pos < format.size()) {
+    auto percent = format.find('%', pos);
+    if (std::string::npos == percent) {
+      text.append(format, pos, std::string::npos);
+      break;
+    }
+
+    text.append(format, pos, percent - pos);
+    pos = percent + 1;
+
+    if (pos >= format.size())
+      return false;
+
+    if ('%' == format[pos]) {
+      text += '%';
+      ++pos;
+      continue;
+    }
+
+    auto directive = directive_t{};
+    auto number    = 0;
+
+    if ('|' == format[pos]) {
+      // "%|N$[flags][width][.precision][conversion]|"
+      ++pos;
+      if (!parse_number(format, pos, number) || !number || (pos >= format.size()) || ('$' != format[pos]))
+        return false;
+      ++pos;
+
+      while ((pos < format.size()) && (('0' == format[pos]) || ('-' == format[pos]))) {
+        if ('-' == format[pos])
+          directive.m_left_align = true;
+        else
+          directive.m_fill       = '0';
+        ++pos;
+      }
+
+      parse_number(format, pos, directive.m_width);
+
+      if ((pos < format.size()) && ('.' == format[pos])) {
+        ++pos;
+        if (!parse_number(format, pos, directive.m_precision))
+          return false;
+      }
+
+      if ((pos < format.size()) && std::string{"diuxXfs"}.find(format[pos]) != std::string::npos)
+        directive.m_conversion = format[pos++];
+
+      if ((pos >= format.size()) || ('|' != format[pos]))
+        return false;
+      ++pos;
+
+      // boost::format truncates strings to the precision; not worth
+      // implementing for the few places using it.
+      if (('s' == directive.m_conversion) && (-1 != directive.m_precision))
+        return false;
+
+      if (directive.m_left_align)
+        directive.m_fill = ' ';
+
+    } else {
+      // "%N%"
+      if (!parse_number(format, pos, number) || !number || (pos >= format.size()) || ('%' != format[pos]))
+        return false;
+      ++pos;
+    }
+
+    directive.m_text         = std::move(text);
+    directive.m_argument_idx = number - 1;
+    text.clear();
+
+    m_directives.push_back(std::move(directive));
+    m_num_arguments = std::max<std::size_t>(m_num_arguments, number);
+  }
+
+  if (!text.empty()) {
+    m_directives.emplace_back();
+    m_directives.back().m_text = std::move(text);
+  }
+
+  return true;
+}
+
+void
+fast_format_c::set_argument(argument_t &argument,
+                            bool value) {
+  // Streams output booleans as numbers unless told otherwise.
+  argument.m_type     = argument_t::type_e::unsigned_integer;
+  argument.m_unsigned = value ? 1 : 0;
+}
+
+void
+fast_format_c::set_argument(argument_t &argument,
+                            char value) {
+  argument.m_type   = argument_t::type_e::character;
+  argument.m_string = std::string(1, value);
+}
+
+void
+fast_format_c::set_argument(argument_t &argument,
+                            signed char value) {
+  set_argument(argument, static_cast<char>(value));
+}
+
+void
+fast_format_c::set_argument(argument_t &argument,
+                            unsigned char value) {
+  set_argument(argument, static_cast<char>(value));
+}
+
+void
+fast_format_c::render_argument(std::string &out,
+                               directive_t const &directive,
+                               argument_t const &argument)
+  const {
+  auto start       = out.size();
+  auto conversion  = directive.m_conversion;
+  auto hex         = ('x' == conversion) || ('X' == conversion);
+  auto is_negative = false;
+  auto is_numeric  = true;
+
+  if (argument_t::type_e::signed_integer == argument.m_type) {
+    if (hex) {
+      // Negative values are output as their two's complement of the
+      // original type's size, just like streams do.
+      auto mask = argument.m_size < sizeof(uint64_t) ? (uint64_t{1} << (argument.m_size * 8)) - 1 : ~uint64_t{};
+      append_unsigned(out, static_cast<uint64_t>(argument.m_signed) & mask, true, 'X' == conversion);
+
+    } else {
+      is_negative = argument.m_signed < 0;
+      if (is_negative)
+        out += '-';
+      append_unsigned(out, is_negative ? (~static_cast<uint64_t>(argument.m_signed) + 1) : static_cast<uint64_t>(argument.m_signed), false, false);
+    }
+
+  } else if (argument_t::type_e::unsigned_integer == argument.m_type)
+    append_unsigned(out, argument.m_unsigned, hex, 'X' == conversion);
+
+  else if (argument_t::type_e::floating_point == argument.m_type) {
+    char buffer[512];
+    auto precision = -1 != directive.m_precision ? directive.m_precision : 6;
+    auto length    = std::snprintf(buffer, sizeof(buffer), 'f' == conversion ? "%.*f" : "%.*g", precision, argument.m_double);
+
+    if ((0 > length) || (static_cast<std::size_t>(length) >= sizeof(buffer)))
+      out += (boost::format(std::string{"%|1$."} + std::to_string(precision) + ('f' == conversion ? "f|" : "|")) % argument.m_double).str();
+    else
+      out.append(buffer, length);
+
+    is_negative = '-' == out[start];
+
+  } else {
+    out        += argument.m_string;
+    is_numeric  = false;
+  }
+
+  auto length = out.size() - start;
+  if (static_cast<std::size_t>(directive.m_width) <= length)
+    return;
+
+  auto padding = directive.m_width - length;
+
+  if (directive.m_left_align)
+    out.append(padding, ' ');
+
+  else if (is_numeric && ('0' == directive.m_fill))
+    // Zeros go between the sign and the digits.
+    out.insert(start + (is_negative ? 1 : 0), padding, '0');
+
+  else
+    out.insert(start, padding, directive.m_fill);
+}
+
+std::string
+fast_format_c::str()
+  const {
+  if (m_fallback)
+    return m_fallback->str();
+
+  if (m_arguments.size() < m_num_arguments)
+    throw boost::io::too_few_args(m_arguments.size(), m_num_arguments);
+
+  auto out = std::string{};
+
+  for (auto const &directive : m_directives) {
+    out += directive.m_text;
+    if (-1 != directive.m_argument_idx)
+      render_argument(out, directive, m_arguments[directive.m_argument_idx]);
+  }
+
+  return out;
+}
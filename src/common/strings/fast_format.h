@@ -0,0 +1,165 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   a faster replacement for boost::format on frequently used paths
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_STRINGS_FAST_FORMAT_H
+#define MTX_COMMON_STRINGS_FAST_FORMAT_H
+
+#include "common/common_pch.h"
+
+#include <sstream>
+
+/** \brief A drop-in replacement for boost::format for frequently used formats
+
+   Understands the same format strings as boost::format so that the
+   existing translations can be used. The format string is parsed once
+   when the object is constructed instead of each time arguments are
+   fed. Arguments are converted directly without going through a
+   stream. The usual directives are supported: "%1%", "%%" and
+   "%|1$...|" with the flags '0' and '-', a width, a precision and the
+   conversions 'd', 'i', 'u', 'x', 'X', 'f' and 's'. Format strings using
+   anything else are handed over to boost::format transparently.
+
+   Like boost::format the object collects the arguments fed to it with
+   \c operator% and starts over once all arguments have been fed and
+   more are added. It is therefore neither thread-safe nor reentrant.
+*/
+class fast_format_c {
+public:
+  struct argument_t {
+    enum class type_e {
+      signed_integer,
+      unsigned_integer,
+      floating_point,
+      character,
+      string,
+    };
+
+    type_e m_type;
+    int64_t m_signed;
+    std::size_t m_size;                 // of signed integers for hex output
+    uint64_t m_unsigned;
+    double m_double;
+    std::string m_string;
+  };
+
+  struct directive_t {
+    std::string m_text;                 // literal text preceding the argument
+    int m_argument_idx{-1};             // -1 for trailing literal text
+    int m_width{}, m_precision{-1};
+    char m_conversion{}, m_fill{' '};
+    bool m_left_align{};
+  };
+
+protected:
+  std::vector<directive_t> m_directives;
+  std::vector<argument_t> m_arguments;
+  std::size_t m_num_arguments{};
+  std::shared_ptr<boost::format> m_fallback;
+
+public:
+  explicit fast_format_c(std::string const &format);
+
+  template<typename T>
+  fast_format_c &
+  operator %(T const &value) {
+    if (m_fallback) {
+      *m_fallback % value;
+      return *this;
+    }
+
+    if (m_arguments.size() == m_num_arguments)
+      m_arguments.clear();
+
+    m_arguments.emplace_back();
+    set_argument(m_arguments.back(), value);
+
+    if (m_arguments.size() > m_num_arguments)
+      throw boost::io::too_many_args(m_arguments.size(), m_num_arguments);
+
+    return *this;
+  }
+
+  std::string str() const;
+
+  std::size_t expected_args() const {
+    return m_fallback ? m_fallback->expected_args() : m_num_arguments;
+  }
+
+  bool uses_fallback() const {
+    return !!m_fallback;
+  }
+
+protected:
+  bool parse(std::string const &format);
+  void render_argument(std::string &out, directive_t const &directive, argument_t const &argument) const;
+
+  template<typename T>
+  static typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value && !std::is_same<T, char>::value && !std::is_same<T, signed char>::value>::type
+  set_argument(argument_t &argument,
+               T value) {
+    argument.m_type   = argument_t::type_e::signed_integer;
+    argument.m_signed = value;
+    argument.m_size   = sizeof(T);
+  }
+
+  template<typename T>
+  static typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value && !std::is_same<T, unsigned char>::value && !std::is_same<T, bool>::value>::type
+  set_argument(argument_t &argument,
+               T value) {
+    argument.m_type     = argument_t::type_e::unsigned_integer;
+    argument.m_unsigned = value;
+  }
+
+  template<typename T>
+  static typename std::enable_if<std::is_floating_point<T>::value>::type
+  set_argument(argument_t &argument,
+               T value) {
+    argument.m_type   = argument_t::type_e::floating_point;
+    argument.m_double = value;
+  }
+
+  template<typename T>
+  static typename std::enable_if<!std::is_arithmetic<T>::value && std::is_convertible<T const &, std::string>::value>::type
+  set_argument(argument_t &argument,
+               T const &value) {
+    argument.m_type   = argument_t::type_e::string;
+    argument.m_string = value;
+  }
+
+  // Everything else is output the same way boost::format does it:
+  // via its stream operator.
+  template<typename T>
+  static typename std::enable_if<!std::is_arithmetic<T>::value && !std::is_convertible<T const &, std::string>::value>::type
+  set_argument(argument_t &argument,
+               T const &value) {
+    std::ostringstream out;
+    out << value;
+
+    argument.m_type   = argument_t::type_e::string;
+    argument.m_string = out.str();
+  }
+
+  static void set_argument(argument_t &argument, bool value);
+  static void set_argument(argument_t &argument, char value);
+  static void set_argument(argument_t &argument, signed char value);
+  static void set_argument(argument_t &argument, unsigned char value);
+};
+
+inline std::ostream &
+operator <<(std::ostream &out,
+            fast_format_c const &format) {
+  out << format.str();
+  return out;
+}
+
+#endif  // MTX_COMMON_STRINGS_FAST_FORMAT_H
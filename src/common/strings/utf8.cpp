@@ -19,6 +19,9 @@
 #include "common/common_pch.h"
 
 #include <utf8.h>
+#if defined(__SSE2__)
+# include <emmintrin.h>
+#endif
 
 #include "common/strings/utf8.h"
 
@@ -40,6 +43,42 @@ to_utf8(const std::wstring &source) {
   return destination;
 }
 
+// Checks whether or not all bytes are 7-bit ASCII characters.
+bool
+is_ascii(char const *buffer,
+         std::size_t size) {
+  std::size_t pos = 0;
+
+#if defined(__SSE2__)
+  // SSE2 is part of the x86-64 base instruction set; no need for a
+  // run-time check.
+  for (; (pos + 64) <= size; pos += 64) {
+    auto chunk = _mm_or_si128(_mm_or_si128(_mm_loadu_si128(reinterpret_cast<__m128i const *>(&buffer[pos])),      _mm_loadu_si128(reinterpret_cast<__m128i const *>(&buffer[pos + 16]))),
+                              _mm_or_si128(_mm_loadu_si128(reinterpret_cast<__m128i const *>(&buffer[pos + 32])), _mm_loadu_si128(reinterpret_cast<__m128i const *>(&buffer[pos + 48]))));
+    if (_mm_movemask_epi8(chunk))
+      return false;
+  }
+
+  for (; (pos + 16) <= size; pos += 16)
+    if (_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const *>(&buffer[pos]))))
+      return false;
+
+#else
+  for (; (pos + 8) <= size; pos += 8) {
+    uint64_t word;
+    std::memcpy(&word, &buffer[pos], 8);
+    if (word & 0x8080808080808080ull)
+      return false;
+  }
+#endif
+
+  for (; pos < size; ++pos)
+    if (buffer[pos] & 0x80)
+      return false;
+
+  return true;
+}
+
 size_t
 get_width_in_em(const std::wstring &s) {
   size_t width = 0;
@@ -84,6 +84,13 @@ to_utf8(::libebml::UTFstring const &source) {
   return source.GetUTF8();
 }
 
+bool is_ascii(char const *buffer, std::size_t size);
+
+inline bool
+is_ascii(std::string const &source) {
+  return is_ascii(source.data(), source.size());
+}
+
 size_t get_width_in_em(wchar_t c);
 size_t get_width_in_em(const std::wstring &s);
 
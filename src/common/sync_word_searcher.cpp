@@ -0,0 +1,129 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   searching for sync words in elementary streams and container data
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#if defined(__SSE2__)
+# include <emmintrin.h>
+#endif
+
+#include "common/sync_word_searcher.h"
+
+namespace mtx {
+
+sync_word_searcher_c::sync_word_searcher_c(std::initializer_list<sync_word_t> sync_words)
+  : sync_word_searcher_c(std::vector<sync_word_t>(sync_words))
+{
+}
+
+sync_word_searcher_c::sync_word_searcher_c(std::vector<sync_word_t> const &sync_words)
+  : m_sync_words{sync_words}
+{
+  for (auto &sync_word : m_sync_words) {
+    assert((2 <= sync_word.m_size) && (4 >= sync_word.m_size));
+
+    // Values and masks are given for sync_word.m_size bytes; ignore
+    // anything beyond that.
+    auto all_bits        = sync_word.m_size == 4 ? 0xffffffffu : (1u << (sync_word.m_size * 8)) - 1;
+    sync_word.m_mask    &= all_bits;
+    sync_word.m_value   &= sync_word.m_mask;
+  }
+
+  for (auto byte = 0u; byte < 256; ++byte) {
+    m_first_byte_matches[byte] = false;
+
+    for (auto const &sync_word : m_sync_words) {
+      auto shift = (sync_word.m_size - 1) * 8;
+      if ((byte & (sync_word.m_mask >> shift)) == (sync_word.m_value >> shift))
+        m_first_byte_matches[byte] = true;
+    }
+  }
+}
+
+bool
+sync_word_searcher_c::matches_at(unsigned char const *buffer,
+                                 std::size_t buffer_size,
+                                 std::size_t position)
+  const {
+  for (auto const &sync_word : m_sync_words) {
+    if ((position + sync_word.m_size) > buffer_size)
+      continue;
+
+    auto value = uint32_t{};
+    for (auto idx = 0u; idx < sync_word.m_size; ++idx)
+      value = (value << 8) | buffer[position + idx];
+
+    if ((value & sync_word.m_mask) == sync_word.m_value)
+      return true;
+  }
+
+  return false;
+}
+
+std::size_t
+sync_word_searcher_c::find(unsigned char const *buffer,
+                           std::size_t buffer_size,
+                           std::size_t start,
+                           std::size_t end)
+  const {
+  end      = std::min(end, buffer_size);
+  auto pos = start;
+
+#if defined(__SSE2__)
+  // Compares the first two bytes of all sync words at sixteen
+  // positions at once. The second byte of the last position is the
+  // seventeenth byte loaded.
+  if ((m_sync_words.size() <= 8) && (end >= 16)) {
+    __m128i first_values[8], first_masks[8], second_values[8], second_masks[8];
+    auto num_sync_words = m_sync_words.size();
+
+    for (auto idx = 0u; idx < num_sync_words; ++idx) {
+      auto const &sync_word = m_sync_words[idx];
+      auto shift            = (sync_word.m_size - 1) * 8;
+
+      first_values[idx]     = _mm_set1_epi8(static_cast<char>(sync_word.m_value >> shift));
+      first_masks[idx]      = _mm_set1_epi8(static_cast<char>(sync_word.m_mask  >> shift));
+      second_values[idx]    = _mm_set1_epi8(static_cast<char>(sync_word.m_value >> (shift - 8)));
+      second_masks[idx]     = _mm_set1_epi8(static_cast<char>(sync_word.m_mask  >> (shift - 8)));
+    }
+
+    for (; ((pos + 16) <= end) && ((pos + 17) <= buffer_size); pos += 16) {
+      auto first_bytes  = _mm_loadu_si128(reinterpret_cast<__m128i const *>(&buffer[pos]));
+      auto second_bytes = _mm_loadu_si128(reinterpret_cast<__m128i const *>(&buffer[pos + 1]));
+      auto candidates   = 0u;
+
+      for (auto idx = 0u; idx < num_sync_words; ++idx) {
+        auto first_ok  = _mm_cmpeq_epi8(_mm_and_si128(first_bytes,  first_masks[idx]),  first_values[idx]);
+        auto second_ok = _mm_cmpeq_epi8(_mm_and_si128(second_bytes, second_masks[idx]), second_values[idx]);
+        candidates    |= _mm_movemask_epi8(_mm_and_si128(first_ok, second_ok));
+      }
+
+      while (candidates) {
+        auto candidate = pos + __builtin_ctz(candidates);
+        if (matches_at(buffer, buffer_size, candidate))
+          return candidate;
+
+        candidates &= candidates - 1;
+      }
+    }
+  }
+#endif
+
+  for (; pos < end; ++pos)
+    if (m_first_byte_matches[buffer[pos]] && matches_at(buffer, buffer_size, pos))
+      return pos;
+
+  return std::string::npos;
+}
+
+}
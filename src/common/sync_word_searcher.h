@@ -0,0 +1,58 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   searching for sync words in elementary streams and container data
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_COMMON_SYNC_WORD_SEARCHER_H
+#define MTX_COMMON_SYNC_WORD_SEARCHER_H
+
+#include "common/common_pch.h"
+
+namespace mtx {
+
+/** \brief Finds candidate positions for frame headers
+
+   Searches a buffer for the first position at which one of several
+   sync words starts. A sync word consists of two to four bytes
+   interpreted as a big-endian number and a mask selecting the bits
+   that must match. Parsers then only have to validate full headers at
+   the positions found instead of at each byte.
+
+   Where SSE2 is available sixteen positions are checked at once
+   against the first two bytes of all sync words; only the positions
+   matching those are checked completely.
+*/
+class sync_word_searcher_c {
+public:
+  struct sync_word_t {
+    uint32_t m_value, m_mask;
+    unsigned int m_size;
+  };
+
+protected:
+  std::vector<sync_word_t> m_sync_words;
+  bool m_first_byte_matches[256];
+
+public:
+  sync_word_searcher_c(std::initializer_list<sync_word_t> sync_words);
+  sync_word_searcher_c(std::vector<sync_word_t> const &sync_words);
+
+  // Returns the first position in [start, end) at which one of the
+  // sync words starts and fits completely into the buffer, or
+  // std::string::npos if there is none.
+  std::size_t find(unsigned char const *buffer, std::size_t buffer_size, std::size_t start = 0, std::size_t end = std::string::npos) const;
+
+  bool matches_at(unsigned char const *buffer, std::size_t buffer_size, std::size_t position) const;
+};
+
+}
+
+#endif // MTX_COMMON_SYNC_WORD_SEARCHER_H
@@ -18,6 +18,7 @@
 #include "common/endian.h"
 #include "common/list_utils.h"
 #include "common/memory.h"
+#include "common/sync_word_searcher.h"
 #include "common/truehd.h"
 
 int const truehd_frame_t::ms_sampling_rates[16]   = { 48000, 96000, 192000, 0, 0, 0, 0, 0, 44100, 88200, 176400, 0, 0, 0, 0, 0 };
@@ -244,14 +245,33 @@ truehd_parser_c::resync(unsigned int offset) {
   m_sync_state              = state_unsynced;
   auto frame                = truehd_frame_t{};
 
-  for (offset = offset + 4; (offset + 4) < size; ++offset) {
-    uint32_t sync_word = get_uint32_be(&data[offset]);
-    if (   (   mtx::included_in(sync_word, TRUEHD_SYNC_WORD, MLP_SYNC_WORD)
-            || (AC3_SYNC_WORD == get_uint16_be(&data[offset - 4])))
-        && frame.parse_header(&data[offset - 4], size - 4)) {
-      m_sync_state  = state_synced;
-      return offset - 4;
+  // A frame starts either with an AC-3 sync word or with a TrueHD/MLP
+  // sync word four bytes into the frame.
+  static auto const s_ac3_searcher    = mtx::sync_word_searcher_c{
+    { AC3_SYNC_WORD, 0xffff, 2 },
+  };
+  static auto const s_truehd_searcher = mtx::sync_word_searcher_c{
+    { TRUEHD_SYNC_WORD & MLP_SYNC_WORD, 0xfffffffe, 4 },
+  };
+
+  auto end        = size > 8 ? size - 8 : 0;
+  auto ac3_pos    = s_ac3_searcher.find(data, size, offset, end);
+  auto truehd_pos = s_truehd_searcher.find(data, size, offset + 4, end + 4);
+
+  while (true) {
+    auto candidate = std::min(ac3_pos, std::string::npos != truehd_pos ? truehd_pos - 4 : std::string::npos);
+    if (std::string::npos == candidate)
+      break;
+
+    if (frame.parse_header(&data[candidate], size - 4)) {
+      m_sync_state = state_synced;
+      return candidate;
     }
+
+    if (ac3_pos == candidate)
+      ac3_pos    = s_ac3_searcher.find(data, size, candidate + 1, end);
+    if ((truehd_pos - 4) == candidate)
+      truehd_pos = s_truehd_searcher.find(data, size, candidate + 5, end + 4);
   }
 
   return 0;
@@ -19,6 +19,7 @@
 #include "common/command_line.h"
 #include "common/mm_io.h"
 #include "common/mm_io_x.h"
+#include "common/strings/fast_format.h"
 #include "common/strings/parsing.h"
 #include "common/translation.h"
 #include "common/version.h"
@@ -94,6 +95,26 @@ show_error(const std::string &error) {
   mxerror(boost::format("(%1%) %2%\n") % NAME % error);
 }
 
+void
+show_progress(int percentage,
+              bool is_final) {
+  static auto s_bf_gui_progress     = fast_format_c{"#GUI#progress %1%%%\n"};
+  static auto s_bf_progress         = fast_format_c{Y("Progress: %1%%%%2%")};
+  static auto s_previous_percentage = -1;
+
+  // Called for each cluster. Only output the progress if it has
+  // actually changed.
+  if (!is_final && (percentage == s_previous_percentage))
+    return;
+
+  s_previous_percentage = is_final ? -1 : percentage;
+
+  if (g_gui_mode)
+    mxinfo(s_bf_gui_progress % percentage);
+  else
+    mxinfo(s_bf_progress % percentage % (is_final ? "\n" : "\r"));
+}
+
 static void
 setup(char **argv) {
   mtx_common_init("mkvextract", argv[0]);
@@ -47,6 +47,8 @@ show_error(const boost::format &format) {
   show_error(format.str());
 }
 
+void show_progress(int percentage, bool is_final = false);
+
 void find_and_verify_track_uids(KaxTracks &tracks, std::vector<track_spec_t> &tspecs);
 
 bool extract_tracks(const std::string &file_name, std::vector<track_spec_t> &tspecs, kax_analyzer_c::parse_mode_e parse_mode);
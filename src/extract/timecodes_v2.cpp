@@ -286,14 +286,8 @@ extract_timecodes(const std::string &file_name,
         KaxCluster *cluster = (KaxCluster *)l1;
         uint64_t cluster_tc = 0;
 
-        if (0 == verbose) {
-          auto current_percentage = in->getFilePointer() * 100 / file_size;
-
-          if (g_gui_mode)
-            mxinfo(boost::format("#GUI#progress %1%%%\n") % current_percentage);
-          else
-            mxinfo(boost::format(Y("Progress: %1%%%%2%")) % current_percentage % "\r");
-        }
+        if (0 == verbose)
+          show_progress(in->getFilePointer() * 100 / file_size);
 
         upper_lvl_el = 0;
         l2           = es->FindNextElement(EBML_CONTEXT(l1), upper_lvl_el, 0xFFFFFFFFL, true, 1);
@@ -382,12 +376,8 @@ extract_timecodes(const std::string &file_name,
 
     close_timecode_files();
 
-    if (0 == verbose) {
-      if (g_gui_mode)
-        mxinfo(boost::format("#GUI#progress %1%%%\n") % 100);
-      else
-        mxinfo(boost::format(Y("Progress: %1%%%%2%")) % 100 % "\n");
-    }
+    if (0 == verbose)
+      show_progress(100, true);
 
   } catch (...) {
     show_error(Y("Caught exception"));
@@ -437,14 +437,8 @@ extract_tracks(const std::string &file_name,
         show_element(l1, 1, Y("Cluster"));
         KaxCluster *cluster = static_cast<KaxCluster *>(l1);
 
-        if (0 == verbose) {
-          auto current_percentage = in->getFilePointer() * 100 / file_size;
-
-          if (g_gui_mode)
-            mxinfo(boost::format("#GUI#progress %1%%%\n") % current_percentage);
-          else
-            mxinfo(boost::format(Y("Progress: %1%%%%2%")) % current_percentage % "\r");
-        }
+        if (0 == verbose)
+          show_progress(in->getFilePointer() * 100 / file_size);
 
         KaxClusterTimecode *ctc = FindChild<KaxClusterTimecode>(l1);
         if (ctc) {
@@ -515,12 +509,8 @@ extract_tracks(const std::string &file_name,
     // singing, fading... fad... ing...
     close_extractors();
 
-    if (0 == verbose) {
-      if (g_gui_mode)
-        mxinfo(boost::format("#GUI#progress %1%%%\n") % 100);
-      else
-        mxinfo(boost::format(Y("Progress: %1%%%%2%")) % 100 % "\n");
-    }
+    if (0 == verbose)
+      show_progress(100, true);
 
     return true;
   } catch (...) {
@@ -12,6 +12,7 @@
 
 #include "common/common_pch.h"
 
+#include "common/json.h"
 #include "info/mkvinfo.h"
 
 void
@@ -25,13 +26,16 @@ console_show_element(int level,
   memset(&level_buffer[1], ' ', level);
   level_buffer[0] = '|';
   level_buffer[level] = 0;
-  mxinfo(boost::format("%1%+ %2%\n") % level_buffer % create_element_text(text, position, size));
+  show_text((boost::format("%1%+ %2%\n") % level_buffer % create_element_text(text, position, size)).str());
   delete []level_buffer;
 }
 
 void
 console_show_error(const std::string &error) {
-  mxinfo(boost::format("(%1%) %2%\n") % NAME % error);
+  if (g_options.m_output_json)
+    mxinfo(mtx::json::object_writer_c{}.add("type", "error").add("message", error).str() + "\n");
+  else
+    mxinfo(boost::format("(%1%) %2%\n") % NAME % error);
   mxexit(2);
 }
 
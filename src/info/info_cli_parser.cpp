@@ -46,6 +46,8 @@ info_cli_parser_c::init_parser() {
   OPT("X|full-hexdump",  set_full_hexdump,  YT("Show all bytes of each frame as a hex dump."));
   OPT("p|hex-positions", set_hex_positions, YT("Show positions in hexadecimal."));
   OPT("z|size",          set_size,          YT("Show the size of each element including its header."));
+  OPT("verify-crc32",    set_verify_crc32,  YT("Only verify the CRC-32 elements of all clusters and other level 1 elements using several threads."));
+  OPT("J|json",          set_output_json,   YT("Output one JSON object per line for each element or, in summary mode, for each frame instead of text."));
 
   add_common_options();
 
@@ -111,6 +113,17 @@ info_cli_parser_c::set_track_info() {
     verbose = 1;
 }
 
+void
+info_cli_parser_c::set_verify_crc32() {
+  m_options.m_verify_crc32 = true;
+}
+
+void
+info_cli_parser_c::set_output_json() {
+  m_options.m_output_json = true;
+  m_options.m_use_gui     = false;
+}
+
 void
 info_cli_parser_c::set_file_name() {
   if (!m_options.m_file_name.empty())
@@ -19,6 +19,7 @@
 #include <typeinfo>
 
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/optional.hpp>
 
 #include <ebml/EbmlHead.h>
 #include <ebml/EbmlSubHead.h>
@@ -63,16 +64,23 @@
 #include "common/endian.h"
 #include "common/fourcc.h"
 #include "common/hevc.h"
+#include "common/json.h"
+#include "common/kax_analyzer.h"
+#include "common/kax_crc32_verifier.h"
 #include "common/kax_file.h"
 #include "common/math.h"
 #include "common/mm_io.h"
 #include "common/mm_io_x.h"
 #include "common/mpeg4_p10.h"
+#include "common/parallel.h"
 #include "common/stereo_mode.h"
 #include "common/strings/editing.h"
+#include "common/strings/fast_format.h"
 #include "common/strings/formatting.h"
+#include "common/strings/parsing.h"
 #include "common/translation.h"
 #include "common/version.h"
+#include "common/vint.h"
 #include "common/xml/ebml_chapters_converter.h"
 #include "common/xml/ebml_tags_converter.h"
 #include "info/mkvinfo.h"
@@ -95,6 +103,7 @@ struct track_info_t {
   track_info_t();
   bool min_timecode_unset();
   bool max_timecode_unset();
+  void merge(track_info_t const &later);
 };
 
 kax_track_t::kax_track_t()
@@ -127,16 +136,48 @@ track_info_t::max_timecode_unset() {
   return LLONG_MIN == m_max_timecode;
 }
 
+// Combines the statistics of a range of clusters with the ones of the
+// range following it.
+void
+track_info_t::merge(track_info_t const &later) {
+  m_size         += later.m_size;
+  m_blocks       += later.m_blocks;
+  m_min_timecode  = std::min(m_min_timecode, later.m_min_timecode);
+
+  for (auto idx = 0; idx < 3; ++idx)
+    m_blocks_by_ref_num[idx] += later.m_blocks_by_ref_num[idx];
+
+  if (!later.m_blocks || (!max_timecode_unset() && (later.m_max_timecode < m_max_timecode)))
+    return;
+
+  m_max_timecode               = later.m_max_timecode;
+  m_add_duration_for_n_packets = later.m_add_duration_for_n_packets;
+}
+
+// The formats, the output buffer and the track statistics the block
+// handlers update exist once per thread so that ranges of clusters can
+// be analyzed concurrently. Each range's statistics are collected in a
+// map owned by the range's worker; they're merged into s_track_info
+// after the workers have finished.
 std::vector<kax_track_cptr> s_tracks;
 std::map<unsigned int, kax_track_cptr> s_tracks_by_number;
 std::map<unsigned int, track_info_t> s_track_info;
+static thread_local std::map<unsigned int, track_info_t> *s_range_track_info = nullptr;
 options_c g_options;
 static uint64_t s_tc_scale = TIMECODE_SCALE;
-std::vector<boost::format> g_common_boost_formats;
+thread_local std::vector<fast_format_c> g_common_formats;
+static thread_local std::string *s_output_buffer = nullptr;
 size_t s_mkvmerge_track_id = 0;
 
-#define BF_DO(n)                             g_common_boost_formats[n]
-#define BF_ADD(s)                            g_common_boost_formats.push_back(boost::format(s))
+static std::size_t const s_num_clusters_per_range = 32;
+
+static std::map<unsigned int, track_info_t> &
+current_track_info() {
+  return s_range_track_info ? *s_range_track_info : s_track_info;
+}
+
+#define BF_DO(n)                             g_common_formats[n]
+#define BF_ADD(s)                            g_common_formats.emplace_back(s)
 #define BF_SHOW_UNKNOWN_ELEMENT              BF_DO( 0)
 #define BF_EBMLVOID                          BF_DO( 1)
 #define BF_FORMAT_BINARY_1                   BF_DO( 2)
@@ -177,8 +218,8 @@ size_t s_mkvmerge_track_id = 0;
 #define BF_AT_HEX                            BF_DO(34)
 
 void
-init_common_boost_formats() {
-  g_common_boost_formats.clear();
+init_common_formats() {
+  g_common_formats.clear();
   BF_ADD(Y("(Unknown element: %1%; ID: 0x%2% size: %3%)"));                                                     //  0 -- BF_SHOW_UNKNOWN_ELEMENT
   BF_ADD(Y("EbmlVoid (size: %1%)"));                                                                            //  1 -- BF_EBMLVOID
   BF_ADD(Y("length %1%, data: %2%"));                                                                           //  2 -- BF_FORMAT_BINARY_1
@@ -216,6 +257,14 @@ init_common_boost_formats() {
   BF_ADD(Y(" at 0x%|1$x|"));                                                                                    // 34 -- BF_AT_HEX
 }
 
+void
+show_text(std::string const &text) {
+  if (s_output_buffer)
+    *s_output_buffer += text;
+  else
+    mxinfo(text);
+}
+
 std::string
 create_element_text(const std::string &text,
                     int64_t position,
@@ -257,17 +306,43 @@ static void
 _show_unknown_element(EbmlStream *es,
                       EbmlElement *e,
                       int level) {
-  static boost::format s_bf_show_unknown_element("%|1$02x|");
+  static char const s_hex_digits[] = "0123456789abcdef";
 
   int i;
   std::string element_id;
-  for (i = EBML_ID_LENGTH(static_cast<const EbmlId &>(*e)) - 1; 0 <= i; --i)
-    element_id += (s_bf_show_unknown_element % ((EBML_ID_VALUE(static_cast<const EbmlId &>(*e)) >> (i * 8)) & 0xff)).str();
+  for (i = EBML_ID_LENGTH(static_cast<const EbmlId &>(*e)) - 1; 0 <= i; --i) {
+    auto byte   = (EBML_ID_VALUE(static_cast<const EbmlId &>(*e)) >> (i * 8)) & 0xff;
+    element_id += s_hex_digits[byte >> 4];
+    element_id += s_hex_digits[byte & 0x0f];
+  }
 
   std::string s = (BF_SHOW_UNKNOWN_ELEMENT % EBML_NAME(e) % element_id % (e->GetSize() + e->HeadSize())).str();
   _show_element(e, es, true, level, s);
 }
 
+static void
+show_element_as_json(EbmlElement *l,
+                     int level,
+                     std::string const &info) {
+  mtx::json::object_writer_c json;
+
+  json.add("type",  "element")
+      .add("level", level)
+      .add("text",  info);
+
+  if (l) {
+    json.add("name",     EBML_NAME(l))
+        .add("position", l->GetElementPosition());
+
+    if (l->IsFiniteSize())
+      json.add("size", l->GetSizeLength() + EBML_ID_LENGTH(static_cast<const EbmlId &>(*l)) + l->GetSize());
+    else
+      json.add("size", nlohmann::json{});
+  }
+
+  show_text(json.str() + "\n");
+}
+
 static void
 _show_element(EbmlElement *l,
               EbmlStream *es,
@@ -277,12 +352,16 @@ _show_element(EbmlElement *l,
   if (g_options.m_show_summary)
     return;
 
-  ui_show_element(level, info,
-                    !l                 ? -1
-                  :                      static_cast<int64_t>(l->GetElementPosition()),
-                    !l                 ? -1
-                  : !l->IsFiniteSize() ? -2
-                  :                      static_cast<int64_t>(l->GetSizeLength() + EBML_ID_LENGTH(static_cast<const EbmlId &>(*l)) + l->GetSize()));
+  if (g_options.m_output_json)
+    show_element_as_json(l, level, info);
+
+  else
+    ui_show_element(level, info,
+                      !l                 ? -1
+                    :                      static_cast<int64_t>(l->GetElementPosition()),
+                      !l                 ? -1
+                    : !l->IsFiniteSize() ? -2
+                    :                      static_cast<int64_t>(l->GetSizeLength() + EBML_ID_LENGTH(static_cast<const EbmlId &>(*l)) + l->GetSize()));
 
   if (!l || !skip)
     return;
@@ -305,17 +384,31 @@ _show_element(EbmlElement *l,
   _show_element(l, es, skip, level, info.str());
 }
 
+inline void
+_show_element(EbmlElement *l,
+              EbmlStream *es,
+              bool skip,
+              int level,
+              fast_format_c const &info) {
+  _show_element(l, es, skip, level, info.str());
+}
+
 static std::string
 create_hexdump(const unsigned char *buf,
                int size) {
-  static boost::format s_bf_create_hexdump(" %|1$02x|");
+  static char const s_hex_digits[] = "0123456789abcdef";
 
   std::string hex(" hexdump");
   int bmax = std::min(size, g_options.m_hexdump_max_size);
   int b;
 
-  for (b = 0; b < bmax; ++b)
-    hex += (s_bf_create_hexdump % static_cast<int>(buf[b])).str();
+  hex.reserve(hex.size() + std::max(bmax, 0) * 3);
+
+  for (b = 0; b < bmax; ++b) {
+    hex += ' ';
+    hex += s_hex_digits[buf[b] >> 4];
+    hex += s_hex_digits[buf[b] & 0x0f];
+  }
 
   return hex;
 }
@@ -514,7 +607,8 @@ handle_info(EbmlStream *&es,
 void
 handle_audio_track(EbmlStream *&es,
                    EbmlElement *&l3,
-                   std::vector<std::string> &summary) {
+                   std::vector<std::string> &summary,
+                   nlohmann::json &summary_json) {
   show_element(l3, 3, "Audio track");
 
   for (auto l4 : *static_cast<EbmlMaster *>(l3))
@@ -522,16 +616,19 @@ handle_audio_track(EbmlStream *&es,
       KaxAudioSamplingFreq &freq = *static_cast<KaxAudioSamplingFreq *>(l4);
       show_element(l4, 4, boost::format(Y("Sampling frequency: %1%")) % freq.GetValue());
       summary.push_back((boost::format(Y("sampling freq: %1%")) % freq.GetValue()).str());
+      summary_json["sampling_frequency"] = freq.GetValue();
 
     } else if (Is<KaxAudioOutputSamplingFreq>(l4)) {
       KaxAudioOutputSamplingFreq &ofreq = *static_cast<KaxAudioOutputSamplingFreq *>(l4);
       show_element(l4, 4, boost::format(Y("Output sampling frequency: %1%")) % ofreq.GetValue());
       summary.push_back((boost::format(Y("output sampling freq: %1%")) % ofreq.GetValue()).str());
+      summary_json["output_sampling_frequency"] = ofreq.GetValue();
 
     } else if (Is<KaxAudioChannels>(l4)) {
       KaxAudioChannels &channels = *static_cast<KaxAudioChannels *>(l4);
       show_element(l4, 4, boost::format(Y("Channels: %1%")) % channels.GetValue());
       summary.push_back((boost::format(Y("channels: %1%")) % channels.GetValue()).str());
+      summary_json["channels"] = channels.GetValue();
 
 #if MATROSKA_VERSION >= 2
     } else if (Is<KaxAudioPosition>(l4)) {
@@ -543,6 +640,7 @@ handle_audio_track(EbmlStream *&es,
       KaxAudioBitDepth &bps = *static_cast<KaxAudioBitDepth *>(l4);
       show_element(l4, 4, boost::format(Y("Bit depth: %1%")) % bps.GetValue());
       summary.push_back((boost::format(Y("bits per sample: %1%")) % bps.GetValue()).str());
+      summary_json["bits_per_sample"] = bps.GetValue();
 
     } else if (!is_global(es, l4, 4))
       show_unknown_element(l4, 4);
@@ -677,7 +775,8 @@ handle_video_projection(EbmlStream *&es,
 void
 handle_video_track(EbmlStream *&es,
                    EbmlElement *&l3,
-                   std::vector<std::string> &summary) {
+                   std::vector<std::string> &summary,
+                   nlohmann::json &summary_json) {
   show_element(l3, 3, Y("Video track"));
 
   for (auto l4 : *static_cast<EbmlMaster *>(l3))
@@ -685,41 +784,49 @@ handle_video_track(EbmlStream *&es,
       KaxVideoPixelWidth &width = *static_cast<KaxVideoPixelWidth *>(l4);
       show_element(l4, 4, boost::format(Y("Pixel width: %1%")) % width.GetValue());
       summary.push_back((boost::format(Y("pixel width: %1%")) % width.GetValue()).str());
+      summary_json["pixel_width"] = width.GetValue();
 
     } else if (Is<KaxVideoPixelHeight>(l4)) {
       KaxVideoPixelHeight &height = *static_cast<KaxVideoPixelHeight *>(l4);
       show_element(l4, 4, boost::format(Y("Pixel height: %1%")) % height.GetValue());
       summary.push_back((boost::format(Y("pixel height: %1%")) % height.GetValue()).str());
+      summary_json["pixel_height"] = height.GetValue();
 
     } else if (Is<KaxVideoDisplayWidth>(l4)) {
       KaxVideoDisplayWidth &width = *static_cast<KaxVideoDisplayWidth *>(l4);
       show_element(l4, 4, boost::format(Y("Display width: %1%")) % width.GetValue());
       summary.push_back((boost::format(Y("display width: %1%")) % width.GetValue()).str());
+      summary_json["display_width"] = width.GetValue();
 
     } else if (Is<KaxVideoDisplayHeight>(l4)) {
       KaxVideoDisplayHeight &height = *static_cast<KaxVideoDisplayHeight *>(l4);
       show_element(l4, 4, boost::format(Y("Display height: %1%")) % height.GetValue());
       summary.push_back((boost::format(Y("display height: %1%")) % height.GetValue()).str());
+      summary_json["display_height"] = height.GetValue();
 
     } else if (Is<KaxVideoPixelCropLeft>(l4)) {
       KaxVideoPixelCropLeft &left = *static_cast<KaxVideoPixelCropLeft *>(l4);
       show_element(l4, 4, boost::format(Y("Pixel crop left: %1%")) % left.GetValue());
       summary.push_back((boost::format(Y("pixel crop left: %1%")) % left.GetValue()).str());
+      summary_json["pixel_crop_left"] = left.GetValue();
 
     } else if (Is<KaxVideoPixelCropTop>(l4)) {
       KaxVideoPixelCropTop &top = *static_cast<KaxVideoPixelCropTop *>(l4);
       show_element(l4, 4, boost::format(Y("Pixel crop top: %1%")) % top.GetValue());
       summary.push_back((boost::format(Y("pixel crop top: %1%")) % top.GetValue()).str());
+      summary_json["pixel_crop_top"] = top.GetValue();
 
     } else if (Is<KaxVideoPixelCropRight>(l4)) {
       KaxVideoPixelCropRight &right = *static_cast<KaxVideoPixelCropRight *>(l4);
       show_element(l4, 4, boost::format(Y("Pixel crop right: %1%")) % right.GetValue());
       summary.push_back((boost::format(Y("pixel crop right: %1%")) % right.GetValue()).str());
+      summary_json["pixel_crop_right"] = right.GetValue();
 
     } else if (Is<KaxVideoPixelCropBottom>(l4)) {
       KaxVideoPixelCropBottom &bottom = *static_cast<KaxVideoPixelCropBottom *>(l4);
       show_element(l4, 4, boost::format(Y("Pixel crop bottom: %1%")) % bottom.GetValue());
       summary.push_back((boost::format(Y("pixel crop bottom: %1%")) % bottom.GetValue()).str());
+      summary_json["pixel_crop_bottom"] = bottom.GetValue();
 
 #if MATROSKA_VERSION >= 2
     } else if (Is<KaxVideoDisplayUnit>(l4)) {
@@ -896,6 +1003,27 @@ handle_content_encodings(EbmlStream *&es,
       show_unknown_element(l4, 4);
 }
 
+static void
+show_track_summary_as_json(kax_track_t const &track,
+                           std::string const &codec_id,
+                           nlohmann::json const &summary_json) {
+  mtx::json::object_writer_c json;
+
+  json.add("type",       "track")
+      .add("number",     track.tnum)
+      .add("track_type", 'a' == track.type ? "audio"
+                       : 'v' == track.type ? "video"
+                       : 's' == track.type ? "subtitles"
+                       : 'b' == track.type ? "buttons"
+                       :                     "unknown")
+      .add("codec_id",   codec_id);
+
+  for (auto property = summary_json.begin(), end = summary_json.end(); property != end; ++property)
+    json.add(property.key().c_str(), property.value());
+
+  show_text(json.str() + "\n");
+}
+
 void
 handle_tracks(EbmlStream *&es,
               int &upper_lvl_el,
@@ -916,16 +1044,17 @@ handle_tracks(EbmlStream *&es,
       show_element(l2, 2, Y("A track"));
 
       std::vector<std::string> summary;
+      auto summary_json = nlohmann::json::object();
       std::string kax_codec_id, fourcc_buffer;
       auto track = std::make_shared<kax_track_t>();
 
       for (auto l3 : *static_cast<EbmlMaster *>(l2))
         // Now evaluate the data belonging to this track
         if (Is<KaxTrackAudio>(l3))
-          handle_audio_track(es, l3, summary);
+          handle_audio_track(es, l3, summary, summary_json);
 
         else if (Is<KaxTrackVideo>(l3))
-          handle_video_track(es, l3, summary);
+          handle_video_track(es, l3, summary, summary_json);
 
         else if (Is<KaxTrackNumber>(l3)) {
           track->tnum = static_cast<KaxTrackNumber *>(l3)->GetValue();
@@ -942,6 +1071,7 @@ handle_tracks(EbmlStream *&es,
 
           show_element(l3, 3, boost::format(Y("Track number: %1% (track ID for mkvmerge & mkvextract: %2%)")) % track->tnum % track_id);
           summary.push_back((boost::format(Y("mkvmerge/mkvextract track ID: %1%"))                            % track_id).str());
+          summary_json["track_id"] = track_id;
 
         } else if (Is<KaxTrackUID>(l3)) {
           track->tuid = static_cast<KaxTrackUID *>(l3)->GetValue();
@@ -1022,6 +1152,7 @@ handle_tracks(EbmlStream *&es,
                              % (static_cast<double>(track->default_duration) / 1000000.0)
                              % (1000000000.0 / static_cast<double>(track->default_duration))
                              ).str());
+          summary_json["default_duration"] = track->default_duration;
 
         } else if (Is<KaxTrackFlagLacing>(l3))
           show_element(l3, 3, boost::format(Y("Lacing flag: %1%"))          % static_cast<KaxTrackFlagLacing *>(l3)->GetValue());
@@ -1036,6 +1167,7 @@ handle_tracks(EbmlStream *&es,
           auto language = static_cast<KaxTrackLanguage *>(l3)->GetValue();
           show_element(l3, 3, boost::format(Y("Language: %1%"))             % language);
           summary.push_back((boost::format(Y("language: %1%"))              % language).str());
+          summary_json["language"] = language;
 
         } else if (Is<KaxTrackTimecodeScale>(l3))
           show_element(l3, 3, boost::format(Y("Timecode scale: %1%"))       % static_cast<KaxTrackTimecodeScale *>(l3)->GetValue());
@@ -1057,7 +1189,10 @@ handle_tracks(EbmlStream *&es,
         } else if (!is_global(es, l3, 3))
           show_unknown_element(l3, 3);
 
-      if (g_options.m_show_summary)
+      if (g_options.m_show_summary && g_options.m_output_json)
+        show_track_summary_as_json(*track, kax_codec_id, summary_json);
+
+      else if (g_options.m_show_summary)
         mxinfo(boost::format(Y("Track %1%: %2%, codec ID: %3%%4%%5%%6%\n"))
                % track->tnum
                % (  'a' == track->type ? Y("audio")
@@ -1251,6 +1386,37 @@ handle_silent_track(EbmlStream *&es,
       show_unknown_element(l3, 3);
 }
 
+static void
+show_frame_as_json(char frame_type,
+                   uint64_t track_number,
+                   int64_t timestamp,
+                   boost::optional<int64_t> duration,
+                   uint64_t size,
+                   uint32_t adler,
+                   std::string const &hexdump,
+                   int64_t position) {
+  mtx::json::object_writer_c json;
+
+  json.add("type",       "frame")
+      .add("frame_type", std::string(1, frame_type))
+      .add("track",      track_number)
+      .add("timestamp",  timestamp);
+
+  if (duration)
+    json.add("duration", *duration);
+
+  json.add("size",     size)
+      .add("position", position);
+
+  if (g_options.m_calc_checksums)
+    json.add("adler32", adler);
+
+  if (!hexdump.empty())
+    json.add("hexdump", hexdump.substr(std::string{" hexdump "}.length()));
+
+  show_text(json.str() + "\n");
+}
+
 void
 handle_block_group(EbmlStream *&es,
                    EbmlElement *&l2,
@@ -1392,7 +1558,16 @@ handle_block_group(EbmlStream *&es,
     } else if (!is_global(es, l3, 3))
       show_unknown_element(l3, 3);
 
-  if (g_options.m_show_summary) {
+  if (g_options.m_show_summary && g_options.m_output_json) {
+    auto frame_type = num_references >= 2 ? 'B' : num_references == 1 ? 'P' : 'I';
+    auto duration   = bduration != -1.0 ? boost::optional<int64_t>{std::llround(bduration * 1000000.0)} : boost::optional<int64_t>{};
+
+    for (size_t fidx = 0; fidx < frame_sizes.size(); fidx++) {
+      show_frame_as_json(frame_type, lf_tnum, lf_timecode, duration, frame_sizes[fidx], frame_adlers[fidx], frame_hexdumps[fidx], frame_pos);
+      frame_pos += frame_sizes[fidx];
+    }
+
+  } else if (g_options.m_show_summary) {
     std::string position;
     size_t fidx;
 
@@ -1403,7 +1578,7 @@ handle_block_group(EbmlStream *&es,
       }
 
       if (bduration != -1.0)
-        mxinfo(BF_BLOCK_GROUP_SUMMARY_WITH_DURATION
+        show_text((BF_BLOCK_GROUP_SUMMARY_WITH_DURATION
                % (num_references >= 2 ? 'B' : num_references == 1 ? 'P' : 'I')
                % lf_tnum
                % std::llround(lf_timecode / 1000000.0)
@@ -1412,9 +1587,9 @@ handle_block_group(EbmlStream *&es,
                % frame_sizes[fidx]
                % frame_adlers[fidx]
                % frame_hexdumps[fidx]
-               % position);
+               % position).str());
       else
-        mxinfo(BF_BLOCK_GROUP_SUMMARY_NO_DURATION
+        show_text((BF_BLOCK_GROUP_SUMMARY_NO_DURATION
                % (num_references >= 2 ? 'B' : num_references == 1 ? 'P' : 'I')
                % lf_tnum
                % std::llround(lf_timecode / 1000000.0)
@@ -1422,7 +1597,7 @@ handle_block_group(EbmlStream *&es,
                % frame_sizes[fidx]
                % frame_adlers[fidx]
                % frame_hexdumps[fidx]
-               % position);
+               % position).str());
     }
 
   } else if (g_options.m_verbose > 2)
@@ -1432,7 +1607,7 @@ handle_block_group(EbmlStream *&es,
                  % lf_tnum
                  % std::llround(lf_timecode / 1000000.0));
 
-  track_info_t &tinfo = s_track_info[lf_tnum];
+  track_info_t &tinfo = current_track_info()[lf_tnum];
 
   tinfo.m_blocks                                          += frame_sizes.size();
   tinfo.m_blocks_by_ref_num[std::min(num_references, 2u)] += frame_sizes.size();
@@ -1458,6 +1633,7 @@ handle_simple_block(EbmlStream *&es,
                     KaxCluster *&cluster) {
   std::vector<int> frame_sizes;
   std::vector<uint32_t> frame_adlers;
+  std::vector<std::string> frame_hexdumps;
 
   KaxSimpleBlock &block = *static_cast<KaxSimpleBlock *>(l2);
   block.SetParent(*cluster);
@@ -1465,7 +1641,7 @@ handle_simple_block(EbmlStream *&es,
   int64_t frame_pos   = block.GetElementPosition() + block.ElementSize();
   auto timecode_ns    = mtx::math::to_signed(block.GlobalTimecode());
   auto timecode_ms    = std::llround(static_cast<double>(timecode_ns) / 1000000.0);
-  track_info_t &tinfo = s_track_info[block.TrackNum()];
+  track_info_t &tinfo = current_track_info()[block.TrackNum()];
 
   std::string info;
   if (block.IsKeyframe())
@@ -1498,10 +1674,19 @@ handle_simple_block(EbmlStream *&es,
 
     frame_sizes.push_back(data.Size());
     frame_adlers.push_back(adler);
+    frame_hexdumps.push_back(hex);
     frame_pos -= data.Size();
   }
 
-  if (g_options.m_show_summary) {
+  if (g_options.m_show_summary && g_options.m_output_json) {
+    auto frame_type = block.IsKeyframe() ? 'I' : block.IsDiscardable() ? 'B' : 'P';
+
+    for (size_t fidx = 0; fidx < frame_sizes.size(); fidx++) {
+      show_frame_as_json(frame_type, block.TrackNum(), timecode_ns, boost::none, frame_sizes[fidx], frame_adlers[fidx], frame_hexdumps[fidx], frame_pos);
+      frame_pos += frame_sizes[fidx];
+    }
+
+  } else if (g_options.m_show_summary) {
     std::string position;
     size_t fidx;
 
@@ -1511,14 +1696,14 @@ handle_simple_block(EbmlStream *&es,
         frame_pos += frame_sizes[fidx];
       }
 
-      mxinfo(BF_SIMPLE_BLOCK_SUMMARY
-             % (block.IsKeyframe() ? 'I' : block.IsDiscardable() ? 'B' : 'P')
-             % block.TrackNum()
-             % timecode_ms
-             % format_timestamp(timecode_ns, 3)
-             % frame_sizes[fidx]
-             % frame_adlers[fidx]
-             % position);
+      show_text((BF_SIMPLE_BLOCK_SUMMARY
+                 % (block.IsKeyframe() ? 'I' : block.IsDiscardable() ? 'B' : 'P')
+                 % block.TrackNum()
+                 % timecode_ms
+                 % format_timestamp(timecode_ns, 3)
+                 % frame_sizes[fidx]
+                 % frame_adlers[fidx]
+                 % position).str());
     }
 
   } else if (g_options.m_verbose > 2)
@@ -1581,7 +1766,7 @@ handle_elements_rec(EbmlStream *es,
                     int level,
                     EbmlElement *e,
                     mtx::xml::ebml_converter_c const &converter) {
-  static boost::format s_bf_handle_elements_rec("%1%: %2%");
+  static thread_local fast_format_c s_bf_handle_elements_rec{"%1%: %2%"};
   static std::vector<std::string> const s_output_as_timecode{ "ChapterTimeStart", "ChapterTimeEnd" };
 
   std::string elt_name = converter.get_tag_name(*e);
@@ -1689,14 +1874,157 @@ handle_ebml_head(EbmlElement *l0,
   }
 }
 
+static bool
+locate_level1_elements(mm_io_c &in,
+                       uint64_t start_pos,
+                       uint64_t end_pos,
+                       std::vector<uint64_t> &cluster_positions,
+                       std::vector<uint64_t> &other_positions) {
+  try {
+    in.setFilePointer(start_pos);
+
+    while (in.getFilePointer() < end_pos) {
+      auto position = in.getFilePointer();
+      auto id       = vint_c::read_ebml_id(in);
+      auto size     = vint_c::read(in);
+
+      if (!id.is_valid() || size.is_unknown())
+        return false;
+
+      if (EBML_ID_VALUE(EBML_ID(KaxCluster)) == id.m_value)
+        cluster_positions.push_back(position);
+      else
+        other_positions.push_back(position);
+
+      in.setFilePointer(in.getFilePointer() + size.m_value);
+    }
+
+  } catch (mtx::mm_io::exception &) {
+    return false;
+  }
+
+  return true;
+}
+
+static void
+handle_cluster_range(std::string const &file_name,
+                     std::vector<uint64_t> const &cluster_positions,
+                     std::size_t first,
+                     std::size_t last,
+                     std::string &output,
+                     std::map<unsigned int, track_info_t> &track_info) {
+  if (g_common_formats.empty())
+    init_common_formats();
+
+  track_info.clear();
+  s_range_track_info = &track_info;
+  s_output_buffer    = &output;
+
+  auto in           = mm_file_io_c::open(file_name);
+  auto es_ptr       = std::make_shared<EbmlStream>(*in);
+  auto es           = es_ptr.get();
+  auto file_size    = in->get_size();
+  auto upper_lvl_el = 0;
+  kax_file_c kax_file{*in};
+
+  kax_file.set_timecode_scale(-1);
+
+  for (auto idx = first; idx < last; ++idx) {
+    in->setFilePointer(cluster_positions[idx]);
+
+    auto l1 = kax_file.read_next_level1_element();
+    if (!l1)
+      break;
+
+    std::shared_ptr<EbmlElement> af_l1(l1);
+
+    show_element(l1, 1, Y("Cluster"));
+    handle_cluster(es, upper_lvl_el, l1, file_size);
+  }
+
+  s_output_buffer    = nullptr;
+  s_range_track_info = nullptr;
+}
+
+/** \brief Analyze all clusters of a segment with several threads
+
+   The positions of all level 1 elements are determined by reading
+   only their headers. The clusters are split into ranges of a fixed
+   number of clusters which are analyzed concurrently, each thread
+   using its own file handle. The output and the track statistics of
+   each range are collected by the thread and shown respectively
+   merged in order once all ranges of a round have been handled.
+
+   Returns \c false without having analyzed anything if the level 1
+   structure cannot be determined that way, e.g. for damaged files or
+   clusters with an unknown size. Otherwise \c other_positions
+   contains the positions of the level 1 elements following the first
+   cluster that aren't clusters.
+*/
+static bool
+handle_clusters_in_parallel(std::string const &file_name,
+                            mm_io_c &in,
+                            uint64_t first_cluster_pos,
+                            uint64_t segment_end,
+                            std::vector<uint64_t> &other_positions) {
+  auto num_threads = mtx::parallel::default_num_threads();
+  auto threads_arg = std::string{};
+
+  // Allows tests to force several rounds of ranges independent of the
+  // number of CPUs.
+  if (debugging_c::requested("mkvinfo_cluster_threads", &threads_arg) && (!parse_number(threads_arg, num_threads) || !num_threads))
+    mxerror(boost::format("Invalid argument for the debug option 'mkvinfo_cluster_threads': %1%\n") % threads_arg);
+
+  if (g_options.m_use_gui || (1 == num_threads) || debugging_c::requested("mkvinfo_no_parallel_clusters"))
+    return false;
+
+  auto cluster_positions = std::vector<uint64_t>{};
+  if (!locate_level1_elements(in, first_cluster_pos, segment_end, cluster_positions, other_positions) || (s_num_clusters_per_range >= cluster_positions.size())) {
+    other_positions.clear();
+    in.setFilePointer(first_cluster_pos);
+    return false;
+  }
+
+  auto num_ranges       = (cluster_positions.size() + s_num_clusters_per_range - 1) / s_num_clusters_per_range;
+  auto ranges_per_round = static_cast<std::size_t>(num_threads) * 2;
+
+  for (auto round_start = std::size_t{}; round_start < num_ranges; round_start += ranges_per_round) {
+    auto num_ranges_in_round = std::min(ranges_per_round, num_ranges - round_start);
+    auto outputs             = std::vector<std::string>(num_ranges_in_round);
+    auto track_infos         = std::vector<std::map<unsigned int, track_info_t>>(num_ranges_in_round);
+
+    mtx::parallel::for_each_index(num_ranges_in_round, [&](std::size_t idx) {
+      auto first = (round_start + idx) * s_num_clusters_per_range;
+      auto last  = std::min(first + s_num_clusters_per_range, cluster_positions.size());
+
+      handle_cluster_range(file_name, cluster_positions, first, last, outputs[idx], track_infos[idx]);
+    }, num_threads);
+
+    for (auto idx = 0u; idx < num_ranges_in_round; ++idx) {
+      if (!outputs[idx].empty())
+        mxinfo(outputs[idx]);
+
+      for (auto const &info : track_infos[idx])
+        s_track_info[info.first].merge(info.second);
+    }
+  }
+
+  return true;
+}
+
 void
 handle_segment(EbmlElement *l0,
                mm_io_cptr &in,
-               EbmlStream *es) {
+               EbmlStream *es,
+               std::string const &file_name) {
   auto file_size         = in->get_size();
   auto l1                = static_cast<EbmlElement *>(nullptr);
   auto upper_lvl_el      = 0;
   auto kax_file          = std::make_shared<kax_file_c>(*in);
+  auto segment_end       = l0->IsFiniteSize() ? l0->GetElementPosition() + l0->HeadSize() + l0->GetSize() : file_size;
+  auto clusters_handled  = false;
+  auto other_positions   = std::vector<uint64_t>{};
+  auto other_idx         = std::size_t{};
 
   kax_file->set_segment_end(*l0);
 
@@ -1721,10 +2049,18 @@ handle_segment(EbmlElement *l0,
       handle_seek_head(es, upper_lvl_el, l1);
 
     else if (Is<KaxCluster>(l1)) {
-      show_element(l1, 1, Y("Cluster"));
-      if ((g_options.m_verbose == 0) && !g_options.m_show_summary)
+      if ((g_options.m_verbose == 0) && !g_options.m_show_summary) {
+        show_element(l1, 1, Y("Cluster"));
         return;
-      handle_cluster(es, upper_lvl_el, l1, file_size);
+      }
+
+      if (!clusters_handled && handle_clusters_in_parallel(file_name, *in, l1->GetElementPosition(), segment_end, other_positions))
+        clusters_handled = true;
+
+      else {
+        show_element(l1, 1, Y("Cluster"));
+        handle_cluster(es, upper_lvl_el, l1, file_size);
+      }
 
     } else if (Is<KaxCues>(l1))
       handle_cues(es, upper_lvl_el, l1);
@@ -1743,6 +2079,15 @@ handle_segment(EbmlElement *l0,
     else if (!is_global(es, l1, 1))
       show_unknown_element(l1, 1);
 
+    // All clusters have been analyzed already. Only handle the
+    // remaining other level 1 elements.
+    if (clusters_handled) {
+      if (other_idx >= other_positions.size())
+        break;
+      in->setFilePointer(other_positions[other_idx++]);
+      continue;
+    }
+
     if (!in->setFilePointer2(l1->GetElementPosition() + kax_file->get_element_size(l1)))
       break;
     if (!in_parent(l0))
@@ -1766,12 +2111,26 @@ display_track_info() {
     int64_t duration  = tinfo.m_max_timecode - tinfo.m_min_timecode;
     duration         += tinfo.m_add_duration_for_n_packets * track->default_duration;
 
+    auto bitrate      = static_cast<uint64_t>(duration == 0 ? 0 : tinfo.m_size * 8000000000.0 / duration);
+
+    if (g_options.m_output_json) {
+      show_text(mtx::json::object_writer_c{}
+                .add("type",     "track_statistics")
+                .add("track",    track->tnum)
+                .add("blocks",   tinfo.m_blocks)
+                .add("size",     tinfo.m_size)
+                .add("duration", duration)
+                .add("bitrate",  bitrate)
+                .str() + "\n");
+      continue;
+    }
+
     mxinfo(boost::format(Y("Statistics for track number %1%: number of blocks: %2%; size in bytes: %3%; duration in seconds: %4%; approximate bitrate in bits/second: %5%\n"))
            % track->tnum
            % tinfo.m_blocks
            % tinfo.m_size
            % (duration / 1000000000.0)
-           % static_cast<uint64_t>(duration == 0 ? 0 : tinfo.m_size * 8000000000.0 / duration));
+           % bitrate);
   }
 }
 
@@ -1820,7 +2179,7 @@ process_file(const std::string &file_name) {
         continue;
       }
 
-      handle_segment(l0.get(), in, es);
+      handle_segment(l0.get(), in, es, file_name);
 
       l0->SkipData(*es, EBML_CONTEXT(l0));
 
@@ -1838,13 +2197,53 @@ process_file(const std::string &file_name) {
   }
 }
 
+static void
+verify_crc32s(std::string const &file_name) {
+  kax_analyzer_c analyzer{file_name};
+
+  analyzer
+    .set_parse_mode(kax_analyzer_c::parse_mode_full)
+    .set_open_mode(MODE_READ);
+
+  if (!analyzer.process())
+    mxerror(boost::format(Y("The file '%1%' could not be opened for reading, or a read error occurred.\n")) % file_name);
+
+  analyzer.close_file();
+
+  kax_crc32_verifier_c verifier{file_name, analyzer.get_elements()};
+  verifier.verify();
+
+  using result_e = kax_crc32_verifier_c::result_e;
+
+  for (auto const &result : verifier.get_results()) {
+    auto description = kax_analyzer_data_c{result.m_id, result.m_pos, result.m_size, result_e::size_unknown != result.m_result}.to_string();
+
+    if (result_e::mismatch == result.m_result)
+      mxinfo(boost::format(Y("CRC-32 mismatch: %1%: stored 0x%|2$08x|, calculated 0x%|3$08x|\n")) % description % result.m_stored_crc % result.m_calculated_crc);
+
+    else if (result_e::read_error == result.m_result)
+      mxinfo(boost::format(Y("Read error while verifying the CRC-32: %1%\n")) % description);
+
+    else if ((result_e::ok == result.m_result) && (0 < g_options.m_verbose))
+      mxinfo(boost::format(Y("CRC-32 OK: %1%\n")) % description);
+  }
+
+  auto num_mismatches = verifier.count(result_e::mismatch) + verifier.count(result_e::read_error);
+
+  mxinfo(boost::format(Y("Elements with a valid CRC-32: %1%; with an invalid CRC-32 or read errors: %2%; without a CRC-32: %3%; with an unknown size: %4%\n"))
+         % verifier.count(result_e::ok) % num_mismatches % verifier.count(result_e::no_crc32) % verifier.count(result_e::size_unknown));
+
+  if (num_mismatches)
+    mxerror(boost::format(Y("%1% element(s) failed the CRC-32 verification.\n")) % num_mismatches);
+}
+
 void
 setup(char const *argv0,
       std::string const &locale) {
   mtx_common_init("mkvinfo", argv0);
 
   init_locales(locale);
-  init_common_boost_formats();
+  init_common_formats();
 
   version_info = get_version_info("mkvinfo", vif_full);
 }
@@ -1856,6 +2255,11 @@ console_main() {
   if (g_options.m_file_name.empty())
     mxerror(Y("No file name given.\n"));
 
+  if (g_options.m_verify_crc32) {
+    verify_crc32s(g_options.m_file_name);
+    return 0;
+  }
+
   return process_file(g_options.m_file_name.c_str()) ? 0 : 1;
 }
 
@@ -1866,7 +2270,7 @@ main(int argc,
 
   g_options = info_cli_parser_c(command_line_utf8(argc, argv)).run();
 
-  init_common_boost_formats();
+  init_common_formats();
 
   if (g_options.m_use_gui)
     ui_run(argc, argv);
@@ -28,6 +28,7 @@ void setup(char const *argv0, const std::string &locale = "");
 void cleanup();
 
 std::string create_element_text(const std::string &text, int64_t position, int64_t size);
+void show_text(std::string const &text);
 void ui_show_error(const std::string &error);
 void ui_show_element(int level, const std::string &text, int64_t position, int64_t size);
 void ui_show_progress(int percentage, const std::string &text);
@@ -18,8 +18,6 @@
 
 #include "merge/packet.h"
 
-class packet_t;
-
 class packet_converter_c {
 protected:
   generic_packetizer_c *m_ptzr;
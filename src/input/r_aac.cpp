@@ -125,7 +125,7 @@ aac_reader_c::read(generic_packetizer_c *,
 
     while (m_parser.frames_available()) {
       auto frame = m_parser.get_frame();
-      PTZR0->process(std::make_shared<packet_t>(frame.m_data));
+      PTZR0->process(packet_t::create(frame.m_data));
     }
   }
 
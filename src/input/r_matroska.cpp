@@ -31,6 +31,8 @@
 #include <matroska/KaxCluster.h>
 #include <matroska/KaxClusterData.h>
 #include <matroska/KaxContexts.h>
+#include <matroska/KaxCues.h>
+#include <matroska/KaxCuesData.h>
 #include <matroska/KaxInfo.h>
 #include <matroska/KaxInfoData.h>
 #include <matroska/KaxSeekHead.h>
@@ -65,6 +67,7 @@
 #include "merge/file_status.h"
 #include "merge/input_x.h"
 #include "merge/output_control.h"
+#include "merge/queue_budget.h"
 #include "output/p_aac.h"
 #include "output/p_ac3.h"
 #include "output/p_alac.h"
@@ -336,6 +339,7 @@ kax_reader_c::init_l1_position_storage(deferred_positions_t &storage) {
   storage[dl1t_tags]        = std::vector<int64_t>();
   storage[dl1t_tracks]      = std::vector<int64_t>();
   storage[dl1t_seek_head]   = std::vector<int64_t>();
+  storage[dl1t_cues]        = std::vector<int64_t>();
 }
 
 bool
@@ -1380,6 +1384,7 @@ kax_reader_c::handle_seek_head(mm_io_c *io,
         :                       Is<KaxTracks>(id)      ? dl1t_tracks
         :                       Is<KaxSeekHead>(id)    ? dl1t_seek_head
         :                       Is<KaxInfo>(id)        ? dl1t_info
+        :                       Is<KaxCues>(id)        ? dl1t_cues
         :                                                dl1t_unknown;
 
       if (dl1t_unknown == type)
@@ -1431,6 +1436,7 @@ kax_reader_c::find_level1_elements_via_analyzer() {
     analyzer->with_elements(EBML_ID(KaxAttachments), [this](kax_analyzer_data_c const &data) { m_deferred_l1_positions[dl1t_attachments].push_back(data.m_pos); });
     analyzer->with_elements(EBML_ID(KaxChapters),    [this](kax_analyzer_data_c const &data) { m_deferred_l1_positions[dl1t_chapters   ].push_back(data.m_pos); });
     analyzer->with_elements(EBML_ID(KaxTags),        [this](kax_analyzer_data_c const &data) { m_deferred_l1_positions[dl1t_tags       ].push_back(data.m_pos); });
+    analyzer->with_elements(EBML_ID(KaxCues),        [this](kax_analyzer_data_c const &data) { m_deferred_l1_positions[dl1t_cues       ].push_back(data.m_pos); });
 
   } catch (...) {
   }
@@ -1499,6 +1505,7 @@ kax_reader_c::read_headers_internal() {
     }
 
     m_in_file->set_segment_end(*l0);
+    m_segment_data_start_pos = l0->GetElementPosition() + l0->HeadSize();
 
     // We've got our segment, so let's find the m_tracks
     m_tc_scale = TIMECODE_SCALE;
@@ -1523,6 +1530,9 @@ kax_reader_c::read_headers_internal() {
       else if (Is<KaxTags>(*l1))
         m_deferred_l1_positions[dl1t_tags].push_back(l1->GetElementPosition());
 
+      else if (Is<KaxCues>(*l1))
+        m_deferred_l1_positions[dl1t_cues].push_back(l1->GetElementPosition());
+
       else if (Is<KaxSeekHead>(*l1))
         handle_seek_head(m_in.get(), l0, l1->GetElementPosition());
 
@@ -2187,18 +2197,21 @@ kax_reader_c::read(generic_packetizer_c *requested_ptzr,
   if (m_tracks.empty() || (FILE_STATUS_DONE == m_file_status))
     return FILE_STATUS_DONE;
 
-  auto num_queued_bytes = get_queued_bytes();
+  auto requested_ptzr_track = m_ptzr_to_track_map[requested_ptzr];
+  auto audio_or_video       = requested_ptzr_track && (('a' == requested_ptzr_track->type) || ('v' == requested_ptzr_track->type));
+
+  if (queue_budget_c::get().must_hold(get_queued_bytes(), audio_or_video, force))
+    return FILE_STATUS_HOLDING;
 
-  if (20 * 1024 * 1024 < num_queued_bytes) {
-    auto requested_ptzr_track = m_ptzr_to_track_map[requested_ptzr];
-    if (   !requested_ptzr_track
-        || (!force && ('a' != requested_ptzr_track->type) && ('v' != requested_ptzr_track->type))
-        || ( force && (128 * 1024 * 1024 >= num_queued_bytes)))
-      return FILE_STATUS_HOLDING;
+  if (m_cluster_pos_to_start_at) {
+    m_in->setFilePointer(*m_cluster_pos_to_start_at);
+    m_cluster_pos_to_start_at.reset();
   }
 
   try {
-    KaxCluster *cluster = m_in_file->read_next_cluster();
+    // Frames are handed to the packetizers as slices of the cluster's
+    // blocks. They keep the cluster alive as long as they're needed.
+    auto cluster = std::shared_ptr<KaxCluster>{m_in_file->read_next_cluster()};
     if (!cluster) {
       flush_packetizers();
 
@@ -2206,7 +2219,7 @@ kax_reader_c::read(generic_packetizer_c *requested_ptzr,
       return FILE_STATUS_DONE;
     }
 
-    auto cluster_tc = FindChildValue<KaxClusterTimecode>(cluster);
+    auto cluster_tc = FindChildValue<KaxClusterTimecode>(*cluster);
     cluster->InitTimecode(cluster_tc, m_tc_scale);
 
     if (-1 == m_first_timecode) {
@@ -2229,8 +2242,6 @@ kax_reader_c::read(generic_packetizer_c *requested_ptzr,
         process_block_group(cluster, static_cast<KaxBlockGroup *>(element));
     }
 
-    delete cluster;
-
   } catch (...) {
     mxwarn(boost::format("%1% %2% %3%\n")
            % (boost::format(Y("%1%: an unknown exception occurred.")) % "kax_reader_c::read()")
@@ -2243,7 +2254,7 @@ kax_reader_c::read(generic_packetizer_c *requested_ptzr,
 }
 
 void
-kax_reader_c::process_simple_block(KaxCluster *cluster,
+kax_reader_c::process_simple_block(std::shared_ptr<KaxCluster> const &cluster,
                                    KaxSimpleBlock *block_simple) {
   int64_t block_duration = -1;
   int64_t block_bref     = VFT_IFRAME;
@@ -2296,7 +2307,7 @@ kax_reader_c::process_simple_block(KaxCluster *cluster,
     size_t i;
     for (i = 0; block_simple->NumberFrames() > i; ++i) {
       DataBuffer &data_buffer = block_simple->GetBuffer(i);
-      memory_cptr data(new memory_c(data_buffer.Buffer(), data_buffer.Size(), false));
+      auto data               = memory_c::slice(cluster, data_buffer.Buffer(), data_buffer.Size());
       block_track->content_decoder.reverse(data, CONTENT_ENCODING_SCOPE_BLOCK);
       packet_cptr packet(new packet_t(data, m_last_timecode + i * frame_duration, block_duration, block_bref, block_fref));
 
@@ -2307,7 +2318,7 @@ kax_reader_c::process_simple_block(KaxCluster *cluster,
     size_t i;
     for (i = 0; i < block_simple->NumberFrames(); i++) {
       DataBuffer &data_buffer = block_simple->GetBuffer(i);
-      memory_cptr data(new memory_c(data_buffer.Buffer(), data_buffer.Size(), false));
+      auto data               = memory_c::slice(cluster, data_buffer.Buffer(), data_buffer.Size());
       block_track->content_decoder.reverse(data, CONTENT_ENCODING_SCOPE_BLOCK);
 
       if (('s' == block_track->type) && ('t' == block_track->sub_type)) {
@@ -2357,7 +2368,7 @@ kax_reader_c::process_block_group_common(KaxBlockGroup *block_group,
 }
 
 void
-kax_reader_c::process_block_group(KaxCluster *cluster,
+kax_reader_c::process_block_group(std::shared_ptr<KaxCluster> const &cluster,
                                   KaxBlockGroup *block_group) {
   auto block = FindChild<KaxBlock>(block_group);
   if (!block)
@@ -2431,10 +2442,10 @@ kax_reader_c::process_block_group(KaxCluster *cluster,
     size_t i;
     for (i = 0; i < block->NumberFrames(); i++) {
       auto &data_buffer = block->GetBuffer(i);
-      auto data         = std::make_shared<memory_c>(data_buffer.Buffer(), data_buffer.Size(), false);
+      auto data         = memory_c::slice(cluster, data_buffer.Buffer(), data_buffer.Size());
       block_track->content_decoder.reverse(data, CONTENT_ENCODING_SCOPE_BLOCK);
 
-      auto packet                = std::make_shared<packet_t>(data, m_last_timecode + i * frame_duration, block_duration, block_bref, block_fref);
+      auto packet                = packet_t::create(data, m_last_timecode + i * frame_duration, block_duration, block_bref, block_fref);
       packet->duration_mandatory = duration;
 
       process_block_group_common(block_group, packet.get(), *block_track);
@@ -2452,12 +2463,12 @@ kax_reader_c::process_block_group(KaxCluster *cluster,
 
   for (auto block_idx = 0u, num_frames = block->NumberFrames(); block_idx < num_frames; ++block_idx) {
     auto &data_buffer = block->GetBuffer(block_idx);
-    auto data         = std::make_shared<memory_c>(data_buffer.Buffer(), data_buffer.Size(), false);
+    auto data         = memory_c::slice(cluster, data_buffer.Buffer(), data_buffer.Size());
     block_track->content_decoder.reverse(data, CONTENT_ENCODING_SCOPE_BLOCK);
 
     if (('s' == block_track->type) && ('t' == block_track->sub_type)) {
       if ((2 < data->get_size()) || ((0 < data->get_size()) && (' ' != *data->get_buffer()) && (0 != *data->get_buffer()) && !iscr(*data->get_buffer()))) {
-        auto packet = std::make_shared<packet_t>(data, m_last_timecode, block_duration, block_bref, block_fref);
+        auto packet = packet_t::create(data, m_last_timecode, block_duration, block_bref, block_fref);
 
         process_block_group_common(block_group, packet.get(), *block_track);
 
@@ -2465,7 +2476,7 @@ kax_reader_c::process_block_group(KaxCluster *cluster,
       }
 
     } else {
-      auto packet = std::make_shared<packet_t>(data, m_last_timecode + block_idx * frame_duration, block_duration, block_bref, block_fref);
+      auto packet = packet_t::create(data, m_last_timecode + block_idx * frame_duration, block_duration, block_bref, block_fref);
 
       if ((duration) && !duration->GetValue())
         packet->duration_mandatory = true;
@@ -2591,6 +2602,99 @@ kax_reader_c::determine_global_timestamp_offset_to_apply() {
     m_global_timestamp_offset = global_minimum_timestamp.abs().to_ns();
 }
 
+void
+kax_reader_c::set_timecode_restrictions(timestamp_c const &min,
+                                        timestamp_c const &max) {
+  generic_reader_c::set_timecode_restrictions(min, max);
+
+  if (min.valid())
+    determine_cluster_pos_to_start_at();
+}
+
+/** \brief Find the cluster to start reading at if the beginning is discarded
+
+   Everything before the minimum restricted timestamp will be
+   discarded anyway. Therefore reading can start at the cluster
+   containing the last key frame before that timestamp. That key frame
+   is located via the cues. Only cue points for video tracks are
+   considered if the file contains video tracks as those are the ones
+   splitting is synchronized to.
+*/
+void
+kax_reader_c::determine_cluster_pos_to_start_at() {
+  static debugging_option_c s_debug{"kax_reader|timecode_restrictions"};
+
+  auto const &all_cues_positions = m_deferred_l1_positions[dl1t_cues];
+  if (all_cues_positions.empty())
+    return;
+
+  std::unordered_map<uint64_t, bool> video_track_numbers;
+  for (auto const &track : m_tracks)
+    if ('v' == track->type)
+      video_track_numbers[track->track_number] = true;
+
+  m_in->save_pos();
+  at_scope_exit_c restore{[this]() { m_in->restore_pos(); }};
+
+  timestamp_c best_timestamp;
+  uint64_t best_position{};
+
+  try {
+    for (auto cues_position : all_cues_positions) {
+      m_in->setFilePointer(cues_position);
+
+      int upper_lvl_el = 0;
+      auto l1          = std::shared_ptr<EbmlElement>(m_es->FindNextElement(EBML_CLASS_CONTEXT(KaxSegment), upper_lvl_el, 0xFFFFFFFFL, true));
+      auto cues        = dynamic_cast<KaxCues *>(l1.get());
+
+      if (!cues)
+        continue;
+
+      EbmlElement *l2 = nullptr;
+      upper_lvl_el    = 0;
+
+      cues->Read(*m_es, EBML_CLASS_CONTEXT(KaxCues), upper_lvl_el, l2, true);
+
+      for (auto const &cues_child : *cues) {
+        auto point = dynamic_cast<KaxCuePoint *>(cues_child);
+        if (!point)
+          continue;
+
+        auto timestamp = timestamp_c::ns(FindChildValue<KaxCueTime>(point) * m_tc_scale + m_global_timestamp_offset);
+        if ((timestamp >= m_restricted_timecodes_min) || (best_timestamp.valid() && (timestamp < best_timestamp)))
+          continue;
+
+        for (auto const &point_child : *point) {
+          auto positions = dynamic_cast<KaxCueTrackPositions *>(point_child);
+          if (!positions || !FindChild<KaxCueClusterPosition>(positions))
+            continue;
+
+          if (!video_track_numbers.empty() && !video_track_numbers[FindChildValue<KaxCueTrack>(positions)])
+            continue;
+
+          auto position = FindChildValue<KaxCueClusterPosition>(positions);
+          if (!best_timestamp.valid() || (timestamp > best_timestamp) || (position < best_position)) {
+            best_timestamp = timestamp;
+            best_position  = position;
+          }
+        }
+      }
+    }
+
+  } catch (...) {
+    return;
+  }
+
+  if (!best_timestamp.valid())
+    return;
+
+  m_cluster_pos_to_start_at = m_segment_data_start_pos + best_position;
+
+  mxdebug_if(s_debug,
+             boost::format("minimum restricted timestamp %1%: starting at cluster position %2% for key frame at %3%\n")
+             % m_restricted_timecodes_min % *m_cluster_pos_to_start_at % best_timestamp);
+}
+
 void
 kax_reader_c::identify() {
   auto info = mtx::id::info_c{};
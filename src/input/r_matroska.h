@@ -202,6 +202,7 @@ private:
     dl1t_tracks,
     dl1t_seek_head,
     dl1t_info,
+    dl1t_cues,
   };
 
   std::vector<kax_track_cptr> m_tracks;
@@ -215,6 +216,8 @@ private:
   std::shared_ptr<EbmlStream> m_es;
 
   int64_t m_segment_duration, m_last_timecode, m_first_timecode, m_global_timestamp_offset;
+  uint64_t m_segment_data_start_pos{};
+  boost::optional<uint64_t> m_cluster_pos_to_start_at;
   std::string m_title;
 
   using deferred_positions_t = std::map<deferred_l1_type_e, std::vector<int64_t> >;
@@ -244,6 +247,7 @@ public:
 
   virtual void read_headers();
   virtual file_status_e read(generic_packetizer_c *ptzr, bool force = false);
+  virtual void set_timecode_restrictions(timestamp_c const &min, timestamp_c const &max);
 
   virtual int get_progress();
   virtual void set_headers();
@@ -326,8 +330,8 @@ protected:
   virtual void read_deferred_level1_elements(KaxSegment &segment);
   virtual void find_level1_elements_via_analyzer();
 
-  virtual void process_simple_block(KaxCluster *cluster, KaxSimpleBlock *block_simple);
-  virtual void process_block_group(KaxCluster *cluster, KaxBlockGroup *block_group);
+  virtual void process_simple_block(std::shared_ptr<KaxCluster> const &cluster, KaxSimpleBlock *block_simple);
+  virtual void process_block_group(std::shared_ptr<KaxCluster> const &cluster, KaxBlockGroup *block_group);
   virtual void process_block_group_common(KaxBlockGroup *block_group, packet_t *packet, kax_track_t &track);
 
   void init_l1_position_storage(deferred_positions_t &storage);
@@ -335,6 +339,7 @@ protected:
 
   virtual void determine_minimum_timestamps();
   virtual void determine_global_timestamp_offset_to_apply();
+  virtual void determine_cluster_pos_to_start_at();
 };
 
 #endif  // MTX_INPUT_R_MATROSKA_H
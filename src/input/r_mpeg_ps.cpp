@@ -27,6 +27,7 @@
 #include "common/truehd.h"
 #include "input/r_mpeg_ps.h"
 #include "merge/file_status.h"
+#include "merge/queue_budget.h"
 #include "mpegparser/M2VParser.h"
 #include "output/p_ac3.h"
 #include "output/p_avc.h"
@@ -1308,12 +1309,11 @@ mpeg_ps_reader_c::read(generic_packetizer_c *requested_ptzr,
   if (file_done)
     return flush_packetizers();
 
-  auto num_queued_bytes = get_queued_bytes();
-  if (!force && (20 * 1024 * 1024 < num_queued_bytes)) {
-    mpeg_ps_track_ptr requested_ptzr_track = m_ptzr_to_track_map[requested_ptzr];
-    if (!requested_ptzr_track || (('a' != requested_ptzr_track->type) && ('v' != requested_ptzr_track->type)) || (64 * 1024 * 1024 < num_queued_bytes))
-      return FILE_STATUS_HOLDING;
-  }
+  mpeg_ps_track_ptr requested_ptzr_track = m_ptzr_to_track_map[requested_ptzr];
+  auto audio_or_video                    = requested_ptzr_track && (('a' == requested_ptzr_track->type) || ('v' == requested_ptzr_track->type));
+
+  if (queue_budget_c::get().must_hold(get_queued_bytes(), audio_or_video, force, 64 * 1024 * 1024))
+    return FILE_STATUS_HOLDING;
 
   try {
     mpeg_ps_id_t new_id;
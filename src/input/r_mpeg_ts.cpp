@@ -33,6 +33,7 @@
 #include "common/list_utils.h"
 #include "common/mpeg1_2.h"
 #include "common/mpeg4_p2.h"
+#include "common/parallel.h"
 #include "common/strings/formatting.h"
 #include "input/aac_framing_packet_converter.h"
 #include "input/bluray_pcm_channel_removal_packet_converter.h"
@@ -40,6 +41,7 @@
 #include "input/r_mpeg_ts.h"
 #include "input/teletext_to_srt_packet_converter.h"
 #include "input/truehd_ac3_splitting_packet_converter.h"
+#include "merge/queue_budget.h"
 #include "output/p_aac.h"
 #include "output/p_ac3.h"
 #include "output/p_avc.h"
@@ -145,7 +147,7 @@ track_c::send_to_packetizer() {
 
   if (use_packet) {
     auto bytes_to_skip = std::min<size_t>(pes_payload_read->get_size(), skip_packet_data_bytes);
-    process(std::make_shared<packet_t>(memory_c::clone(pes_payload_read->get_buffer() + bytes_to_skip, pes_payload_read->get_size() - bytes_to_skip), timestamp_to_use.to_ns(-1)));
+    process(packet_t::create(memory_c::clone(pes_payload_read->get_buffer() + bytes_to_skip, pes_payload_read->get_size() - bytes_to_skip), timestamp_to_use.to_ns(-1)));
 
     f.m_packet_sent_to_packetizer = true;
   }
@@ -1041,6 +1043,8 @@ reader_c::reader_c(const track_info_c &ti,
                    const mm_io_cptr &in)
   : generic_reader_c(ti, in)
   , m_current_file{}
+  , m_probe_concurrently{}
+  , m_queued_probe_bytes{}
   , m_dont_use_audio_pts{      "mpeg_ts|dont_use_audio_pts"}
   , m_debug_resync{            "mpeg_ts|resync"}
   , m_debug_pat_pmt{           "mpeg_ts|pat|pmt|headers"}
@@ -1107,6 +1111,9 @@ reader_c::read_headers_for_file(std::size_t file_num) {
 
       parse_packet(buf);
 
+      if (m_queued_probe_bytes >= 1024 * 1024)
+        probe_queued_pes_payloads();
+
       if (   f.m_pat_found
           && f.all_pmts_found()
           && (0 == f.m_es_to_process)
@@ -1117,6 +1124,8 @@ reader_c::read_headers_for_file(std::size_t file_num) {
       if (!eof)
         continue;
 
+      probe_queued_pes_payloads();
+
       // Determine if we haven't found a PAT or a PMT but have plenty
       // of CRC errors (e.g. for badly mastered discs). In such a case
       // we should read from the start again, this time ignoring the
@@ -1144,6 +1153,8 @@ reader_c::read_headers_for_file(std::size_t file_num) {
     mxdebug_if(m_debug_headers, boost::format("read_headers: caught exception\n"));
   }
 
+  probe_queued_pes_payloads();
+
   mxdebug_if(m_debug_headers, boost::format("read_headers: Detection done on %1% bytes\n") % f.m_in->getFilePointer());
 
   f.m_in->setFilePointer(0, seek_beginning); // rewind file for later remux
@@ -1161,6 +1172,11 @@ reader_c::read_headers_for_file(std::size_t file_num) {
 
 void
 reader_c::read_headers() {
+  m_probe_concurrently = (1 < mtx::parallel::default_num_threads())
+                      && !m_debug_headers
+                      && (verbose < 2)
+                      && !debugging_c::requested("mpeg_ts_no_parallel_probing");
+
   for (std::size_t idx = 0, num_files = m_files.size(); idx < num_files; ++idx)
     read_headers_for_file(idx);
 
@@ -1879,7 +1895,7 @@ reader_c::parse_pes(track_c &track) {
   }
 
   if (processing_state_e::probing == f.m_state)
-    probe_packet_complete(track);
+    probe_or_queue_pes_payload(track);
 
   else
     track.send_to_packetizer();
@@ -2096,6 +2112,73 @@ reader_c::probe_packet_complete(track_c &track) {
     return;
   }
 
+  handle_probe_result(track, probe_pes_payload(track));
+}
+
+void
+reader_c::probe_or_queue_pes_payload(track_c &track) {
+  // Parsing the content of audio and video tracks can take a while,
+  // e.g. until an AVC or HEVC parser has found all parameter sets. If
+  // allowed the complete PES payloads are only collected here and
+  // handed to the parsers in batches with one thread per track, see
+  // probe_queued_pes_payloads(). Tracks whose type must still be
+  // determined from their content are handled right away as the
+  // outcome influences which packets are collected.
+  if (   !m_probe_concurrently
+      || track.probed_ok
+      || !mtx::included_in(track.type, pid_type_e::audio, pid_type_e::video, pid_type_e::subtitles)) {
+    probe_packet_complete(track);
+    return;
+  }
+
+  auto size = track.pes_payload_read->get_size();
+
+  track.m_queued_probe_payloads.emplace_back(memory_c::clone(track.pes_payload_read->get_buffer(), size));
+  track.clear_pes_payload();
+
+  m_queued_probe_bytes += size;
+}
+
+void
+reader_c::probe_queued_pes_payloads() {
+  auto tracks = std::vector<track_c *>{};
+
+  for (auto const &track : m_tracks)
+    if (!track->m_queued_probe_payloads.empty())
+      tracks.push_back(track.get());
+
+  m_queued_probe_bytes = 0;
+
+  if (tracks.empty())
+    return;
+
+  // Each track's payloads are parsed in the order they were read, and
+  // only the parser state of that track (and of its coupled tracks) is
+  // modified. The results are applied in track order afterwards so
+  // that the outcome is the same as when probing each packet right
+  // after it has been read.
+  auto results = std::vector<int>(tracks.size(), -1);
+
+  mtx::parallel::for_each_index(tracks.size(), [this, &tracks, &results](std::size_t idx) {
+    auto &track = *tracks[idx];
+
+    for (auto const &payload : track.m_queued_probe_payloads) {
+      track.pes_payload_read->add(payload->get_buffer(), payload->get_size());
+      results[idx] = probe_pes_payload(track);
+
+      if (0 == results[idx])
+        break;
+    }
+
+    track.m_queued_probe_payloads.clear();
+  });
+
+  for (auto idx = 0u; idx < tracks.size(); ++idx)
+    handle_probe_result(*tracks[idx], results[idx]);
+}
+
+int
+reader_c::probe_pes_payload(track_c &track) {
   int result = -1;
 
   try {
@@ -2105,6 +2188,12 @@ reader_c::probe_packet_complete(track_c &track) {
 
   track.clear_pes_payload();
 
+  return result;
+}
+
+void
+reader_c::handle_probe_result(track_c &track,
+                              int result) {
   if (result != 0) {
     mxdebug_if(m_debug_headers, (result == FILE_STATUS_MOREDATA) ? "probe_packet_complete: Need more data to probe ES\n" : "probe_packet_complete: Failed to parse packet. Reset and retry\n");
     track.processed = false;
@@ -2349,16 +2438,12 @@ reader_c::read(generic_packetizer_c *requested_ptzr,
   if (!requested_ptzr_track)
     return flush_packetizers();
 
-  m_current_file        = requested_ptzr_track->m_file_num;
-  auto &f               = file();
-  auto num_queued_bytes = f.get_queued_bytes();
+  m_current_file = requested_ptzr_track->m_file_num;
+  auto &f        = file();
 
-  if (!force && (20 * 1024 * 1024 < num_queued_bytes)) {
-    if (   !requested_ptzr_track
-        || !mtx::included_in(requested_ptzr_track->type, pid_type_e::audio, pid_type_e::video)
-        || (512 * 1024 * 1024 < num_queued_bytes))
-      return FILE_STATUS_HOLDING;
-  }
+  // Badly interleaved transport streams require large queues.
+  if (queue_budget_c::get().must_hold(f.get_queued_bytes(), mtx::included_in(requested_ptzr_track->type, pid_type_e::audio, pid_type_e::video), force, 512 * 1024 * 1024))
+    return FILE_STATUS_HOLDING;
 
   f.m_packet_sent_to_packetizer = false;
 
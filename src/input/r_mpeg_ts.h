@@ -328,6 +328,7 @@ public:
   truehd_parser_cptr m_truehd_parser;
   std::shared_ptr<M2VParser> m_m2v_parser;
   mtx::vc1::es_parser_cptr m_vc1_parser;
+  std::vector<memory_cptr> m_queued_probe_payloads;
 
   unsigned int skip_packet_data_bytes;
 
@@ -425,6 +426,9 @@ protected:
 
   std::vector<timestamp_c> m_chapter_timestamps;
 
+  bool m_probe_concurrently;
+  std::size_t m_queued_probe_bytes;
+
   debugging_option_c m_dont_use_audio_pts, m_debug_resync, m_debug_pat_pmt, m_debug_sdt, m_debug_headers, m_debug_packet, m_debug_aac, m_debug_timestamp_wrapping, m_debug_clpi, m_debug_mpls;
 
 protected:
@@ -471,6 +475,10 @@ private:
   void parse_sdt_service_desciptor(bit_reader_c &r, uint16_t program_number);
   void parse_pes(track_c &track);
   void probe_packet_complete(track_c &track);
+  void probe_or_queue_pes_payload(track_c &track);
+  void probe_queued_pes_payloads();
+  int probe_pes_payload(track_c &track);
+  void handle_probe_result(track_c &track, int result);
   int determine_track_parameters(track_c &track);
   void determine_track_type_by_pes_content(track_c &track);
 
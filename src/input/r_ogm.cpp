@@ -35,6 +35,7 @@
 #include "merge/file_status.h"
 #include "merge/input_x.h"
 #include "merge/output_control.h"
+#include "merge/queue_budget.h"
 #include "output/p_aac.h"
 #include "output/p_ac3.h"
 #include "output/p_avc.h"
@@ -679,10 +680,10 @@ ogm_reader_c::read_headers_internal() {
 */
 file_status_e
 ogm_reader_c::read(generic_packetizer_c *,
-                   bool) {
+                   bool force) {
   // Some tracks may contain huge gaps. We don't want to suck in the complete
   // file.
-  if (get_queued_bytes() > 20 * 1024 * 1024)
+  if (queue_budget_c::get().must_hold(get_queued_bytes(), false, force))
     return FILE_STATUS_HOLDING;
 
   ogg_page og;
@@ -1199,7 +1200,7 @@ ogm_a_opus_demuxer_c::process_page(int64_t granulepos) {
     if ((4 <= op.bytes) && !memcmp(op.packet, "Opus", 4))
       continue;
 
-    auto packet                = std::make_shared<packet_t>(memory_c::clone(op.packet, op.bytes));
+    auto packet                = packet_t::create(memory_c::clone(op.packet, op.bytes));
     auto toc                   = mtx::opus::toc_t::decode(packet->data);
     m_calculated_end_timecode += toc.packet_duration;
 
@@ -60,6 +60,7 @@
 using namespace libmatroska;
 
 #define MAX_INTERLEAVING_BADNESS 0.4
+#define NUM_FRAGMENTS_PER_WINDOW 16
 
 namespace mtx {
 
@@ -163,6 +164,7 @@ qtmp4_reader_c::qtmp4_reader_c(const track_info_c &ti,
   , m_fragment_implicit_offset{}
   , m_fragment{}
   , m_track_for_fragment{}
+  , m_index_fragments_lazily{}
   , m_timecodes_calculated{}
   , m_debug_chapters{    "qtmp4|qtmp4_full|qtmp4_chapters"}
   , m_debug_headers{     "qtmp4|qtmp4_full|qtmp4_headers"}
@@ -254,6 +256,16 @@ qtmp4_reader_c::parse_headers() {
 
   bool headers_parsed = false;
   bool mdat_found     = false;
+  auto num_moofs      = 0u;
+
+  // Fragmented files are only indexed up to the first window of
+  // fragments in which all fragmented tracks have samples. The
+  // remaining fragments are indexed while reading.
+  auto first_window_complete = [this, &num_moofs]() -> bool {
+    return m_index_fragments_lazily
+        && (NUM_FRAGMENTS_PER_WINDOW <= num_moofs)
+        && brng::none_of(m_demuxers, [this](qtmp4_demuxer_cptr const &dmx) { return mtx::includes(m_track_defaults, dmx->container_id) && dmx->sample_table.empty(); });
+  };
 
   try {
     while (!m_in->eof()) {
@@ -282,9 +294,22 @@ qtmp4_reader_c::parse_headers() {
         skip_atom();
         mdat_found = true;
 
+        if (first_window_complete()) {
+          m_next_fragment_pos = m_in->getFilePointer();
+          break;
+        }
+
       } else if (atom.fourcc == "moof") {
+        if (!num_moofs)
+          m_index_fragments_lazily = headers_parsed && can_index_fragments_lazily();
+        ++num_moofs;
+
         handle_moof_atom(atom.to_parent(), 0, atom);
 
+      } else if (atom.fourcc == "sidx") {
+        handle_sidx_atom(atom.to_parent(), 0);
+        skip_atom();
+
       } else if (atom.fourcc.human_readable())
         skip_atom();
 
@@ -300,6 +325,17 @@ qtmp4_reader_c::parse_headers() {
   if (!mdat_found)
     mxerror(Y("Quicktime/MP4 reader: Have not found the 'mdat' atom. No movie data found.\n"));
 
+  if (m_index_fragments_lazily) {
+    for (auto &dmx : m_demuxers)
+      if (!dmx->m_fragments.empty())
+        dmx->m_first_fragment_decode_time = dmx->m_fragments.front().base_media_decode_time;
+
+    if (m_next_fragment_pos)
+      read_fragment_random_access_atoms();
+
+    mxdebug_if(m_debug_headers, boost::format("Indexing fragments lazily; first window: %1% moof atoms; next window at %2%\n") % num_moofs % (m_next_fragment_pos ? to_string(*m_next_fragment_pos) : std::string{"none"}));
+  }
+
   verify_track_parameters_and_update_indexes();
 
   read_chapter_track();
@@ -380,6 +416,9 @@ qtmp4_reader_c::calculate_timecodes() {
     }
   }
 
+  for (auto &dmx : m_demuxers)
+    dmx->free_tables();
+
   m_timecodes_calculated = true;
 }
 
@@ -796,6 +835,9 @@ qtmp4_reader_c::handle_traf_atom(qt_atom_t parent,
     else if (atom.fourcc == "trun")
       handle_trun_atom(atom.to_parent(), level + 1);
 
+    else if (atom.fourcc == "tfdt")
+      handle_tfdt_atom(atom.to_parent(), level + 1);
+
     else if (atom.fourcc == "edts") {
       if (m_track_for_fragment)
         handle_edts_atom(*m_track_for_fragment, atom.to_parent(), level + 1);
@@ -925,6 +967,96 @@ qtmp4_reader_c::handle_trun_atom(qt_atom_t,
             % all_sample_flags[idx]);
 }
 
+void
+qtmp4_reader_c::handle_tfdt_atom(qt_atom_t,
+                                 int level) {
+  if (!m_fragment)
+    return;
+
+  auto version     = m_in->read_uint8();
+  m_in->skip(3);                // Flags
+  auto decode_time = 1 == version ? m_in->read_uint64_be() : m_in->read_uint32_be();
+
+  m_fragment->base_media_decode_time.reset(decode_time);
+
+  mxdebug_if(m_debug_headers, boost::format("%1%Base media decode time: %2%\n") % space(level * 2 + 1) % decode_time);
+}
+
+void
+qtmp4_reader_c::handle_sidx_atom(qt_atom_t parent,
+                                 int level) {
+  auto version    = m_in->read_uint8();
+  m_in->skip(3);                // Flags
+  auto track_id   = m_in->read_uint32_be();
+  auto time_scale = m_in->read_uint32_be();
+  auto time       = 1 == version ? m_in->read_uint64_be() : m_in->read_uint32_be();
+  auto offset     = 1 == version ? m_in->read_uint64_be() : m_in->read_uint32_be();
+  m_in->skip(2);                // Reserved
+  auto count      = m_in->read_uint16_be();
+
+  // Offsets are relative to the first byte after the 'sidx' atom.
+  offset += parent.pos + parent.size;
+
+  for (auto idx = 0u; idx < count; ++idx) {
+    auto type_and_size = m_in->read_uint32_be();
+    auto duration      = m_in->read_uint32_be();
+    auto sap_flags     = m_in->read_uint32_be();
+
+    // Only references to media (as opposed to other 'sidx' atoms)
+    // starting with a stream access point are useful for seeking.
+    if (!(type_and_size & 0x80000000) && (sap_flags & 0x80000000) && time_scale)
+      m_fragment_entry_points.emplace_back(track_id, time, time_scale, offset);
+
+    offset += type_and_size & 0x7fffffff;
+    time   += duration;
+  }
+
+  mxdebug_if(m_debug_headers, boost::format("%1%Segment index for track ID %2%: %3% references\n") % space(level * 2 + 1) % track_id % count);
+}
+
+void
+qtmp4_reader_c::handle_mfra_atom(qt_atom_t parent,
+                                 int level) {
+  while (8 <= parent.size) {
+    qt_atom_t atom = read_atom();
+    print_basic_atom_info();
+
+    if (atom.fourcc == "tfra")
+      handle_tfra_atom(atom.to_parent(), level + 1);
+
+    skip_atom();
+    parent.size -= atom.size;
+  }
+}
+
+void
+qtmp4_reader_c::handle_tfra_atom(qt_atom_t,
+                                 int level) {
+  auto version   = m_in->read_uint8();
+  m_in->skip(3);                // Flags
+  auto track_id  = m_in->read_uint32_be();
+  auto sizes     = m_in->read_uint32_be();
+  auto count     = m_in->read_uint32_be();
+  auto track_itr = brng::find_if(m_demuxers, [track_id](qtmp4_demuxer_cptr const &dmx) { return dmx->container_id == track_id; });
+
+  if (m_demuxers.end() == track_itr)
+    return;
+
+  // The sizes of the traf, trun and sample numbers following each
+  // entry are stored as "size in bytes - 1".
+  auto num_skipped_bytes = ((sizes >> 4) & 0x03) + ((sizes >> 2) & 0x03) + (sizes & 0x03) + 3;
+
+  for (auto idx = 0u; idx < count; ++idx) {
+    auto time        = 1 == version ? m_in->read_uint64_be() : m_in->read_uint32_be();
+    auto moof_offset = 1 == version ? m_in->read_uint64_be() : m_in->read_uint32_be();
+
+    m_in->skip(num_skipped_bytes);
+    m_fragment_entry_points.emplace_back(track_id, time, (*track_itr)->time_scale, moof_offset);
+  }
+
+  mxdebug_if(m_debug_headers, boost::format("%1%Track fragment random access entries for track ID %2%: %3%\n") % space(level * 2 + 1) % track_id % count);
+}
+
 void
 qtmp4_reader_c::handle_mvhd_atom(qt_atom_t atom,
                                  int level) {
@@ -1548,6 +1680,7 @@ file_status_e
 qtmp4_reader_c::read(generic_packetizer_c *ptzr,
                      bool) {
   size_t dmx_idx;
+  qtmp4_demuxer_c *requested_dmx = nullptr;
 
   for (dmx_idx = 0; dmx_idx < m_demuxers.size(); ++dmx_idx) {
     auto &dmx = *m_demuxers[dmx_idx];
@@ -1555,15 +1688,17 @@ qtmp4_reader_c::read(generic_packetizer_c *ptzr,
     if ((-1 == dmx.ptzr) || (PTZR(dmx.ptzr) != ptzr))
       continue;
 
+    requested_dmx = &dmx;
+
     if (dmx.pos < dmx.m_index.size())
       break;
   }
 
   if (m_demuxers.size() == dmx_idx)
-    return flush_packetizers();
+    return requested_dmx ? load_next_fragments_for(*requested_dmx) : flush_packetizers();
 
  auto &dmx   = *m_demuxers[dmx_idx];
- auto &index = dmx.m_index[dmx.pos];
+ auto index  = dmx.m_index[dmx.pos];
 
   m_in->setFilePointer(index.file_pos);
 
@@ -1572,6 +1707,7 @@ qtmp4_reader_c::read(generic_packetizer_c *ptzr,
 
   if (   dmx.is_video()
       && !dmx.pos
+      && !dmx.m_num_dropped_index_entries
       && dmx.codec.is(codec_c::type_e::V_MPEG4_P2)
       && dmx.esds_parsed
       && (dmx.esds.decoder_config)) {
@@ -1601,7 +1737,7 @@ qtmp4_reader_c::read(generic_packetizer_c *ptzr,
   PTZR(dmx.ptzr)->process(new packet_t(buffer, index.timecode, duration, index.is_keyframe ? VFT_IFRAME : VFT_PFRAMEAUTOMATIC, VFT_NOBFRAME));
   ++dmx.pos;
 
-  if (dmx.pos < dmx.m_index.size())
+  if ((dmx.pos < dmx.m_index.size()) || m_next_fragment_pos)
     return FILE_STATUS_MOREDATA;
 
   return flush_packetizers();
@@ -1879,15 +2015,270 @@ qtmp4_reader_c::create_packetizers() {
     create_packetizer(m_demuxers[i]->id);
 }
 
+void
+qtmp4_reader_c::set_timecode_restrictions(timestamp_c const &min,
+                                          timestamp_c const &max) {
+  generic_reader_c::set_timecode_restrictions(min, max);
+
+  if (min.valid())
+    determine_start_positions();
+}
+
+/** \brief Skip samples that would be discarded anyway
+
+   Everything before the minimum restricted timestamp will be
+   discarded. Therefore reading can start at the last key frame before
+   that timestamp (the earliest one if there are several video
+   tracks). The other tracks start at their last sample before that
+   key frame.
+*/
+void
+qtmp4_reader_c::determine_start_positions() {
+  auto min_timestamp = m_restricted_timecodes_min.to_ns();
+  boost::optional<int64_t> start_timestamp;
+
+  if (m_index_fragments_lazily)
+    skip_fragments_before(min_timestamp);
+
+  for (auto const &dmx : m_demuxers) {
+    if (!dmx->is_video() || dmx->m_index.empty())
+      continue;
+
+    // The decoder configuration is only prepended to the very first
+    // frame; such tracks must be read from the start.
+    if (dmx->codec.is(codec_c::type_e::V_MPEG4_P2) && dmx->esds_parsed && dmx->esds.decoder_config)
+      return;
+
+    boost::optional<int64_t> key_frame_timestamp;
+    for (auto const &index : dmx->m_index)
+      if (index.is_keyframe && (index.timecode < min_timestamp) && (!key_frame_timestamp || (index.timecode > *key_frame_timestamp)))
+        key_frame_timestamp = index.timecode;
+
+    if (!key_frame_timestamp)
+      return;
+
+    if (!start_timestamp || (*key_frame_timestamp < *start_timestamp))
+      start_timestamp = key_frame_timestamp;
+  }
+
+  if (!start_timestamp)
+    start_timestamp = min_timestamp;
+
+  for (auto &dmx : m_demuxers) {
+    auto is_video = dmx->is_video();
+
+    for (auto idx = 0u, num_entries = static_cast<unsigned int>(dmx->m_index.size()); idx < num_entries; ++idx) {
+      auto const &index = dmx->m_index[idx];
+
+      if (is_video ? (index.is_keyframe && (index.timecode <= *start_timestamp)) : (index.timecode < *start_timestamp))
+        dmx->pos = idx;
+    }
+
+    mxdebug_if(m_debug_headers, boost::format("Minimum restricted timestamp %1%: track %2% starts at index entry %3%\n") % m_restricted_timecodes_min % dmx->id % dmx->pos);
+  }
+}
+
+/** \brief Whether or not fragments can be indexed while reading
+
+   The samples of fragmented files are normally indexed a window of
+   fragments at a time. This isn't possible if the 'moov' atom
+   contains samples itself, if a track uses a constant sample size,
+   if chapters are stored in a track or if an edit list consists of
+   more than one edit as all of them require knowing all samples in
+   advance.
+*/
+bool
+qtmp4_reader_c::can_index_fragments_lazily()
+  const {
+  if (!m_chapter_track_ids.empty())
+    return false;
+
+  for (auto const &dmx : m_demuxers) {
+    auto num_edits = brng::count_if(dmx->editlist_table, [](qt_editlist_t const &edit) { return edit.media_time != -1; });
+    if (!dmx->chunk_table.empty() || (0 != dmx->sample_size) || (1 < num_edits))
+      return false;
+  }
+
+  return true;
+}
+
+void
+qtmp4_reader_c::read_fragment_random_access_atoms() {
+  // The 'mfro' atom at the very end of the file contains the size of
+  // the 'mfra' atom it is the last part of.
+  try {
+    if (m_size < 16)
+      return;
+
+    m_in->setFilePointer(m_size - 16);
+    if ((m_in->read_uint32_be() != 16) || (fourcc_c{m_in} != "mfro"))
+      return;
+
+    m_in->skip(4);              // Version, flags
+    auto mfra_size = m_in->read_uint32_be();
+    if ((mfra_size < 16) || (mfra_size > m_size))
+      return;
+
+    m_in->setFilePointer(m_size - mfra_size);
+    auto atom = read_atom(nullptr, false);
+    if ((atom.fourcc != "mfra") || (atom.size != mfra_size))
+      return;
+
+    handle_mfra_atom(atom.to_parent(), 0);
+
+  } catch (mtx::mm_io::exception &) {
+  } catch (mtx::atom_chunk_size_x &) {
+  }
+}
+
+/** \brief Index the next window of fragments
+
+   Called when one of the tracks has run out of index entries. The
+   entries already read are removed from all tracks' indexes, and the
+   samples of the next \c NUM_FRAGMENTS_PER_WINDOW 'moof' atoms are
+   added.
+
+   If \c resync_to_decode_time is \c true then fragments have been
+   skipped, and the tracks' timestamps are derived from the
+   fragments' base media decode times instead of continuing from the
+   previous window.
+*/
+bool
+qtmp4_reader_c::load_next_fragments(bool resync_to_decode_time) {
+  if (!m_next_fragment_pos)
+    return false;
+
+  for (auto &dmx : m_demuxers)
+    dmx->prepare_for_next_fragments();
+
+  auto window_start = *m_next_fragment_pos;
+  auto num_moofs    = 0u;
+
+  m_next_fragment_pos.reset();
+  m_in->setFilePointer(window_start);
+
+  try {
+    while (!m_in->eof()) {
+      auto atom = read_atom();
+
+      if (atom.fourcc == "moof") {
+        handle_moof_atom(atom.to_parent(), 0, atom);
+        ++num_moofs;
+
+      } else if (atom.fourcc.human_readable()) {
+        skip_atom();
+
+        if ((atom.fourcc == "mdat") && (NUM_FRAGMENTS_PER_WINDOW <= num_moofs)) {
+          m_next_fragment_pos = m_in->getFilePointer();
+          break;
+        }
+
+      } else if (!resync_to_top_level_atom(atom.pos))
+        break;
+    }
+  } catch (mtx::mm_io::exception &) {
+  }
+
+  for (auto &dmx : m_demuxers)
+    dmx->index_next_fragments(resync_to_decode_time);
+
+  mxdebug_if(m_debug_headers, boost::format("Indexed window of %1% moof atoms at %2%; next window at %3%\n") % num_moofs % window_start % (m_next_fragment_pos ? to_string(*m_next_fragment_pos) : std::string{"none"}));
+
+  return true;
+}
+
+/** \brief Load fragments for a track without samples left
+
+   The track \c dmx has consumed all of its samples. The next window
+   of fragments is only loaded once the other tracks have consumed
+   theirs, too. Until then and as long as further windows remain
+   without samples for the track, \c FILE_STATUS_HOLDING is returned
+   so that the muxer can continue with the other tracks instead of
+   pulling this one until a packet is available, which would load all
+   remaining windows at once for sparse tracks, e.g. subtitles. The
+   track's packetizer is only flushed at the end of the file.
+*/
+file_status_e
+qtmp4_reader_c::load_next_fragments_for(qtmp4_demuxer_c &dmx) {
+  for (auto const &other_dmx : m_demuxers)
+    if ((-1 != other_dmx->ptzr) && (other_dmx->pos < other_dmx->m_index.size()))
+      return FILE_STATUS_HOLDING;
+
+  if (!load_next_fragments())
+    return flush_packetizer(dmx.ptzr);
+
+  if (dmx.pos < dmx.m_index.size())
+    return FILE_STATUS_MOREDATA;
+
+  return m_next_fragment_pos ? FILE_STATUS_HOLDING : flush_packetizer(dmx.ptzr);
+}
+
+/** \brief Skip whole fragments before the minimum restricted timestamp
+
+   If the file contains a segment index ('sidx') or a movie fragment
+   random access atom ('mfra') then indexing can continue right at
+   the fragment containing the last random access point before the
+   given timestamp. The timestamps are then derived from the
+   fragments' base media decode times; therefore all tracks must
+   provide them.
+*/
+void
+qtmp4_reader_c::skip_fragments_before(int64_t timestamp) {
+  if (!m_next_fragment_pos || m_fragment_entry_points.empty() || m_demuxers.empty())
+    return;
+
+  for (auto const &dmx : m_demuxers)
+    if (   !dmx->m_first_fragment_decode_time
+        || (dmx->codec.is(codec_c::type_e::V_MPEG4_P2) && dmx->esds_parsed && dmx->esds.decoder_config))
+      return;
+
+  auto dmx_itr   = brng::find_if(m_demuxers, [](qtmp4_demuxer_cptr const &dmx) { return dmx->is_video(); });
+  auto &main_dmx = dmx_itr != m_demuxers.end() ? **dmx_itr : *m_demuxers.front();
+  auto offset    = main_dmx.m_fragment_timestamp_offset - main_dmx.to_nsecs(*main_dmx.m_first_fragment_decode_time);
+
+  std::vector<std::pair<int64_t, uint64_t>> entry_points;
+  for (auto const &entry_point : m_fragment_entry_points)
+    if (entry_point.track_id == main_dmx.container_id)
+      entry_points.emplace_back(main_dmx.to_nsecs(entry_point.time, entry_point.time_scale) + offset, entry_point.moof_offset);
+
+  brng::sort(entry_points);
+
+  // The timestamps derived from the entry points may differ slightly
+  // from the ones calculated from the samples. Therefore start one
+  // entry point earlier than necessary.
+  boost::optional<uint64_t> previous_moof_offset, moof_offset;
+  for (auto const &entry_point : entry_points) {
+    if (entry_point.first >= timestamp)
+      break;
+
+    previous_moof_offset = moof_offset;
+    moof_offset          = entry_point.second;
+  }
+
+  // Fragments in the current window have been indexed already.
+  if (!previous_moof_offset || (*previous_moof_offset < *m_next_fragment_pos))
+    return;
+
+  mxdebug_if(m_debug_headers, boost::format("Skipping fragments before %1%: continuing at moof atom at %2%\n") % format_timestamp(timestamp) % *previous_moof_offset);
+
+  for (auto &dmx : m_demuxers)
+    dmx->pos = dmx->m_index.size();
+
+  m_next_fragment_pos = previous_moof_offset;
+  load_next_fragments(true);
+}
+
 int
 qtmp4_reader_c::get_progress() {
   if (-1 == m_main_dmx)
     return 100;
 
   auto &dmx       = *m_demuxers[m_main_dmx];
-  auto max_chunks = (0 == dmx.sample_size) ? dmx.sample_table.size() : dmx.chunk_table.size();
 
-  return 100 * dmx.pos / max_chunks;
+  if (m_index_fragments_lazily)
+    return dmx.pos < dmx.m_index.size() ? 100 * dmx.m_index[dmx.pos].file_pos / m_size : 100;
+
+  return dmx.m_index.empty() ? 100 : 100 * dmx.pos / dmx.m_index.size();
 }
 
 void
@@ -2083,7 +2474,6 @@ qtmp4_demuxer_c::calculate_timecodes_constant_sample_size() {
 
     timecodes.push_back(to_nsecs(static_cast<uint64_t>(chunk.samples) * duration + frame_offset));
     durations.push_back(to_nsecs(static_cast<uint64_t>(chunk.size)    * duration));
-    frame_indices.push_back(chunk_index);
 
     ++chunk_index;
   }
@@ -2094,25 +2484,21 @@ qtmp4_demuxer_c::calculate_timecodes_variable_sample_size() {
   auto const num_frame_offsets = frame_offset_table.size();
   auto const num_samples       = sample_table.size();
 
-  std::vector<int64_t> timecodes_before_offsets;
-
   timecodes.reserve(num_samples);
-  timecodes_before_offsets.reserve(num_samples);
   durations.reserve(num_samples);
-  frame_indices.reserve(num_samples);
 
   for (unsigned int frame = 0; num_samples > frame; ++frame) {
     auto timecode = to_nsecs(sample_table[frame].pts);
-
-    frame_indices.push_back(frame);
-    timecodes_before_offsets.push_back(timecode);
     timecodes.push_back(timecode + (frame < num_frame_offsets ? to_nsecs(frame_offset_table[frame]) : 0));
   }
 
   int64_t avg_duration = 0, num_good_frames = 0;
+  auto previous_timecode = num_samples ? to_nsecs(sample_table[0].pts) : 0;
 
   for (unsigned int frame = 0; num_samples > (frame + 1); ++frame) {
-    int64_t diff = timecodes_before_offsets[frame + 1] - timecodes_before_offsets[frame];
+    auto timecode     = to_nsecs(sample_table[frame + 1].pts);
+    int64_t diff      = timecode - previous_timecode;
+    previous_timecode = timecode;
 
     if (0 >= diff)
       durations.push_back(0);
@@ -2163,8 +2549,9 @@ qtmp4_demuxer_c::adjust_timecodes(int64_t delta) {
   for (auto &timecode : timecodes)
     timecode += delta;
 
-  for (auto &index : m_index)
-    index.timecode += delta;
+  m_index.adjust_timecodes(delta);
+
+  m_fragment_timestamp_offset += delta;
 }
 
 boost::optional<int64_t>
@@ -2244,7 +2631,7 @@ qtmp4_demuxer_c::update_tables() {
   // calc pts:
   auto num_samples = sample_table.size();
   s                = 0;
-  uint64_t pts     = 0;
+  uint64_t pts     = m_next_pts;
 
   for (j = 0; (j < durmap_table.size()) && (s < num_samples); ++j) {
     for (i = 0; (i < durmap_table[j].number) && (s < num_samples); ++i) {
@@ -2254,6 +2641,8 @@ qtmp4_demuxer_c::update_tables() {
     }
   }
 
+  m_next_pts = pts;
+
   if (s < num_samples) {
     mxdebug_if(m_debug_headers, boost::format("Track %1%: fewer timestamps assigned than entries in the sample table: %2% < %3%; dropping the excessive items\n") % id % s % num_samples);
     sample_table.resize(s);
@@ -2306,13 +2695,19 @@ qtmp4_demuxer_c::apply_edit_list() {
              boost::format("Applying edit list for track %1%: %2% entries; track time scale %3%, global time scale %4%\n")
              % id % editlist_table.size() % time_scale % m_reader.m_time_scale);
 
-  std::vector<qt_index_t> edited_index;
+  mtx::frame_index_c edited_index;
+  std::vector<int64_t> index_timecodes;
 
   auto const num_edits         = editlist_table.size();
   auto const num_index_entries = m_index.size();
-  auto const index_begin       = m_index.begin();
-  auto const index_end         = m_index.end();
   auto const global_time_scale = m_reader.m_time_scale;
+
+  // Entries used by one edit are searched with their new timestamps
+  // by the following edits.
+  index_timecodes.reserve(num_index_entries);
+  for (auto const &entry : m_index)
+    index_timecodes.emplace_back(entry.timecode);
+
   auto timeline_cts            = int64_t{};
   auto info_fmt                = boost::format("%1% [segment_duration %2% media_time %3% media_rate %4%/%5%]");
   auto entry_index             = 0;
@@ -2354,26 +2749,35 @@ qtmp4_demuxer_c::apply_edit_list() {
     auto const edit_duration  = to_nsecs(edit.segment_duration, global_time_scale);
     auto const edit_start_cts = to_nsecs(edit.media_time);
     auto const edit_end_cts   = edit_start_cts + edit_duration;
-    auto itr                  = boost::range::find_if(m_index, [edit_start_cts](auto const &entry) { return (entry.timecode + entry.duration - (entry.duration > 0 ? 1 : 0)) >= edit_start_cts; });
-    auto const frame_idx      = static_cast<uint64_t>(std::distance(index_begin, itr));
+    auto frame_idx            = std::size_t{};
+
+    for (; frame_idx < num_index_entries; ++frame_idx) {
+      auto duration = m_index[frame_idx].duration;
+      if ((index_timecodes[frame_idx] + duration - (duration > 0 ? 1 : 0)) >= edit_start_cts)
+        break;
+    }
 
     mxdebug_if(m_debug_editlists,
                boost::format("  %1%: normal entry; first frame %2% edit CTS %3%–%4% at timeline CTS %5%\n")
                % info % (frame_idx >= num_index_entries ? -1 : frame_idx) % format_timestamp(edit_start_cts) % format_timestamp(edit_end_cts) % format_timestamp(timeline_cts));
 
     // Find active key frame.
-    while ((itr != index_end) && (itr > index_begin) && !itr->is_keyframe) {
-      --itr;
+    auto idx = frame_idx;
+    while ((idx < num_index_entries) && (idx > 0) && !m_index[idx].is_keyframe) {
+      --idx;
     }
 
-    while ((itr < index_end) && (!edit_duration || (itr->timecode < edit_end_cts))) {
-      itr->timecode = timeline_cts + itr->timecode - edit_start_cts;
-      edited_index.emplace_back(*itr);
+    while ((idx < num_index_entries) && (!edit_duration || (index_timecodes[idx] < edit_end_cts))) {
+      auto entry           = m_index[idx];
+      index_timecodes[idx] = timeline_cts + index_timecodes[idx] - edit_start_cts;
+      entry.timecode       = index_timecodes[idx];
+      edited_index.push_back(entry);
 
-      ++itr;
+      ++idx;
     }
 
-    timeline_cts += edit_end_cts - edit_start_cts;
+    m_fragment_timestamp_offset  = timeline_cts - edit_start_cts;
+    timeline_cts                += edit_end_cts - edit_start_cts;
   }
 
   m_index = std::move(edited_index);
@@ -2391,7 +2795,7 @@ qtmp4_demuxer_c::dump_index_entries(std::string const &message)
   auto end = std::min<std::size_t>(!m_debug_indexes_full ? 20 : std::numeric_limits<std::size_t>::max(), m_index.size());
 
   for (auto idx = 0u; idx < end; ++idx) {
-    auto const &entry = m_index[idx];
+    auto entry = m_index[idx];
     mxdebug(fmt % idx % format_timestamp(entry.timecode) % format_timestamp(entry.duration) % entry.is_keyframe % entry.file_pos % entry.size);
   }
 }
@@ -2410,6 +2814,77 @@ qtmp4_demuxer_c::build_index() {
     dump_index_entries("Index before edit list");
 }
 
+// Everything needed for reading is in the index once it has been
+// built. Release the tables it was built from and the index's unused
+// capacity.
+void
+qtmp4_demuxer_c::free_tables() {
+  std::vector<qt_sample_t>{}.swap(sample_table);
+  std::vector<qt_chunk_t>{}.swap(chunk_table);
+  std::vector<qt_chunkmap_t>{}.swap(chunkmap_table);
+  std::vector<qt_durmap_t>{}.swap(durmap_table);
+  std::vector<uint32_t>{}.swap(keyframe_table);
+  std::vector<qt_frame_offset_t>{}.swap(raw_frame_offset_table);
+  std::vector<int32_t>{}.swap(frame_offset_table);
+  std::vector<int64_t>{}.swap(timecodes);
+  std::vector<int64_t>{}.swap(durations);
+  std::vector<qt_fragment_t>{}.swap(m_fragments);
+
+  m_index.shrink_to_fit();
+}
+
+void
+qtmp4_demuxer_c::prepare_for_next_fragments() {
+  m_index.erase_front(pos);
+  m_num_dropped_index_entries += pos;
+  pos                          = 0;
+
+  sample_table.clear();
+  chunk_table.clear();
+  chunkmap_table.clear();
+  durmap_table.clear();
+  keyframe_table.clear();
+  raw_frame_offset_table.clear();
+  frame_offset_table.clear();
+  sample_to_group_tables.clear();
+  timecodes.clear();
+  durations.clear();
+  m_fragments.clear();
+
+  num_frames_from_trun = 0;
+  m_tables_updated     = false;
+}
+
+void
+qtmp4_demuxer_c::index_next_fragments(bool resync_to_decode_time) {
+  if (   resync_to_decode_time
+      && m_first_fragment_decode_time
+      && !m_fragments.empty()
+      && m_fragments.front().base_media_decode_time
+      && (*m_fragments.front().base_media_decode_time >= *m_first_fragment_decode_time))
+    m_next_pts = *m_fragments.front().base_media_decode_time - *m_first_fragment_decode_time;
+
+  if (!update_tables())
+    return;
+
+  // The new entries are built from this window's tables only. The
+  // edit list has already been taken into account by the first
+  // window; its offset applies to all following samples as well.
+  mtx::frame_index_c remaining_index;
+  std::swap(remaining_index, m_index);
+
+  calculate_timecodes_variable_sample_size();
+  build_index();
+
+  m_index.adjust_timecodes(m_fragment_timestamp_offset);
+
+  remaining_index.reserve(remaining_index.size() + m_index.size());
+  for (auto const &entry : m_index)
+    remaining_index.push_back(entry);
+
+  m_index = std::move(remaining_index);
+}
+
 void
 qtmp4_demuxer_c::build_index_constant_sample_size_mode() {
   auto is_audio              = 'a' == type;
@@ -2419,6 +2894,8 @@ qtmp4_demuxer_c::build_index_constant_sample_size_mode() {
   auto v1_bytes_per_frame    = 1 == v0_audio_version ? get_uint32_be(&sound_stsd_atom->v1.bytes_per_frame)    : 0;
   auto v1_samples_per_packet = 1 == v0_audio_version ? get_uint32_be(&sound_stsd_atom->v1.samples_per_packet) : 0;
 
+  m_index.reserve(m_index.size() + chunk_table.size());
+
   size_t frame_idx;
   for (frame_idx = 0; frame_idx < chunk_table.size(); ++frame_idx) {
     uint64_t frame_size;
@@ -2444,9 +2921,10 @@ qtmp4_demuxer_c::build_index_constant_sample_size_mode() {
 
 void
 qtmp4_demuxer_c::build_index_chunk_mode() {
-  for (std::size_t frame_idx = 0, num_frames = frame_indices.size(); frame_idx < num_frames; ++frame_idx) {
-    auto act_frame_idx = frame_indices[frame_idx];
-    auto &sample       = sample_table[act_frame_idx];
+  m_index.reserve(m_index.size() + sample_table.size());
+
+  for (std::size_t frame_idx = 0, num_frames = sample_table.size(); frame_idx < num_frames; ++frame_idx) {
+    auto &sample = sample_table[frame_idx];
 
     m_index.emplace_back(sample.pos, sample.size, timecodes[frame_idx], durations[frame_idx], false);
   }
@@ -2455,8 +2933,8 @@ qtmp4_demuxer_c::build_index_chunk_mode() {
 void
 qtmp4_demuxer_c::mark_key_frames_from_key_frame_table() {
   if (keyframe_table.empty()) {
-    for (auto &index : m_index)
-      index.is_keyframe = true;
+    for (auto idx = 0u, num_entries = static_cast<unsigned int>(m_index.size()); idx < num_entries; ++idx)
+      m_index.mark_as_keyframe(idx);
     return;
   }
 
@@ -2464,7 +2942,7 @@ qtmp4_demuxer_c::mark_key_frames_from_key_frame_table() {
 
   for (auto const &keyframe_number : keyframe_table)
     if ((keyframe_number > 0) && (keyframe_number <= num_index_entries))
-      m_index[keyframe_number - 1].is_keyframe = true;
+      m_index.mark_as_keyframe(keyframe_number - 1);
 }
 
 void
@@ -2482,7 +2960,7 @@ qtmp4_demuxer_c::mark_open_gop_random_access_points_as_key_frames() {
   for (auto const &s2g : table_itr->second) {
     if (s2g.group_description_index && ((s2g.group_description_index - 1) < num_random_access_points)) {
       for (auto end = std::min<size_t>(current_sample + s2g.sample_count, num_index_entries); current_sample < end; ++current_sample)
-        m_index[current_sample].is_keyframe = true;
+        m_index.mark_as_keyframe(current_sample);
 
     } else
       current_sample += s2g.sample_count;
@@ -2504,7 +2982,7 @@ qtmp4_demuxer_c::read_first_bytes(int num_bytes) {
   size_t idx_pos = 0;
 
   while ((0 < num_bytes) && (idx_pos < m_index.size())) {
-    qt_index_t &index          = m_index[idx_pos];
+    auto index                 = m_index[idx_pos];
     uint64_t num_bytes_to_read = std::min<int64_t>(num_bytes, index.size);
 
     m_reader.m_in->setFilePointer(index.file_pos);
@@ -20,6 +20,7 @@
 #include "common/codec.h"
 #include "common/dts.h"
 #include "common/fourcc.h"
+#include "common/frame_index.h"
 #include "common/mm_io.h"
 #include "input/qtmp4_atoms.h"
 #include "merge/generic_reader.h"
@@ -139,29 +140,7 @@ struct qt_frame_offset_t {
   }
 };
 
-struct qt_index_t {
-  int64_t file_pos, size;
-  int64_t timecode, duration;
-  bool    is_keyframe;
-
-  qt_index_t()
-    : file_pos{}
-    , size{}
-    , timecode{}
-    , duration{}
-    , is_keyframe{}
-  {
-  };
-
-  qt_index_t(int64_t p_file_pos, int64_t p_size, int64_t p_timecode, int64_t p_duration, bool p_is_keyframe)
-    : file_pos{p_file_pos}
-    , size{p_size}
-    , timecode{p_timecode}
-    , duration{p_duration}
-    , is_keyframe{p_is_keyframe}
-  {
-  }
-};
+using qt_index_t = mtx::frame_index_c::entry_t;
 
 struct qt_track_defaults_t {
   unsigned int sample_description_id, sample_duration, sample_size, sample_flags;
@@ -178,6 +157,7 @@ struct qt_track_defaults_t {
 struct qt_fragment_t {
   unsigned int track_id, sample_description_id, sample_duration, sample_size, sample_flags;
   uint64_t base_data_offset, moof_offset, implicit_offset;
+  boost::optional<uint64_t> base_media_decode_time;
 
   qt_fragment_t()
     : track_id{}
@@ -191,6 +171,21 @@ struct qt_fragment_t {
   {}
 };
 
+// Position of a 'moof' atom and the time of a track's random access
+// point in it, taken from 'sidx' and 'tfra' atoms.
+struct qt_fragment_entry_point_t {
+  uint32_t track_id;
+  uint64_t time, time_scale, moof_offset;
+
+  qt_fragment_entry_point_t(uint32_t p_track_id, uint64_t p_time, uint64_t p_time_scale, uint64_t p_moof_offset)
+    : track_id{p_track_id}
+    , time{p_time}
+    , time_scale{p_time_scale}
+    , moof_offset{p_moof_offset}
+  {
+  }
+};
+
 struct qt_random_access_point_t {
   bool num_leading_samples_known{};
   unsigned int num_leading_samples{};
@@ -241,11 +236,20 @@ struct qtmp4_demuxer_c {
   std::vector<qt_random_access_point_t> random_access_point_table;
   std::unordered_map<uint32_t, std::vector<qt_sample_to_group_t> > sample_to_group_tables;
 
-  std::vector<int64_t> timecodes, durations, frame_indices;
+  std::vector<int64_t> timecodes, durations;
 
-  std::vector<qt_index_t> m_index;
+  mtx::frame_index_c m_index;
   std::vector<qt_fragment_t> m_fragments;
 
+  // Used for fragmented files whose fragments are indexed a window at
+  // a time: the number of index entries already read and removed, the
+  // PTS of the first sample of the next window, the offset that the
+  // edit list and the global minimum timestamp add to the timestamps,
+  // and the base media decode time of the track's first fragment.
+  uint64_t m_num_dropped_index_entries{}, m_next_pts{};
+  int64_t m_fragment_timestamp_offset{};
+  boost::optional<uint64_t> m_first_fragment_decode_time;
+
   int64_rational_c frame_rate;
   boost::optional<int64_t> m_use_frame_rate_for_duration;
 
@@ -322,6 +326,10 @@ struct qtmp4_demuxer_c {
 
   void build_index();
 
+  void free_tables();
+  void prepare_for_next_fragments();
+  void index_next_fragments(bool resync_to_decode_time);
+
   memory_cptr read_first_bytes(int num_bytes);
 
   bool is_audio() const;
@@ -449,6 +457,10 @@ private:
   qt_fragment_t *m_fragment;
   qtmp4_demuxer_c *m_track_for_fragment;
 
+  bool m_index_fragments_lazily;
+  boost::optional<uint64_t> m_next_fragment_pos;
+  std::vector<qt_fragment_entry_point_t> m_fragment_entry_points;
+
   bool m_timecodes_calculated;
 
   debugging_option_c m_debug_chapters, m_debug_headers, m_debug_tables, m_debug_tables_full, m_debug_interleaving, m_debug_resync;
@@ -465,6 +477,7 @@ public:
 
   virtual void read_headers();
   virtual file_status_e read(generic_packetizer_c *ptzr, bool force = false);
+  virtual void set_timecode_restrictions(timestamp_c const &min, timestamp_c const &max);
   virtual int get_progress();
   virtual void identify();
   virtual void create_packetizers();
@@ -505,6 +518,10 @@ protected:
   virtual void handle_traf_atom(qt_atom_t parent, int level);
   virtual void handle_tfhd_atom(qt_atom_t parent, int level);
   virtual void handle_trun_atom(qt_atom_t parent, int level);
+  virtual void handle_tfdt_atom(qt_atom_t parent, int level);
+  virtual void handle_sidx_atom(qt_atom_t parent, int level);
+  virtual void handle_mfra_atom(qt_atom_t parent, int level);
+  virtual void handle_tfra_atom(qt_atom_t parent, int level);
   virtual void handle_stbl_atom(qtmp4_demuxer_c &new_dmx, qt_atom_t parent, int level);
   virtual void handle_stco_atom(qtmp4_demuxer_c &new_dmx, qt_atom_t parent, int level);
   virtual void handle_co64_atom(qtmp4_demuxer_c &new_dmx, qt_atom_t parent, int level);
@@ -548,6 +565,13 @@ protected:
   virtual void process_chapter_entries(int level, std::vector<qtmp4_chapter_entry_t> &entries);
 
   virtual void detect_interleaving();
+  virtual void determine_start_positions();
+
+  virtual bool can_index_fragments_lazily() const;
+  virtual void read_fragment_random_access_atoms();
+  virtual bool load_next_fragments(bool resync_to_decode_time = false);
+  virtual file_status_e load_next_fragments_for(qtmp4_demuxer_c &dmx);
+  virtual void skip_fragments_before(int64_t timestamp);
 
   virtual std::string read_string_atom(qt_atom_t atom, size_t num_skipped);
 };
@@ -16,6 +16,7 @@
 
 #include "common/ebml.h"
 #include "common/hacks.h"
+#include "common/json.h"
 #include "common/math.h"
 #include "common/strings/formatting.h"
 #include "common/tags/tags.h"
@@ -205,6 +206,38 @@ cluster_helper_c::split_if_necessary(packet_cptr &packet) {
   split(packet);
 }
 
+/** \brief Starts a new cluster if a new media segment must begin
+
+   Media segments start with a key frame of the video track (or of any
+   track if there's no video track) once the requested duration has
+   passed since the start of the current one. The first media segment
+   starts with the first packet. The cluster the packet will be put
+   into is marked as the start of the new segment.
+*/
+void
+cluster_helper_c::start_media_segment_if_necessary(packet_cptr &packet) {
+  if (!m->media_segment_duration.valid())
+    return;
+
+  if (-1 != m->media_segment_start) {
+    if (   !packet->is_key_frame()
+        || (   (packet->source->get_track_type() != track_video)
+            && g_video_packetizer)
+        || ((packet->assigned_timecode - m->media_segment_start) < m->media_segment_duration.to_ns()))
+      return;
+  }
+
+  mxdebug_if(m->debug_media_segments, boost::format("new media segment at %1% (previous one started at %2%)\n") % format_timestamp(packet->assigned_timecode) % format_timestamp(m->media_segment_start));
+
+  if (!m->packets.empty()) {
+    render();
+    prepare_new_cluster();
+  }
+
+  m->media_segment_start   = packet->assigned_timecode;
+  m->media_segment_pending = true;
+}
+
 void
 cluster_helper_c::split(packet_cptr &packet) {
   render();
@@ -258,6 +291,7 @@ cluster_helper_c::add_packet(packet_cptr packet) {
 
   packet->normalize_timecodes();
   render_before_adding_if_necessary(packet);
+  start_media_segment_if_necessary(packet);
   split_if_necessary(packet);
 
   m->packets.push_back(packet);
@@ -288,6 +322,9 @@ cluster_helper_c::prepare_new_cluster() {
   m->cluster_content_size = 0;
   m->packets.clear();
 
+  if (g_write_crc32)
+    m->cluster->EnableChecksum();
+
   m->cluster->SetParent(*g_kax_segment);
   m->cluster->SetPreviousTimecode(std::max<int64_t>(0, m->previous_cluster_tc), (int64_t)g_timecode_scale);
 }
@@ -554,6 +591,15 @@ cluster_helper_c::render() {
       m->cluster->Render(*m->out, cues);
       m->bytes_in_file += m->cluster->ElementSize();
 
+      if (m->media_segment_duration.valid()) {
+        if (m->media_segment_pending) {
+          m->media_segments.emplace_back(m->cluster->GetElementPosition(), min_cl_timecode - timecode_offset);
+          m->media_segment_pending = false;
+        }
+
+        m->media_segments_end = m->cluster->GetElementPosition() + m->cluster->ElementSize();
+      }
+
       if (g_kax_sh_cues)
         g_kax_sh_cues->IndexThis(*m->cluster, *g_kax_segment);
 
@@ -686,6 +732,82 @@ cluster_helper_c::discard_queued_packets() {
   m->packets.clear();
 }
 
+/** \brief Where the first kept part starts in 'parts:' splitting mode
+
+   Returns the timestamp at which the first part to keep starts if
+   splitting by timestamp-based parts and if the output begins with a
+   discarded range. Returns an invalid timestamp otherwise.
+*/
+timestamp_c
+cluster_helper_c::get_start_of_first_kept_part()
+  const {
+  if (   !splitting()
+      || (m->split_points.size() < 2)
+      || (split_point_c::parts != m->split_points.front().m_type)
+      || !m->split_points.front().m_discard)
+    return {};
+
+  return timestamp_c::ns(m->split_points[1].m_point);
+}
+
+/** \brief Timestamp ranges of output files that can be written independently
+
+   Returns one [start, end) range for each output file if splitting by
+   timestamps or by timestamp-based parts where each part creates its
+   own file. Each such file can then be created by a separate process
+   that only processes its own range. The last range's end is
+   \c std::numeric_limits<int64_t>::max() if the file extends until the
+   end of the input. Returns an empty list for all other modes.
+*/
+std::vector<std::pair<int64_t, int64_t> >
+cluster_helper_c::get_independent_output_ranges()
+  const {
+  std::vector<std::pair<int64_t, int64_t> > ranges;
+
+  if (!splitting())
+    return ranges;
+
+  auto max_end = std::numeric_limits<int64_t>::max();
+
+  if (split_point_c::timecode == m->split_points.front().m_type) {
+    int64_t start = 0;
+
+    for (auto const &split_point : m->split_points) {
+      if (split_point.m_point <= start)
+        continue;
+
+      if (static_cast<int>(ranges.size() + 1) >= g_split_max_num_files)
+        break;
+
+      ranges.emplace_back(start, split_point.m_point);
+      start = split_point.m_point;
+    }
+
+    ranges.emplace_back(start, max_end);
+
+    return ranges;
+  }
+
+  if (split_point_c::parts != m->split_points.front().m_type)
+    return ranges;
+
+  for (auto point = m->split_points.begin(), end = m->split_points.end(); point != end; ++point) {
+    if (point->m_discard)
+      continue;
+
+    if (!point->m_create_new_file && !ranges.empty())
+      return {};
+
+    auto next = point + 1;
+    ranges.emplace_back(point->m_point, next != end ? next->m_point : max_end);
+  }
+
+  if (static_cast<int>(ranges.size()) > g_split_max_num_files)
+    return {};
+
+  return ranges;
+}
+
 void
 cluster_helper_c::dump_split_points()
   const {
@@ -743,6 +865,71 @@ cluster_helper_c::verify_and_report_chapter_generation_parameters()
          % m->chapter_generation_reference_track->m_ti.m_id % m->chapter_generation_reference_track->m_ti.m_fname);
 }
 
+void
+cluster_helper_c::enable_media_segments(timestamp_c const &duration,
+                                        std::string const &index_file_name) {
+  m->media_segment_duration        = duration;
+  m->media_segment_index_file_name = index_file_name;
+}
+
+bool
+cluster_helper_c::producing_media_segments()
+  const {
+  return m->media_segment_duration.valid();
+}
+
+/** \brief Writes the byte ranges and timestamps of all media segments
+
+   The index is a JSON file listing the range of the initialization
+   segment (everything in front of the first cluster), the range of
+   the cues if any have been written and the range, the timestamp and
+   the duration of each media segment. Positions and sizes are in
+   bytes, timestamps and durations in nanoseconds. This is the
+   information needed for creating DASH or HLS manifests that refer to
+   the file with byte ranges.
+*/
+void
+cluster_helper_c::write_media_segment_index(int64_t cues_position,
+                                            int64_t cues_size)
+  const {
+  if (m->media_segment_index_file_name.empty())
+    return;
+
+  auto segments      = nlohmann::json::array();
+  auto end_timestamp = m->max_timecode_and_duration - m->timecode_offset;
+
+  for (auto idx = 0u, num_segments = static_cast<unsigned int>(m->media_segments.size()); idx < num_segments; ++idx) {
+    auto const &segment = m->media_segments[idx];
+    auto next_position  = (idx + 1) < num_segments ? m->media_segments[idx + 1].first  : m->media_segments_end;
+    auto next_timestamp = (idx + 1) < num_segments ? m->media_segments[idx + 1].second : end_timestamp;
+
+    segments.push_back(nlohmann::json{
+      { "position",  segment.first                                         },
+      { "size",      next_position - segment.first                         },
+      { "timestamp", segment.second                                        },
+      { "duration",  std::max<int64_t>(next_timestamp - segment.second, 0) },
+    });
+  }
+
+  auto init_size = m->media_segments.empty() ? m->media_segments_end : m->media_segments.front().first;
+  auto index     = nlohmann::json{
+    { "file_name",      g_outfile                                    },
+    { "init_segment",   { { "position", 0 }, { "size", init_size } } },
+    { "media_segments", segments                                     },
+  };
+
+  if (0 < cues_size)
+    index["cues"] = nlohmann::json{ { "position", cues_position }, { "size", cues_size } };
+
+  try {
+    mm_file_io_c out{m->media_segment_index_file_name, MODE_CREATE};
+    out.puts(mtx::json::dump(index, 2));
+
+  } catch (mtx::mm_io::exception &ex) {
+    mxerror(boost::format(Y("The file '%1%' could not be opened for writing: %2%.\n")) % m->media_segment_index_file_name % ex);
+  }
+}
+
 void
 cluster_helper_c::register_new_packetizer(generic_packetizer_c &ptzr) {
   auto new_track_type = ptzr.get_track_type();
@@ -25,13 +25,12 @@
 #include "common/split_point.h"
 #include "common/timestamp.h"
 #include "merge/libmatroska_extensions.h"
+#include "merge/packet_fwd.h"
 
 #define RND_TIMECODE_SCALE(a) (std::llround(static_cast<double>(a) / static_cast<double>(g_timecode_scale)) * static_cast<int64_t>(g_timecode_scale))
 
 class generic_packetizer_c;
 class render_groups_c;
-class packet_t;
-using packet_cptr = std::shared_ptr<packet_t>;
 
 enum class chapter_generation_mode_e {
   none,
@@ -67,6 +66,8 @@ public:
   void dump_split_points() const;
   bool splitting() const;
   bool split_mode_produces_many_files() const;
+  timestamp_c get_start_of_first_kept_part() const;
+  std::vector<std::pair<int64_t, int64_t> > get_independent_output_ranges() const;
 
   bool discarding() const;
 
@@ -85,6 +86,10 @@ public:
   void set_chapter_generation_name_template(std::string const &name_template);
   void verify_and_report_chapter_generation_parameters() const;
 
+  void enable_media_segments(timestamp_c const &duration, std::string const &index_file_name);
+  bool producing_media_segments() const;
+  void write_media_segment_index(int64_t cues_position, int64_t cues_size) const;
+
 private:
   void set_duration(render_groups_c *rg);
   bool must_duration_be_set(render_groups_c *rg, packet_cptr &new_packet);
@@ -92,6 +97,7 @@ private:
   void render_before_adding_if_necessary(packet_cptr &packet);
   void render_after_adding_if_necessary(packet_cptr &packet);
   void split_if_necessary(packet_cptr &packet);
+  void start_media_segment_if_necessary(packet_cptr &packet);
   void generate_chapters_if_necessary(packet_cptr const &packet);
   void generate_one_chapter(timestamp_c const &timestamp);
   void split(packet_cptr &packet);
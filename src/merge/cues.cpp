@@ -13,6 +13,8 @@
 
 #include "common/common_pch.h"
 
+#include <ebml/EbmlCrc32.h>
+
 #include "common/debugging.h"
 #include "common/ebml.h"
 #include "common/fs_sys_helpers.h"
@@ -44,16 +46,18 @@ cues_c::set_duration_for_id_timecode(uint64_t id,
 }
 
 void
-cues_c::add(KaxCues &cues) {
+cues_c::add(KaxCues &cues,
+            uint64_t position_offset) {
   for (auto child : cues) {
     auto point = dynamic_cast<KaxCuePoint *>(child);
     if (point)
-      add(*point);
+      add(*point, position_offset);
   }
 }
 
 void
-cues_c::add(KaxCuePoint &point) {
+cues_c::add(KaxCuePoint &point,
+            uint64_t position_offset) {
   uint64_t timecode = FindChildValue<KaxCueTime>(point) * g_timecode_scale;
 
   for (auto point_child : point) {
@@ -68,7 +72,7 @@ cues_c::add(KaxCuePoint &point) {
 
     uint64_t codec_state_position = FindChildValue<KaxCueCodecState>(*positions);
     if (codec_state_position)
-      m_codec_state_position_map[ id_timecode_t{ track_num, timecode } ] = codec_state_position;
+      m_codec_state_position_map[ id_timecode_t{ track_num, timecode } ] = codec_state_position + position_offset;
   }
 }
 
@@ -96,9 +100,15 @@ cues_c::write(mm_io_c &out,
   seek_head.IndexThis(cues_dummy, *g_kax_segment);
 
   // Forcefully write the correct head and copy its content from the
-  // temporary storage location.
-  auto total_size = calculate_total_size();
-  write_ebml_element_head(out, EBML_ID(KaxCues), total_size);
+  // temporary storage location. If CRC-32 elements were requested the
+  // points are rendered into a memory buffer first so that the
+  // checksum can be written in front of them.
+  auto total_size  = calculate_total_size();
+  auto mem_out     = g_write_crc32 ? std::make_shared<mm_mem_io_c>(nullptr, total_size, 1024) : mm_mem_io_cptr{};
+  auto &points_out = mem_out ? static_cast<mm_io_c &>(*mem_out) : out;
+
+  if (!mem_out)
+    write_ebml_element_head(out, EBML_ID(KaxCues), total_size);
 
   for (auto &point : m_points) {
     KaxCuePoint kc_point;
@@ -121,7 +131,16 @@ cues_c::write(mm_io_c &out,
     if (point.duration)
       GetChild<KaxCueDuration>(positions).SetValue(RND_TIMECODE_SCALE(point.duration) / g_timecode_scale);
 
-    kc_point.Render(out);
+    kc_point.Render(points_out);
+  }
+
+  if (mem_out) {
+    EbmlCrc32 crc;
+    crc.FillCRC32(mem_out->get_buffer(), mem_out->getFilePointer());
+
+    write_ebml_element_head(out, EBML_ID(KaxCues), crc.ElementSize() + mem_out->getFilePointer());
+    crc.Render(out);
+    out.write(mem_out->get_buffer(), mem_out->getFilePointer());
   }
 
   m_points.clear();
@@ -148,7 +167,8 @@ cues_c::sort() {
 }
 
 std::multimap<id_timecode_t, uint64_t>
-cues_c::calculate_block_positions(KaxCluster &cluster)
+cues_c::calculate_block_positions(KaxCluster &cluster,
+                                  uint64_t position_offset)
   const {
 
   std::multimap<id_timecode_t, uint64_t> positions;
@@ -157,7 +177,7 @@ cues_c::calculate_block_positions(KaxCluster &cluster)
     auto simple_block = dynamic_cast<KaxSimpleBlock *>(child);
     if (simple_block) {
       simple_block->SetParent(cluster);
-      positions.insert({ id_timecode_t{ simple_block->TrackNum(), simple_block->GlobalTimecode()}, simple_block->GetElementPosition() });
+      positions.insert({ id_timecode_t{ simple_block->TrackNum(), simple_block->GlobalTimecode()}, simple_block->GetElementPosition() + position_offset });
       continue;
     }
 
@@ -170,7 +190,7 @@ cues_c::calculate_block_positions(KaxCluster &cluster)
       continue;
 
     block->SetParent(cluster);
-    positions.insert({ id_timecode_t{ block->TrackNum(), block->GlobalTimecode()}, block_group->GetElementPosition() });
+    positions.insert({ id_timecode_t{ block->TrackNum(), block->GlobalTimecode()}, block_group->GetElementPosition() + position_offset });
   }
 
   return positions;
@@ -179,13 +199,19 @@ cues_c::calculate_block_positions(KaxCluster &cluster)
 void
 cues_c::postprocess_cues(KaxCues &cues,
                          KaxCluster &cluster) {
-  add(cues);
+  // If the cluster carries a CRC-32 element then libebml renders its
+  // children into a temporary buffer first. Their positions are
+  // therefore relative to that buffer which starts right after the
+  // CRC-32 element.
+  auto cluster_data_start_pos = cluster.GetElementPosition() + cluster.HeadSize();
+  auto position_offset        = cluster.HasChecksum() ? cluster_data_start_pos + EbmlCrc32{}.ElementSize() : 0;
+
+  add(cues, position_offset);
 
   if (m_no_cue_duration && m_no_cue_relative_position)
     return;
 
-  auto cluster_data_start_pos = cluster.GetElementPosition() + cluster.HeadSize();
-  auto block_positions        = calculate_block_positions(cluster);
+  auto block_positions = calculate_block_positions(cluster, position_offset);
   std::map<id_timecode_t, size_t> nblocks_processed; //# blocks processed so far with given track #/timecode
 
   for (auto point = m_points.begin() + m_num_cue_points_postprocessed, end = m_points.end(); point != end; ++point) {
@@ -48,8 +48,8 @@ protected:
 public:
   cues_c();
 
-  void add(KaxCues &cues);
-  void add(KaxCuePoint &point);
+  void add(KaxCues &cues, uint64_t position_offset = 0);
+  void add(KaxCuePoint &point, uint64_t position_offset = 0);
   void write(mm_io_c &out, KaxSeekHead &seek_head);
   void postprocess_cues(KaxCues &cues, KaxCluster &cluster);
   void set_duration_for_id_timecode(uint64_t id, uint64_t timecode, uint64_t duration);
@@ -60,7 +60,7 @@ public:
 
 protected:
   void sort();
-  std::multimap<id_timecode_t, uint64_t> calculate_block_positions(KaxCluster &cluster) const;
+  std::multimap<id_timecode_t, uint64_t> calculate_block_positions(KaxCluster &cluster, uint64_t position_offset) const;
   uint64_t calculate_total_size() const;
   uint64_t calculate_point_size(cue_point_t const &point) const;
   uint64_t calculate_bytes_for_uint(uint64_t value) const;
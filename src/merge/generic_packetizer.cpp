@@ -35,7 +35,9 @@
 #include "merge/filelist.h"
 #include "merge/generic_packetizer.h"
 #include "merge/generic_reader.h"
+#include "merge/open_readers.h"
 #include "merge/output_control.h"
+#include "merge/queue_budget.h"
 #include "merge/webm.h"
 
 #define TRACK_TYPE_TO_DEFTRACK_TYPE(track_type)      \
@@ -354,6 +356,7 @@ generic_packetizer_c::generic_packetizer_c(generic_reader_c *reader,
 }
 
 generic_packetizer_c::~generic_packetizer_c() {
+  queue_budget_c::get().unregister(*this);
 }
 
 void
@@ -1274,7 +1277,10 @@ generic_packetizer_c::compress_packet(packet_t &packet) {
 void
 generic_packetizer_c::account_enqueued_bytes(packet_t &packet,
                                              int64_t factor) {
-  m_enqueued_bytes += packet.calculate_uncompressed_size() * factor;
+  auto num_bytes    = packet.calculate_uncompressed_size() * factor;
+  m_enqueued_bytes += num_bytes;
+
+  queue_budget_c::get().account(*this, num_bytes);
 }
 
 void
@@ -1292,9 +1298,9 @@ generic_packetizer_c::add_packet(packet_cptr pack) {
       && (pack->data_adds.size()  > static_cast<size_t>(m_htrack_max_add_block_ids)))
     pack->data_adds.resize(m_htrack_max_add_block_ids);
 
-  pack->data->grab();
+  m_reader->m_num_grabbed_bytes += pack->data->grab();
   for (auto &data_add : pack->data_adds)
-    data_add->grab();
+    m_reader->m_num_grabbed_bytes += data_add->grab();
 
   pack->source = this;
 
@@ -1610,6 +1616,7 @@ generic_packetizer_c::is_compatible_with(output_compatibility_e compatibility) {
 void
 generic_packetizer_c::discard_queued_packets() {
   m_packet_queue.clear();
+  queue_budget_c::get().account(*this, -m_enqueued_bytes);
   m_enqueued_bytes = 0;
 }
 
@@ -1672,6 +1679,7 @@ generic_packetizer_c::create_track_number() {
 
 file_status_e
 generic_packetizer_c::read(bool force) {
+  open_readers_c::get().mark_as_used(*m_reader);
   return m_reader->read(this, force);
 }
 
@@ -18,6 +18,7 @@
 #include "merge/generic_packetizer.h"
 #include "merge/generic_reader.h"
 #include "merge/input_x.h"
+#include "merge/open_readers.h"
 #include "merge/output_control.h"
 
 static int64_rational_c s_probe_range_percentage{3, 10}; // 0.3%
@@ -86,6 +87,7 @@ generic_reader_c::generic_reader_c(const track_info_c &ti,
   , m_num_audio_tracks{}
   , m_num_subtitle_tracks{}
   , m_reference_timecode_tolerance{}
+  , m_num_grabbed_bytes{}
 {
   add_all_requested_track_ids(*this, m_ti.m_atracks.m_items);
   add_all_requested_track_ids(*this, m_ti.m_vtracks.m_items);
@@ -110,6 +112,12 @@ generic_reader_c::generic_reader_c(const track_info_c &ti,
 }
 
 generic_reader_c::~generic_reader_c() {
+  static debugging_option_c s_debug{"grab_statistics"};
+
+  mxdebug_if(s_debug, boost::format("%1%: %2% bytes copied from the reader's buffers\n") % m_ti.m_fname % m_num_grabbed_bytes);
+
+  open_readers_c::get().unregister(*this);
+
   size_t i;
 
   for (i = 0; i < m_reader_packetizers.size(); i++)
@@ -137,6 +145,8 @@ generic_reader_c::get_timecode_restriction_max()
 
 void
 generic_reader_c::read_all() {
+  open_readers_c::get().mark_as_used(*this);
+
   for (auto &packetizer : m_reader_packetizers)
     while (read(packetizer, true) != FILE_STATUS_DONE)
       ;
@@ -277,6 +287,16 @@ generic_reader_c::get_queued_bytes()
   return bytes;
 }
 
+// Releases the input's file handle and read buffer while the
+// reader's packets aren't needed. The next read reopens the file.
+void
+generic_reader_c::suspend_input() {
+  open_readers_c::get().unregister(*this);
+
+  if (m_in)
+    m_in->suspend();
+}
+
 file_status_e
 generic_reader_c::flush_packetizer(int num) {
   return flush_packetizer(PTZR(num));
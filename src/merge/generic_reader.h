@@ -63,6 +63,10 @@ public:
 
   int64_t m_reference_timecode_tolerance;
 
+  // Number of bytes the packetizers had to copy because packets
+  // pointed to memory the reader didn't hand over.
+  uint64_t m_num_grabbed_bytes;
+
 protected:
   id_result_t m_id_results_container;
   std::vector<id_result_t> m_id_results_tracks, m_id_results_attachments, m_id_results_chapters, m_id_results_tags;
@@ -113,6 +117,7 @@ public:
     return m_in->get_size();
   }
   virtual int64_t get_queued_bytes() const;
+  virtual void suspend_input();
   virtual bool is_simple_subtitle_container() {
     return false;
   }
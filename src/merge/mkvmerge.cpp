@@ -25,6 +25,8 @@
 #endif
 #if defined(SYS_WINDOWS)
 #include <windows.h>
+#else
+#include <sys/wait.h>
 #endif
 
 #include <algorithm>
@@ -47,10 +49,12 @@
 #include "common/file_types.h"
 #include "common/fs_sys_helpers.h"
 #include "common/iso639.h"
+#include "common/json.h"
 #include "common/kax_analyzer.h"
 #include "common/list_utils.h"
 #include "common/mm_io.h"
 #include "common/mm_mpls_multi_file_io.h"
+#include "common/parallel.h"
 #include "common/segmentinfo.h"
 #include "common/split_arg_parsing.h"
 #include "common/strings/formatting.h"
@@ -63,7 +67,9 @@
 #include "merge/cluster_helper.h"
 #include "merge/filelist.h"
 #include "merge/generic_reader.h"
+#include "merge/open_readers.h"
 #include "merge/output_control.h"
+#include "merge/queue_budget.h"
 #include "merge/reader_detection_and_creation.h"
 #include "merge/track_info.h"
 
@@ -116,12 +122,32 @@ set_usage() {
                   "                           If the number is postfixed with 'ms' then\n"
                   "                           put at most n milliseconds of data into each\n"
                   "                           cluster.\n");
+  usage_text += Y("  --media-segment-duration <d>\n"
+                  "                           Start a new cluster at the first key frame\n"
+                  "                           after d has passed since the start of the\n"
+                  "                           previous one for use as media segments with\n"
+                  "                           DASH or HLS.\n");
+  usage_text += Y("  --media-segment-index <file>\n"
+                  "                           Write the positions, sizes and timestamps of\n"
+                  "                           the media segments to a JSON file.\n");
   usage_text += Y("  --no-cues                Do not write the cue data (the index).\n");
   usage_text += Y("  --clusters-in-meta-seek  Write meta seek data for clusters.\n");
   usage_text += Y("  --no-date                Do not write the 'date' field in the segment\n"
                   "                           information headers.\n");
   usage_text += Y("  --disable-lacing         Do not use lacing.\n");
   usage_text += Y("  --enable-durations       Enable block durations for all blocks.\n");
+  usage_text += Y("  --enable-crc32           Write CRC-32 elements for clusters and all\n"
+                  "                           other level 1 elements.\n");
+  usage_text += Y("  --drop-from-page-cache <source|destination|all>\n"
+                  "                           Tell the operating system that data read\n"
+                  "                           or written won't be needed again.\n");
+  usage_text += Y("  --queue-memory-limit <n[K,M,G]>\n"
+                  "                           Read from the source files only when\n"
+                  "                           necessary while more than n bytes are\n"
+                  "                           queued for all tracks together.\n");
+  usage_text += Y("  --max-open-files <n>     Close the source files of all but the n most\n"
+                  "                           recently read ones and reopen them when\n"
+                  "                           needed again.\n");
   usage_text += Y("  --timecode-scale <n>     Force the timecode scale factor to n.\n");
   usage_text += Y("  --disable-track-statistics-tags\n"
                   "                           Do not write tags with track statistics.\n");
@@ -147,6 +173,11 @@ set_usage() {
                   "                           Create a new file before each chapter (with 'all')\n"
                   "                           or before chapter numbers A, B etc.\n");
   usage_text += Y("  --split-max-files <n>    Create at most n files.\n");
+  usage_text += Y("  --split-processes <n>    Write up to n files concurrently, each one by\n"
+                  "                           its own mkvmerge process (only for splitting\n"
+                  "                           by timecodes or by parts without linking).\n"
+                  "                           Each process reads the source files from their\n"
+                  "                           start unless their reader can seek to the part.\n");
   usage_text += Y("  --link                   Link splitted files.\n");
   usage_text += Y("  --link-to-previous <SID> Link the first file to the given SID.\n");
   usage_text += Y("  --link-to-next <SID>     Link the last file to the given SID.\n");
@@ -1767,6 +1798,29 @@ parse_arg_cluster_length(std::string arg) {
   }
 }
 
+static void
+parse_arg_queue_memory_limit(std::string const &arg) {
+  auto s        = arg;
+  auto modifier = int64_t{1};
+  auto mod      = !s.empty() ? tolower(s[s.length() - 1]) : 0;
+
+  if ('k' == mod)
+    modifier = 1024;
+  else if ('m' == mod)
+    modifier = 1024 * 1024;
+  else if ('g' == mod)
+    modifier = 1024 * 1024 * 1024;
+
+  if (1 != modifier)
+    s.erase(s.size() - 1);
+
+  auto limit = int64_t{};
+  if (!parse_number(s, limit) || (0 >= limit))
+    mxerror(boost::format(Y("Invalid memory limit in '--queue-memory-limit %1%'.\n")) % arg);
+
+  queue_budget_c::get().set_limit(limit * modifier);
+}
+
 static void
 parse_arg_attach_file(attachment_cptr const &attachment,
                       const std::string &arg,
@@ -2206,10 +2260,19 @@ handle_identification_args(std::vector<std::string> &args) {
   mxexit();
 }
 
+// Positions of the options and their arguments in the command line
+// that are replaced for each process started by '--split-processes'.
+static std::vector<std::size_t> s_split_processes_replaced_args;
+
 static void
-parse_args(std::vector<std::string> args) {
-  handle_identification_args(args);
+remember_split_processes_replaced_arg(std::vector<std::string> const &args,
+                                      std::vector<std::string>::const_iterator const &sit) {
+  auto idx = static_cast<std::size_t>(sit - args.cbegin());
+  s_split_processes_replaced_args.insert(s_split_processes_replaced_args.end(), { idx, idx + 1 });
+}
 
+static void
+parse_args(std::vector<std::string> args) {
   // First parse options that either just print some infos and then exit.
   for (auto sit = args.cbegin(), sit_end = args.cend(); sit != sit_end; sit++) {
     auto const &this_arg = *sit;
@@ -2268,10 +2331,12 @@ parse_args(std::vector<std::string> args) {
     mxinfo(boost::format(Y("Automatically enabling WebM compliance mode due to destination file name extension.\n")));
   }
 
-  auto ti               = std::make_unique<track_info_c>();
-  bool inputs_found     = false;
-  bool append_next_file = false;
-  auto attachment       = std::make_shared<attachment_t>();
+  auto ti                            = std::make_unique<track_info_c>();
+  bool inputs_found                  = false;
+  bool append_next_file              = false;
+  auto attachment                    = std::make_shared<attachment_t>();
+  auto media_segment_duration        = timestamp_c{};
+  auto media_segment_index_file_name = std::string{};
 
   for (auto sit = args.cbegin(), sit_end = args.cend(); sit != sit_end; sit++) {
     auto const &this_arg = *sit;
@@ -2284,6 +2349,9 @@ parse_args(std::vector<std::string> args) {
         || (this_arg == "--output")
         || (this_arg == "--command-line-charset")
         || (this_arg == "--engage")) {
+      if ((this_arg == "-o") || (this_arg == "--output"))
+        remember_split_processes_replaced_arg(args, sit);
+
       sit++;
       continue;
     }
@@ -2319,6 +2387,7 @@ parse_args(std::vector<std::string> args) {
         mxerror(Y("'--split' lacks the size.\n"));
 
       parse_arg_split(next_arg);
+      remember_split_processes_replaced_arg(args, sit);
       sit++;
 
     } else if (this_arg == "--split-max-files") {
@@ -2328,6 +2397,25 @@ parse_args(std::vector<std::string> args) {
       if (!parse_number(next_arg, g_split_max_num_files) || (2 > g_split_max_num_files))
         mxerror(Y("Wrong argument to '--split-max-files'.\n"));
 
+      remember_split_processes_replaced_arg(args, sit);
+      sit++;
+
+    } else if (this_arg == "--split-processes") {
+      if ((no_next_arg) || (next_arg[0] == 0))
+        mxerror(Y("'--split-processes' lacks the number of processes.\n"));
+
+      if (!parse_number(next_arg, g_split_num_processes) || (1 > g_split_num_processes))
+        mxerror(Y("Wrong argument to '--split-processes'.\n"));
+
+      remember_split_processes_replaced_arg(args, sit);
+      sit++;
+
+    } else if (this_arg == "--split-file-number-offset") {
+      // Internal option used for the processes started by '--split-processes'.
+      if (no_next_arg || !parse_number(next_arg, g_file_num_offset) || (0 > g_file_num_offset))
+        mxerror(Y("Wrong argument to '--split-file-number-offset'.\n"));
+
+      remember_split_processes_replaced_arg(args, sit);
       sit++;
 
     } else if (this_arg == "--link") {
@@ -2361,6 +2449,24 @@ parse_args(std::vector<std::string> args) {
       parse_arg_cluster_length(next_arg);
       sit++;
 
+    } else if (this_arg == "--media-segment-duration") {
+      if (no_next_arg)
+        mxerror(boost::format(Y("'%1%' lacks its argument.\n")) % this_arg);
+
+      auto duration = int64_t{};
+      if (!parse_timestamp(next_arg, duration) || (0 >= duration))
+        mxerror(Y("Wrong argument to '--media-segment-duration'.\n"));
+
+      media_segment_duration = timestamp_c::ns(duration);
+      sit++;
+
+    } else if (this_arg == "--media-segment-index") {
+      if (no_next_arg || next_arg.empty())
+        mxerror(boost::format(Y("'%1%' lacks its argument.\n")) % this_arg);
+
+      media_segment_index_file_name = next_arg;
+      sit++;
+
     } else if (this_arg == "--no-cues")
       g_write_cues = false;
 
@@ -2376,7 +2482,38 @@ parse_args(std::vector<std::string> args) {
     else if (this_arg == "--enable-durations")
       g_use_durations = true;
 
-    else if (this_arg == "--disable-track-statistics-tags")
+    else if (this_arg == "--enable-crc32")
+      g_write_crc32 = true;
+
+    else if (this_arg == "--drop-from-page-cache") {
+      if (no_next_arg)
+        mxerror(boost::format(Y("'%1%' lacks its argument.\n")) % this_arg);
+
+      if (!mtx::included_in(next_arg, "source", "destination", "all"))
+        mxerror(Y("Wrong argument to '--drop-from-page-cache'.\n"));
+
+      mm_file_io_c::set_drop_from_page_cache(next_arg != "destination", next_arg != "source");
+      sit++;
+
+    } else if (this_arg == "--queue-memory-limit") {
+      if (no_next_arg)
+        mxerror(boost::format(Y("'%1%' lacks its argument.\n")) % this_arg);
+
+      parse_arg_queue_memory_limit(next_arg);
+      sit++;
+
+    } else if (this_arg == "--max-open-files") {
+      if (no_next_arg)
+        mxerror(boost::format(Y("'%1%' lacks its argument.\n")) % this_arg);
+
+      auto limit = uint64_t{};
+      if (!parse_number(next_arg, limit) || !limit)
+        mxerror(boost::format(Y("Invalid number of open files in '--max-open-files %1%'.\n")) % next_arg);
+
+      open_readers_c::get().set_limit(limit);
+      sit++;
+
+    } else if (this_arg == "--disable-track-statistics-tags")
       g_no_track_statistics_tags = true;
 
     else if (this_arg == "--attachment-description") {
@@ -2903,6 +3040,16 @@ parse_args(std::vector<std::string> args) {
   if (!g_cluster_helper->splitting() && !g_no_linking)
     mxwarn(Y("'--link' is only useful in combination with '--split'.\n"));
 
+  if (!media_segment_index_file_name.empty() && !media_segment_duration.valid())
+    mxerror(Y("'--media-segment-index' requires '--media-segment-duration'.\n"));
+
+  if (media_segment_duration.valid()) {
+    if (g_cluster_helper->splitting())
+      mxerror(Y("'--media-segment-duration' cannot be used together with '--split'.\n"));
+
+    g_cluster_helper->enable_media_segments(media_segment_duration, media_segment_index_file_name);
+  }
+
   if (!inputs_found && g_files.empty())
     mxerror(Y("No source files were given.\n"));
 }
@@ -2910,7 +3057,9 @@ parse_args(std::vector<std::string> args) {
 static void
 display_playlist_scan_progress(size_t num_scanned,
                                size_t total_num_to_scan) {
-  static auto s_no_progress = debugging_option_c{"no_progress"};
+  static auto s_no_progress     = debugging_option_c{"no_progress"};
+  static auto s_bf_gui_progress = fast_format_c{"#GUI#progress %1%%%\n"};
+  static auto s_bf_progress     = fast_format_c{Y("Progress: %1%%%%2%")};
 
   if (s_no_progress)
     return;
@@ -2918,9 +3067,9 @@ display_playlist_scan_progress(size_t num_scanned,
   auto current_percentage = (num_scanned * 1000 + 5) / total_num_to_scan / 10;
 
   if (g_gui_mode)
-    mxinfo(boost::format("#GUI#progress %1%%%\n") % current_percentage);
+    mxinfo(s_bf_gui_progress % current_percentage);
   else
-    mxinfo(boost::format(Y("Progress: %1%%%%2%")) % current_percentage % "\r");
+    mxinfo(s_bf_progress % current_percentage % "\r");
 }
 
 static filelist_cptr
@@ -3039,6 +3188,208 @@ create_append_mappings_for_playlists() {
   }
 }
 
+/** \brief Let readers skip data discarded in 'parts:' splitting mode
+
+   If the first part to keep doesn't start at the beginning then
+   everything before it is discarded. Readers that know how to seek
+   (e.g. via cues or sample indexes) are told about that by restricting
+   their minimum timestamp. This is only done for files whose
+   timestamps are used as they are, meaning files that aren't
+   appended, whose timestamps aren't synced, shifted or replaced and
+   that aren't playlists with restrictions of their own.
+*/
+static void
+set_timecode_restrictions_for_split_parts() {
+  auto start = g_cluster_helper->get_start_of_first_kept_part();
+  if (!start.valid())
+    return;
+
+  for (auto &file : g_files) {
+    if (   file->appending
+        || file->is_playlist
+        || file->restricted_timecode_min.valid()
+        || !file->ti->m_timecode_syncs.empty()
+        || !file->ti->m_reset_timecodes_specs.empty()
+        || !file->ti->m_all_ext_timecodes.empty())
+      continue;
+
+    file->restricted_timecode_min = start;
+  }
+}
+
+/** \brief Extract the common options to pass on to the split processes
+
+   Runs the same passes over the original command line as
+   \c handle_common_cli_args() so that each token is classified the
+   same way, and returns the options that the processes started by
+   \c --split-processes must use as well (\c --debug, \c --engage,
+   \c --output-charset and \c --ui-language) along with their
+   arguments. The same is done for \c --probe-range-percentage which
+   \c handle_identification_args() removes afterwards. Output
+   redirection, the GUI mode and the verbosity options are not passed
+   on.
+*/
+static std::vector<std::string>
+get_common_args_for_split_processes(std::vector<std::string> args) {
+  auto common_args = std::vector<std::string>{};
+
+  auto take_options = [&args, &common_args](std::vector<std::string> const &options,
+                                            bool has_arg,
+                                            bool keep) {
+    std::size_t i = 0;
+
+    while (args.size() > i) {
+      if (brng::find(options, args[i]) == options.end()) {
+        ++i;
+        continue;
+      }
+
+      auto num_args = std::min<std::size_t>(has_arg ? 2 : 1, args.size() - i);
+      if (keep)
+        common_args.insert(common_args.end(), args.begin() + i, args.begin() + i + num_args);
+      args.erase(args.begin() + i, args.begin() + i + num_args);
+    }
+  };
+
+  take_options({ "--debug", "--engage" },                 true,  true);
+  take_options({ "--gui-mode" },                          false, false);
+  take_options({ "--output-charset" },                    true,  true);
+  take_options({ "-r", "--redirect-output" },             true,  false);
+  take_options({ "--ui-language" },                       true,  true);
+  take_options({ "-v", "--verbose", "-q", "--quiet" },    false, false);
+
+  // Removed by handle_identification_args() before the rest is parsed.
+  take_options({ "--probe-range-percentage" },            true,  true);
+
+  return common_args;
+}
+
+/** \brief Write the split files in parallel by several processes
+
+   If splitting creates several files that don't depend on each other
+   (splitting by timestamps or by timestamp-based parts without
+   linking) then each file can be written by a separate mkvmerge
+   process. Each one is given the parsed command line with the
+   \c --split argument replaced by a single part covering that file's
+   range, with that file's name as the destination file name and with
+   the number of the file so that things done for the first file only
+   (e.g. attachments not meant for all files) are still only done
+   once. The options to replace are identified by the positions
+   recorded while parsing the command line so that e.g. a file name
+   or a title that happens to equal one of them is left alone.
+
+   Each process opens all source files again and reads them from the
+   start. Only the readers that can seek (Matroska and MP4/QuickTime)
+   skip over the content before that process's part thanks to the
+   timestamp restrictions for leading discarded ranges; all other
+   readers read and discard everything up to the part's start. The
+   total amount of data read therefore grows with the number of files
+   for those formats.
+
+   Returns without doing anything if the current mode cannot be
+   handled this way; the files are then written sequentially as
+   usual. Otherwise mkvmerge exits once all processes have finished.
+*/
+static void
+run_split_processes_in_parallel(std::vector<std::string> const &parsed_args,
+                                int argc,
+                                char **argv) {
+  if ((1 >= g_split_num_processes) || g_identifying)
+    return;
+
+  auto ranges = g_cluster_helper->get_independent_output_ranges();
+
+  if (   (ranges.size() < 2)
+      || !g_no_linking
+      || !g_forced_seguids.empty()
+      || g_seguid_link_previous
+      || g_seguid_link_next) {
+    mxwarn(Y("'--split-processes' can only be used when splitting by timecodes or by timecode-based parts without linking and without '--segment-uid', '--link-to-previous' or '--link-to-next'. The files will be written sequentially.\n"));
+    return;
+  }
+
+  // The common options have already been removed from the parsed
+  // command line; the destination file name and the split options
+  // are replaced for each process.
+  auto process_args = get_common_args_for_split_processes(command_line_utf8(argc, argv));
+
+  for (std::size_t idx = 0, num_args = parsed_args.size(); idx < num_args; ++idx)
+    if (brng::find(s_split_processes_replaced_args, idx) == s_split_processes_replaced_args.end())
+      process_args.push_back(parsed_args[idx]);
+
+  // The environment's options have already been included in the
+  // command line. Don't let the processes add them a second time.
+  mtx::sys::unset_environment_variable("MKVTOOLNIX_OPTIONS");
+  mtx::sys::unset_environment_variable("MTX_OPTIONS");
+  mtx::sys::unset_environment_variable(balg::to_upper_copy(get_program_name()) + "_OPTIONS");
+
+#if defined(SYS_WINDOWS)
+  auto exe = mtx::sys::get_installation_path() / "mkvmerge.exe";
+#else
+  auto exe = mtx::sys::get_installation_path() / "mkvmerge";
+#endif
+
+  std::vector<bfs::path> option_files;
+  std::vector<std::string> commands;
+
+  auto remove_option_files = [&option_files]() {
+    boost::system::error_code ec;
+    for (auto const &option_file : option_files)
+      bfs::remove(option_file, ec);
+  };
+
+  for (int idx = 0, num_ranges = ranges.size(); idx < num_ranges; ++idx) {
+    auto const &range = ranges[idx];
+    auto args         = process_args;
+    auto parts        = (boost::format("parts:%1%ns-") % range.first).str();
+
+    if (range.second != std::numeric_limits<int64_t>::max())
+      parts += (boost::format("%1%ns") % range.second).str();
+
+    args.insert(args.begin(), { "--quiet", "--output", create_output_name(idx + 1), "--split", parts, "--split-file-number-offset", to_string(idx) });
+
+    auto option_file = bfs::temp_directory_path() / bfs::unique_path("mkvmerge-%%%%-%%%%-%%%%-%%%%.json");
+    option_files.push_back(option_file);
+
+    try {
+      mm_file_io_c out{option_file.string(), MODE_CREATE};
+      out.puts(mtx::json::dump(nlohmann::json(args)));
+
+    } catch (mtx::mm_io::exception &ex) {
+      remove_option_files();
+      mxerror(boost::format(Y("The file '%1%' could not be opened for writing: %2%.\n")) % option_file.string() % ex);
+    }
+
+    commands.emplace_back((boost::format("\"%1%\" \"@%2%\"") % exe.string() % option_file.string()).str());
+  }
+
+  mxinfo(boost::format(Y("Writing %1% destination files with up to %2% processes in parallel.\n")) % ranges.size() % g_split_num_processes);
+
+  int64_t start = mtx::sys::get_current_time_millis();
+  std::vector<int> results(commands.size(), 0);
+
+  mtx::parallel::for_each_index(commands.size(), [&commands, &results](std::size_t idx) {
+    auto result = mtx::sys::system(commands[idx]);
+#if !defined(SYS_WINDOWS)
+    result      = (-1 != result) && WIFEXITED(result) ? WEXITSTATUS(result) : 2;
+#endif
+    results[idx] = result;
+  }, g_split_num_processes);
+
+  auto exit_code = 0;
+  for (int idx = 0, num_ranges = ranges.size(); idx < num_ranges; ++idx) {
+    if (results[idx] >= 2)
+      mxinfo(boost::format(Y("Error: writing the destination file '%1%' failed.\n")) % create_output_name(idx + 1));
+    exit_code = std::max(exit_code, std::min(results[idx], 2));
+  }
+
+  mxinfo(boost::format(Y("Multiplexing took %1%.\n")) % create_minutes_seconds_time_string((mtx::sys::get_current_time_millis() - start + 500) / 1000, true));
+
+  remove_option_files();
+
+  mxexit(exit_code);
+}
+
 /** \brief Global program initialization
 
    Both platform dependant and independant initialization is done here.
@@ -3078,11 +3429,14 @@ main(int argc,
 
   auto args = setup(argc, argv);
 
+  handle_identification_args(args);
   parse_args(args);
+  run_split_processes_in_parallel(args, argc, argv);
 
   int64_t start = mtx::sys::get_current_time_millis();
 
   add_filelists_for_playlists();
+  set_timecode_restrictions_for_split_parts();
   create_readers();
 
   if (!g_identifying) {
@@ -3108,6 +3462,7 @@ main(int argc,
     create_next_output_file();
     main_loop();
     finish_file(true);
+    queue_budget_c::get().dump_statistics();
   } catch (mtx::mm_io::exception &ex) {
     force_close_output_file();
     mxerror(boost::format("%1% %2% %3% %4%; %5%\n")
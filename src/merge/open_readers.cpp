@@ -0,0 +1,92 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   limit for the number of readers with open source files
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "merge/generic_reader.h"
+#include "merge/open_readers.h"
+
+open_readers_cptr open_readers_c::s_open_readers;
+
+std::size_t const open_readers_c::s_default_limit;
+
+open_readers_c::open_readers_c()
+  : m_limit{s_default_limit}
+  , m_num_suspended{}
+{
+}
+
+void
+open_readers_c::set_limit(std::size_t limit) {
+  m_limit = std::max<std::size_t>(limit, 1);
+}
+
+std::size_t
+open_readers_c::get_limit()
+  const {
+  return m_limit;
+}
+
+void
+open_readers_c::mark_as_used(generic_reader_c &reader) {
+  if (!m_readers.empty() && (m_readers.front() == &reader))
+    return;
+
+  auto itr = m_positions.find(&reader);
+  if (itr != m_positions.end()) {
+    m_readers.splice(m_readers.begin(), m_readers, itr->second);
+    return;
+  }
+
+  m_readers.push_front(&reader);
+  m_positions[&reader] = m_readers.begin();
+
+  while (m_readers.size() > m_limit) {
+    auto least_recently_used = m_readers.back();
+
+    m_readers.pop_back();
+    m_positions.erase(least_recently_used);
+    ++m_num_suspended;
+
+    least_recently_used->suspend_input();
+  }
+}
+
+void
+open_readers_c::unregister(generic_reader_c const &reader) {
+  auto itr = m_positions.find(&reader);
+  if (itr == m_positions.end())
+    return;
+
+  m_readers.erase(itr->second);
+  m_positions.erase(itr);
+}
+
+std::size_t
+open_readers_c::get_num_open()
+  const {
+  return m_readers.size();
+}
+
+uint64_t
+open_readers_c::get_num_suspended()
+  const {
+  return m_num_suspended;
+}
+
+open_readers_c &
+open_readers_c::get() {
+  if (!s_open_readers)
+    s_open_readers = std::make_shared<open_readers_c>();
+  return *s_open_readers;
+}
@@ -0,0 +1,69 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   limit for the number of readers with open source files
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_MERGE_OPEN_READERS_H
+#define MTX_MERGE_OPEN_READERS_H
+
+#include "common/common_pch.h"
+
+#include <list>
+
+class generic_reader_c;
+class open_readers_c;
+using open_readers_cptr = std::shared_ptr<open_readers_c>;
+
+/** \brief Limits the number of readers whose source files are open
+
+   Readers are marked as used whenever packets are read from them.
+   If more readers than the limit set with '--max-open-files' have
+   been used since their files were last closed then the least
+   recently used reader's input is suspended: its file handles and
+   read buffers are released and the file is reopened transparently
+   on the reader's next read.
+
+   Readers whose files have been read completely or whose files will
+   only be appended later on aren't counted.
+*/
+class open_readers_c {
+public:
+  static std::size_t const s_default_limit = 256;
+
+protected:
+  using readers_t = std::list<generic_reader_c *>;
+
+  std::size_t m_limit;
+  // Most recently used reader first.
+  readers_t m_readers;
+  std::unordered_map<generic_reader_c const *, readers_t::iterator> m_positions;
+  uint64_t m_num_suspended;
+
+protected:
+  static open_readers_cptr s_open_readers;
+
+public:
+  open_readers_c();
+
+  void set_limit(std::size_t limit);
+  std::size_t get_limit() const;
+
+  void mark_as_used(generic_reader_c &reader);
+  void unregister(generic_reader_c const &reader);
+
+  std::size_t get_num_open() const;
+  uint64_t get_num_suspended() const;
+
+public:
+  static open_readers_c &get();
+};
+
+#endif  // MTX_MERGE_OPEN_READERS_H
@@ -16,6 +16,7 @@
 #include "common/common_pch.h"
 
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/functional/hash.hpp>
 #include <cmath>
 #include <iostream>
 #include <typeinfo>
@@ -67,6 +68,7 @@
 #include "merge/filelist.h"
 #include "merge/generic_packetizer.h"
 #include "merge/generic_reader.h"
+#include "merge/open_readers.h"
 #include "merge/output_control.h"
 #include "merge/webm.h"
 
@@ -108,6 +110,7 @@ bool g_write_meta_seek_for_clusters         = false;
 bool g_no_lacing                            = false;
 bool g_no_linking                           = true;
 bool g_use_durations                        = false;
+bool g_write_crc32                          = false;
 bool g_no_track_statistics_tags             = false;
 bool g_write_date                           = true;
 
@@ -144,8 +147,10 @@ std::string g_segment_filename, g_previous_segment_filename, g_next_segment_file
 int64_t g_tags_size                         = 0;
 
 int g_file_num = 1;
+int g_file_num_offset = 0;
 
 int g_split_max_num_files                   = 65535;
+int g_split_num_processes                   = 1;
 std::string g_splitting_by_chapters_arg;
 
 append_mode_e g_append_mode                 = APPEND_MODE_FILE_BASED;
@@ -172,6 +177,13 @@ static std::unique_ptr<EbmlVoid> s_kax_chapters_void;
 static int64_t s_max_chapter_size           = 0;
 static std::unique_ptr<EbmlVoid> s_void_after_track_headers;
 
+// Indexes into g_append_mapping by source and by destination (file
+// ID, track ID) so that the mapping for a track can be found without
+// scanning all of them.
+using append_mapping_key_t   = std::pair<size_t, size_t>;
+using append_mapping_index_t = std::unordered_map<append_mapping_key_t, std::size_t, boost::hash<append_mapping_key_t> >;
+static append_mapping_index_t s_append_mapping_by_src, s_append_mapping_by_dst;
+
 static std::vector<std::tuple<timestamp_c, std::string, std::string>> s_additional_chapter_atoms;
 
 static mm_io_cptr s_out;
@@ -215,6 +227,37 @@ calculate_file_duration() {
   return std::llround(static_cast<double>(g_cluster_helper->get_duration()) / static_cast<double>(g_timecode_scale));
 }
 
+static void
+enable_crc32_maybe(EbmlMaster &master) {
+  if (g_write_crc32)
+    master.EnableChecksum();
+}
+
+/** \brief Re-render the segment duration
+
+   Seeks to the position the duration has to be written at and
+   renders it. The caller has to restore the file position.
+
+   If the segment info carries a CRC-32 element then its children were
+   rendered into a temporary buffer. Their positions are therefore not
+   file positions, and the checksum has to be recalculated
+   anyway. Therefore the whole segment info is re-rendered in that
+   case. Its size does not change as the duration's size is fixed.
+*/
+static void
+update_segment_duration() {
+  s_kax_duration->SetValue(calculate_file_duration());
+
+  if (s_kax_infos->HasChecksum()) {
+    s_out->save_pos(s_kax_infos->GetElementPosition());
+    s_kax_infos->Render(*s_out, true);
+
+  } else {
+    s_out->save_pos(s_kax_duration->GetElementPosition());
+    s_kax_duration->Render(*s_out);
+  }
+}
+
 /** \brief Fix the file after mkvmerge has been interrupted
 
    On Unix like systems mkvmerge will install a signal handler. On \c SIGUSR1
@@ -244,14 +287,13 @@ sighandler(int /* signum */) {
   mxinfo(Y("The file is being fixed, part 2/4..."));
   // Now re-render the kax_duration and fill in the biggest timecode
   // as the file's duration.
-  s_out->save_pos(s_kax_duration->GetElementPosition());
-  s_kax_duration->SetValue(calculate_file_duration());
-  s_kax_duration->Render(*s_out);
+  update_segment_duration();
   s_out->restore_pos();
   mxinfo(Y(" done\n"));
 
   mxinfo(Y("The file is being fixed, part 3/4..."));
   if ((g_kax_sh_main->ListSize() > 0) && !hack_engaged(ENGAGE_NO_META_SEEK)) {
+    enable_crc32_maybe(*g_kax_sh_main);
     g_kax_sh_main->UpdateSize();
     if (s_kax_sh_void->ReplaceWith(*g_kax_sh_main, *s_out, true) == INVALID_FILEPOS_T)
       mxwarn(boost::format(Y("This should REALLY not have happened. The space reserved for the first meta seek element was too small. %1%\n")) % BUGMSG);
@@ -302,6 +344,8 @@ display_progress(bool is_100percent = false) {
   static auto s_no_progress             = debugging_option_c{"no_progress"};
   static int64_t s_previous_progress_on = 0;
   static int s_previous_percentage      = -1;
+  static auto s_bf_gui_progress         = fast_format_c{"#GUI#progress %1%%%\n"};
+  static auto s_bf_progress             = fast_format_c{Y("Progress: %1%%%%2%")};
 
   if (s_no_progress)
     return;
@@ -333,9 +377,9 @@ display_progress(bool is_100percent = false) {
   //   exit(42);
 
   if (g_gui_mode)
-    mxinfo(boost::format("#GUI#progress %1%%%\n") % current_percentage);
+    mxinfo(s_bf_gui_progress % current_percentage);
   else
-    mxinfo(boost::format(Y("Progress: %1%%%%2%")) % current_percentage % "\r");
+    mxinfo(s_bf_progress % current_percentage % "\r");
 
   s_previous_percentage  = current_percentage;
   s_previous_progress_on = current_time;
@@ -578,7 +622,7 @@ render_headers(mm_io_c *out) {
     if (!g_segment_title.empty())
       GetChild<KaxTitle>(*s_kax_infos).SetValueUTF8(g_segment_title.c_str());
 
-    bool first_file = (1 == g_file_num);
+    bool first_file = (1 == (g_file_num + g_file_num_offset));
 
     generate_segment_uids();
 
@@ -666,10 +710,12 @@ render_headers(mm_io_c *out) {
     } else
       set_timecode_scale();
 
+    enable_crc32_maybe(*s_kax_infos);
     s_kax_infos->Render(*out, true);
     g_kax_sh_main->IndexThis(*s_kax_infos, *g_kax_segment);
 
     if (!g_packetizers.empty()) {
+      enable_crc32_maybe(*g_kax_tracks);
       g_kax_tracks->UpdateSize(true);
       uint64_t full_header_size = g_kax_tracks->ElementSize(true);
       g_kax_tracks->UpdateSize(false);
@@ -883,7 +929,7 @@ render_attachments(IOCallback *out) {
   for (auto &attachment_p : g_attachments) {
     auto attch = *attachment_p;
 
-    if ((1 == g_file_num) || attch.to_all_files) {
+    if ((1 == (g_file_num + g_file_num_offset)) || attch.to_all_files) {
       kax_a = !kax_a ? &GetChild<KaxAttached>(*s_kax_as) : &GetNextChild<KaxAttached>(*s_kax_as, *kax_a);
 
       if (attch.description != "")
@@ -906,9 +952,11 @@ render_attachments(IOCallback *out) {
     }
   }
 
-  if (s_kax_as->ListSize() != 0)
+  if (s_kax_as->ListSize() != 0) {
+    enable_crc32_maybe(*s_kax_as);
     s_kax_as->Render(*out);
-  else
+
+  } else
     // Delete the kax_as pointer so that it won't be referenced in a seek head.
     s_kax_as.reset();
 }
@@ -949,11 +997,15 @@ check_append_mapping() {
   // Now let's check each appended file if there are NO append to mappings
   // available (in which case we fill in default ones) or if there are fewer
   // mappings than tracks that are to be copied (which is an error).
+  std::vector<size_t> num_mappings_by_src_file(g_files.size(), 0);
+  for (auto const &amap : g_append_mapping)
+    ++num_mappings_by_src_file[amap.src_file_id];
+
   for (auto &src_file : g_files) {
     if (!src_file->appending)
       continue;
 
-    size_t count = boost::count_if(g_append_mapping, [&src_file](auto const &e) { return e.src_file_id == src_file->id; });
+    size_t count = num_mappings_by_src_file[src_file->id];
 
     if ((0 < count) && (src_file-> reader->m_used_track_ids.size() > count))
       mxerror(boost::format(Y("Only partial append mappings were given for the file no. %1% ('%2%'). Either don't specify any mapping (in which case the "
@@ -982,9 +1034,13 @@ check_append_mapping() {
   }
 
   // Some more checks.
-  for (auto &amap : g_append_mapping) {
-    src_file = g_files.begin() + amap.src_file_id;
-    dst_file = g_files.begin() + amap.dst_file_id;
+  s_append_mapping_by_src.clear();
+  s_append_mapping_by_dst.clear();
+
+  for (auto amap_idx = 0u; amap_idx < g_append_mapping.size(); ++amap_idx) {
+    auto &amap = g_append_mapping[amap_idx];
+    src_file   = g_files.begin() + amap.src_file_id;
+    dst_file   = g_files.begin() + amap.dst_file_id;
 
     // 5. Does the "source" file have a track with the src_track_id, and is
     // that track selected for copying?
@@ -999,26 +1055,16 @@ check_append_mapping() {
                               "track can be appended to it. The argument for '--append-to' was invalid.\n")) % amap.dst_file_id % (*dst_file)->name % amap.dst_track_id);
 
     // 7. Is this track already mapped to somewhere else?
-    for (auto &cmp_amap : g_append_mapping) {
-      if (cmp_amap == amap)
-        continue;
-
-      if (   (cmp_amap.src_file_id  == amap.src_file_id)
-          && (cmp_amap.src_track_id == amap.src_track_id))
-        mxerror(boost::format(Y("The track %1% from file no. %2% ('%3%') is to be appended more than once. The argument for '--append-to' was invalid.\n"))
-                % amap.src_track_id % amap.src_file_id % (*src_file)->name);
-    }
+    auto by_src = s_append_mapping_by_src.emplace(append_mapping_key_t{amap.src_file_id, amap.src_track_id}, amap_idx);
+    if (!by_src.second && (g_append_mapping[by_src.first->second] != amap))
+      mxerror(boost::format(Y("The track %1% from file no. %2% ('%3%') is to be appended more than once. The argument for '--append-to' was invalid.\n"))
+              % amap.src_track_id % amap.src_file_id % (*src_file)->name);
 
     // 8. Is there another track that is being appended to the dst_track_id?
-    for (auto &cmp_amap : g_append_mapping) {
-      if (cmp_amap == amap)
-        continue;
-
-      if (   (cmp_amap.dst_file_id  == amap.dst_file_id)
-          && (cmp_amap.dst_track_id == amap.dst_track_id))
-        mxerror(boost::format(Y("More than one track is to be appended to the track %1% from file no. %2% ('%3%'). The argument for '--append-to' was invalid.\n"))
-                % amap.dst_track_id % amap.dst_file_id % (*dst_file)->name);
-    }
+    auto by_dst = s_append_mapping_by_dst.emplace(append_mapping_key_t{amap.dst_file_id, amap.dst_track_id}, amap_idx);
+    if (!by_dst.second && (g_append_mapping[by_dst.first->second] != amap))
+      mxerror(boost::format(Y("More than one track is to be appended to the track %1% from file no. %2% ('%3%'). The argument for '--append-to' was invalid.\n"))
+              % amap.dst_track_id % amap.dst_file_id % (*dst_file)->name);
   }
 
   // Finally see if the packetizers can be connected and connect them if they
@@ -1061,33 +1107,32 @@ check_append_mapping() {
 
   // Calculate the "longest path" -- meaning the maximum number of
   // concatenated files. This is needed for displaying the progress.
-  for (auto amap = g_append_mapping.begin(), amap_end = g_append_mapping.end(); amap != amap_end; ++amap) {
+  for (auto const &amap : g_append_mapping) {
     // Is this the first in a chain?
-    auto cmp_amap = boost::find_if(g_append_mapping, [&amap](auto const &e) {
-      return (*amap              != e)
-          && (amap->dst_file_id  == e.src_file_id)
-          && (amap->dst_track_id == e.src_track_id);
-      });
-
-    if (cmp_amap != g_append_mapping.end())
+    if (s_append_mapping_by_src.count(append_mapping_key_t{amap.dst_file_id, amap.dst_track_id}))
       continue;
 
     // Find consecutive mappings.
-    auto trav_amap  = amap;
+    auto trav_amap  = &amap;
     int path_length = 2;
-    do {
-      for (cmp_amap = g_append_mapping.begin(); cmp_amap != amap_end; ++cmp_amap)
-        if (   (trav_amap->src_file_id  == cmp_amap->dst_file_id)
-            && (trav_amap->src_track_id == cmp_amap->dst_track_id)) {
-          trav_amap = cmp_amap;
-          path_length++;
-          break;
-        }
-    } while (cmp_amap != amap_end);
+    while (true) {
+      auto cmp_amap = s_append_mapping_by_dst.find(append_mapping_key_t{trav_amap->src_file_id, trav_amap->src_track_id});
+      if (cmp_amap == s_append_mapping_by_dst.end())
+        break;
+
+      trav_amap = &g_append_mapping[cmp_amap->second];
+      path_length++;
+    }
 
     if (path_length > s_display_path_length)
       s_display_path_length = path_length;
   }
+
+  // Appended files are only read once the files they're appended to
+  // have been read. Don't keep their files open until then.
+  for (auto &file : g_files)
+    if (file->appending)
+      file->reader->suspend_input();
 }
 
 /** \brief Add chapters from the readers and calculate the max size
@@ -1164,6 +1209,7 @@ create_packetizers() {
   // Create the packetizers.
   for (auto &file : g_files) {
     file->reader->m_appending = file->appending;
+    open_readers_c::get().mark_as_used(*file->reader);
     file->reader->create_packetizers();
 
     if (!s_appending_files)
@@ -1191,13 +1237,13 @@ check_track_id_validity() {
    \arg "-%03d" will be appended
 */
 std::string
-create_output_name() {
+create_output_name(int file_num) {
   std::string s = g_outfile;
   int p2   = 0;
   // First possibility: %d
   int p    = s.find("%d");
   if (0 <= p) {
-    s.replace(p, 2, to_string(g_file_num));
+    s.replace(p, 2, to_string(file_num));
 
     return s;
   }
@@ -1214,13 +1260,13 @@ create_output_name() {
 
       std::string format(&s.c_str()[p]);
       format.erase(p2 - p + 1);
-      s.replace(p, format.size(), (boost::format(format) % g_file_num).str());
+      s.replace(p, format.size(), (boost::format(format) % file_num).str());
 
       return s;
     }
   }
 
-  std::string buffer = (boost::format("-%|1$03d|") % g_file_num).str();
+  std::string buffer = (boost::format("-%|1$03d|") % file_num).str();
 
   // See if we can find a '.'.
   p = s.rfind(".");
@@ -1329,7 +1375,7 @@ create_next_output_file() {
   auto s_debug = debugging_option_c{"splitting"};
   mxdebug_if(s_debug, boost::format("splitting: Create next destination file; splitting? %1% discarding? %2%\n") % g_cluster_helper->splitting() % g_cluster_helper->discarding());
 
-  auto this_outfile   = g_cluster_helper->split_mode_produces_many_files() ? create_output_name() : g_outfile;
+  auto this_outfile   = g_cluster_helper->split_mode_produces_many_files() ? create_output_name(g_file_num) : g_outfile;
   g_kax_segment       = std::make_unique<KaxSegment>();
 
   // Open the output file.
@@ -1441,6 +1487,8 @@ render_chapters() {
   if (outputting_webm())
     remove_chapter_elements_unsupported_by_webm(*s_chapters_in_this_file);
 
+  enable_crc32_maybe(*s_chapters_in_this_file);
+
   auto replaced = false;
   if (s_kax_chapters_void) {
     auto with_defaults = !outputting_webm();
@@ -1500,17 +1548,19 @@ finish_file(bool last_file,
   }
 
   // Render the cues.
+  auto cues_position = s_out->getFilePointer();
+
   if (g_write_cues && g_cue_writing_requested) {
     if (do_output)
       mxinfo(Y("The cue entries (the index) are being written...\n"));
     cues_c::get().write(*s_out, *g_kax_sh_main);
   }
 
+  auto cues_size = s_out->getFilePointer() - cues_position;
+
   // Now re-render the s_kax_duration and fill in the biggest timecode
   // as the file's duration.
-  s_out->save_pos(s_kax_duration->GetElementPosition());
-  s_kax_duration->SetValue(calculate_file_duration());
-  s_kax_duration->Render(*s_out);
+  update_segment_duration();
 
   // If splitting is active and this is the last part then handle the
   // 'next segment UID'. If it was given on the command line then set it here.
@@ -1567,6 +1617,7 @@ finish_file(bool last_file,
 
   // Render the meta seek information with the cues
   if (g_write_meta_seek_for_clusters && (g_kax_sh_cues->ListSize() > 0) && !hack_engaged(ENGAGE_NO_META_SEEK)) {
+    enable_crc32_maybe(*g_kax_sh_cues);
     g_kax_sh_cues->UpdateSize();
     g_kax_sh_cues->Render(*s_out);
     g_kax_sh_main->IndexThis(*g_kax_sh_cues, *g_kax_segment);
@@ -1592,6 +1643,7 @@ finish_file(bool last_file,
 
   if (tags_here) {
     fix_mandatory_elements(tags_here);
+    enable_crc32_maybe(*tags_here);
     tags_here->UpdateSize();
     tags_here->Render(*s_out, true);
 
@@ -1611,6 +1663,7 @@ finish_file(bool last_file,
   }
 
   if ((g_kax_sh_main->ListSize() > 0) && !hack_engaged(ENGAGE_NO_META_SEEK)) {
+    enable_crc32_maybe(*g_kax_sh_main);
     g_kax_sh_main->UpdateSize();
     if (s_kax_sh_void->ReplaceWith(*g_kax_sh_main, *s_out, true) == INVALID_FILEPOS_T)
       mxwarn(boost::format(Y("This should REALLY not have happened. The space reserved for the first meta seek element was too small. Size needed: %1%. %2%\n"))
@@ -1624,6 +1677,9 @@ finish_file(bool last_file,
 
   s_out.reset();
 
+  if (last_file)
+    g_cluster_helper->write_media_segment_index(cues_position, cues_size);
+
   g_kax_segment.reset();
   s_kax_sh_void.reset();
   g_kax_sh_main.reset();
@@ -1707,6 +1763,7 @@ append_track(packetizer_t &ptzr,
     dst_file.old_num_unfinished_packetizers = 0;
     dst_file.done                           = true;
     establish_deferred_connections(dst_file);
+    dst_file.reader->suspend_input();
   }
 
   if (   !ptzr.deferred
@@ -1823,14 +1880,11 @@ append_track(packetizer_t &ptzr,
       ptzr.status = ptzr.packetizer->read(false);
 
     if (src_file.reader->m_ptzr_first_packet) {
-      auto cmp_amap = brng::find_if(g_append_mapping, [&amap, &src_file](append_spec_t const &m) {
-        return (m.src_file_id  == amap.src_file_id)
-            && (m.src_track_id == static_cast<size_t>(src_file.reader->m_ptzr_first_packet->m_ti.m_id))
-            && (m.dst_file_id  == amap.dst_file_id);
-      });
-
-      if (g_append_mapping.end() != cmp_amap) {
-        auto gptzr = dst_file.reader->find_packetizer_by_id(cmp_amap->dst_track_id);
+      auto cmp_amap_idx = s_append_mapping_by_src.find(append_mapping_key_t{amap.src_file_id, static_cast<size_t>(src_file.reader->m_ptzr_first_packet->m_ti.m_id)});
+
+      if (   (s_append_mapping_by_src.end() != cmp_amap_idx)
+          && (g_append_mapping[cmp_amap_idx->second].dst_file_id == amap.dst_file_id)) {
+        auto gptzr = dst_file.reader->find_packetizer_by_id(g_append_mapping[cmp_amap_idx->second].dst_track_id);
         if (gptzr)
           timecode_adjustment = gptzr->m_max_timecode_seen;
       }
@@ -1875,17 +1929,11 @@ append_tracks_maybe() {
     if (FILE_STATUS_DONE_AND_DRY != ptzr.status)
       continue;
 
-    append_spec_t *amap = nullptr;
-    for (auto &amap_idx : g_append_mapping)
-      if ((amap_idx.dst_file_id == static_cast<size_t>(ptzr.file)) && (amap_idx.dst_track_id == static_cast<size_t>(ptzr.packetizer->m_ti.m_id))) {
-        amap = &amap_idx;
-        break;
-      }
-
-    if (!amap)
+    auto amap_idx = s_append_mapping_by_dst.find(append_mapping_key_t{static_cast<size_t>(ptzr.file), static_cast<size_t>(ptzr.packetizer->m_ti.m_id)});
+    if (s_append_mapping_by_dst.end() == amap_idx)
       continue;
 
-    append_track(ptzr, *amap);
+    append_track(ptzr, g_append_mapping[amap_idx->second]);
     appended_a_track = true;
   }
 
@@ -1937,6 +1985,7 @@ check_and_handle_end_of_input_after_pulling(packetizer_t &ptzr) {
   if ((0 >= file.num_unfinished_packetizers) && (0 < file.old_num_unfinished_packetizers)) {
     establish_deferred_connections(file);
     file.done = true;
+    file.reader->suspend_input();
   }
   file.old_num_unfinished_packetizers = file.num_unfinished_packetizers;
 }
@@ -2131,6 +2180,8 @@ cleanup() {
   g_attachments.clear();
   g_track_order.clear();
   g_append_mapping.clear();
+  s_append_mapping_by_src.clear();
+  s_append_mapping_by_dst.clear();
 
   g_seguid_link_previous.reset();
   g_seguid_link_next.reset();
@@ -172,19 +172,19 @@ extern float g_video_fps;
 extern generic_packetizer_c *g_video_packetizer;
 
 extern bool g_write_cues, g_cue_writing_requested, g_write_date;
-extern bool g_no_lacing, g_no_linking, g_use_durations, g_no_track_statistics_tags;
+extern bool g_no_lacing, g_no_linking, g_use_durations, g_no_track_statistics_tags, g_write_crc32;
 
 extern bool g_identifying;
 extern identification_output_format_e g_identification_output_format;
 
-extern int g_file_num;
+extern int g_file_num, g_file_num_offset;
 extern int64_t g_file_sizes;
 
 extern int64_t g_max_ns_per_cluster;
 extern int g_max_blocks_per_cluster;
 extern int g_default_tracks[3], g_default_tracks_priority[3];
 
-extern int g_split_max_num_files;
+extern int g_split_max_num_files, g_split_num_processes;
 extern std::string g_splitting_by_chapters_arg;
 
 extern append_mode_e g_append_mode;
@@ -207,7 +207,7 @@ void finish_file(bool last_file, bool create_new_file = false, bool previously_d
 void force_close_output_file();
 void rerender_track_headers();
 void rerender_ebml_head();
-std::string create_output_name();
+std::string create_output_name(int file_num);
 
 bool set_required_matroska_version(unsigned int required_version);
 bool set_required_matroska_read_version(unsigned int required_version);
@@ -19,6 +19,17 @@
 #include "merge/output_control.h"
 #include "merge/packet.h"
 
+void
+intrusive_ptr_add_ref(packet_t *packet) {
+  packet->m_reference_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+void
+intrusive_ptr_release(packet_t *packet) {
+  if (1 == packet->m_reference_count.fetch_sub(1, std::memory_order_acq_rel))
+    delete packet;
+}
+
 void
 packet_t::normalize_timecodes() {
   // Normalize the timecodes according to the timecode scale.
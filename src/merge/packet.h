@@ -16,7 +16,10 @@
 
 #include "common/common_pch.h"
 
+#include <atomic>
+
 #include "common/timestamp.h"
+#include "merge/packet_fwd.h"
 
 namespace libmatroska {
   class KaxBlock;
@@ -48,46 +51,38 @@ public:
 };
 using packet_extension_cptr = std::shared_ptr<packet_extension_c>;
 
+/** \brief A frame passed from a reader via a packetizer to the cluster helper
+
+   The members needed for each packet on its way to the cluster helper
+   are grouped at the start. Packets are reference counted
+   intrusively: the counter is part of the packet itself instead of
+   a separate control block as with \c std::shared_ptr.
+*/
 struct packet_t {
   memory_cptr data;
-  std::vector<memory_cptr> data_adds;
-  memory_cptr codec_state;
+  int64_t timecode{}, bref{}, fref{}, duration{-1}, assigned_timecode{};
+  generic_packetizer_c *source{};
+  int ref_priority{}, time_factor{1};
+  bool duration_mandatory{}, superseeded{}, gap_following{}, factory_applied{};
 
-  KaxBlockBlob *group;
-  KaxBlock *block;
-  KaxCluster *cluster;
-  int ref_priority, time_factor;
-  int64_t timecode, bref, fref, duration, assigned_timecode;
-  int64_t timecode_before_factory;
-  int64_t unmodified_assigned_timecode, unmodified_duration;
-  boost::optional<uint64_t> uncompressed_size;
+  int64_t timecode_before_factory{};
+  int64_t unmodified_assigned_timecode{}, unmodified_duration{};
   timestamp_c discard_padding, output_order_timecode;
-  bool duration_mandatory, superseeded, gap_following, factory_applied;
-  generic_packetizer_c *source;
+  boost::optional<uint64_t> uncompressed_size;
 
+  KaxBlockBlob *group{};
+  KaxBlock *block{};
+  KaxCluster *cluster{};
+
+  memory_cptr codec_state;
+  std::vector<memory_cptr> data_adds;
   std::vector<packet_extension_cptr> extensions;
 
-  packet_t()
-    : group{}
-    , block{}
-    , cluster{}
-    , ref_priority{}
-    , time_factor(1)
-    , timecode{}
-    , bref{}
-    , fref{}
-    , duration(-1)
-    , assigned_timecode{}
-    , timecode_before_factory{}
-    , unmodified_assigned_timecode{}
-    , unmodified_duration{}
-    , discard_padding{}
-    , duration_mandatory{}
-    , superseeded{}
-    , gap_following{}
-    , factory_applied{}
-    , source{}
-  {
+private:
+  std::atomic<unsigned int> m_reference_count{};
+
+public:
+  packet_t() {
   }
 
   packet_t(memory_cptr p_memory,
@@ -95,26 +90,11 @@ struct packet_t {
            int64_t p_duration = -1,
            int64_t p_bref     = -1,
            int64_t p_fref     = -1)
-    : data(p_memory)
-    , group{}
-    , block{}
-    , cluster{}
-    , ref_priority{}
-    , time_factor(1)
+    : data(std::move(p_memory))
     , timecode(p_timecode)
     , bref(p_bref)
     , fref(p_fref)
     , duration(p_duration)
-    , assigned_timecode{}
-    , timecode_before_factory{}
-    , unmodified_assigned_timecode{}
-    , unmodified_duration{}
-    , discard_padding{}
-    , duration_mandatory{}
-    , superseeded{}
-    , gap_following{}
-    , factory_applied{}
-    , source{}
   {
   }
 
@@ -124,31 +104,25 @@ struct packet_t {
            int64_t p_bref     = -1,
            int64_t p_fref     = -1)
     : data(memory_cptr(n_memory))
-    , group{}
-    , block{}
-    , cluster{}
-    , ref_priority{}
-    , time_factor(1)
     , timecode(p_timecode)
     , bref(p_bref)
     , fref(p_fref)
     , duration(p_duration)
-    , assigned_timecode{}
-    , timecode_before_factory{}
-    , unmodified_assigned_timecode{}
-    , unmodified_duration{}
-    , discard_padding{}
-    , duration_mandatory{}
-    , superseeded{}
-    , gap_following{}
-    , factory_applied{}
-    , source{}
   {
   }
 
+  packet_t(packet_t const &) = delete;
+  packet_t &operator =(packet_t const &) = delete;
+
   ~packet_t() {
   }
 
+  template<typename... Targs>
+  static packet_cptr
+  create(Targs &&... args) {
+    return packet_cptr{new packet_t(std::forward<Targs>(args)...)};
+  }
+
   bool
   has_timecode()
     const {
@@ -225,7 +199,9 @@ struct packet_t {
 
   void account(track_statistics_c &statistics, int64_t timestamp_offset);
   uint64_t calculate_uncompressed_size();
+
+  friend void intrusive_ptr_add_ref(packet_t *packet);
+  friend void intrusive_ptr_release(packet_t *packet);
 };
-using packet_cptr = std::shared_ptr<packet_t>;
 
 #endif // MTX_PACKET_H
@@ -0,0 +1,25 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   forward declarations for the packet structure
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_MERGE_PACKET_FWD_H
+#define MTX_MERGE_PACKET_FWD_H
+
+#include <boost/intrusive_ptr.hpp>
+
+struct packet_t;
+using packet_cptr = boost::intrusive_ptr<packet_t>;
+
+void intrusive_ptr_add_ref(packet_t *packet);
+void intrusive_ptr_release(packet_t *packet);
+
+#endif  // MTX_MERGE_PACKET_FWD_H
@@ -58,10 +58,17 @@ public:
   unsigned int chapter_generation_number{};
   std::string chapter_generation_language;
 
+  timestamp_c media_segment_duration;
+  std::string media_segment_index_file_name;
+  int64_t media_segment_start{-1}, media_segments_end{};
+  bool media_segment_pending{};
+  std::vector<std::pair<int64_t, int64_t> > media_segments; // position of the first cluster, timestamp
+
   std::unordered_map<uint64_t, track_statistics_c> track_statistics;
 
   debugging_option_c debug_splitting{"cluster_helper|splitting"}, debug_packets{"cluster_helper|cluster_helper_packets"}, debug_duration{"cluster_helper|cluster_helper_duration"},
-    debug_rendering{"cluster_helper|cluster_helper_rendering"}, debug_chapter_generation{"cluster_helper|cluster_helper_chapter_generation"};
+    debug_rendering{"cluster_helper|cluster_helper_rendering"}, debug_chapter_generation{"cluster_helper|cluster_helper_chapter_generation"},
+    debug_media_segments{"cluster_helper|media_segments"};
 
 public:
   ~impl_t();
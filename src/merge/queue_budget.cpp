@@ -0,0 +1,114 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   memory budget for queued packets
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#include "common/common_pch.h"
+
+#include "merge/generic_packetizer.h"
+#include "merge/output_control.h"
+#include "merge/queue_budget.h"
+
+queue_budget_cptr queue_budget_c::s_queue_budget;
+
+int64_t const queue_budget_c::s_soft_limit;
+int64_t const queue_budget_c::s_default_hard_limit;
+
+queue_budget_c::queue_budget_c()
+  : m_limit{}
+{
+}
+
+void
+queue_budget_c::set_limit(int64_t limit) {
+  m_limit = limit;
+}
+
+int64_t
+queue_budget_c::get_limit()
+  const {
+  return m_limit;
+}
+
+void
+queue_budget_c::account(generic_packetizer_c const &ptzr,
+                        int64_t num_bytes) {
+  m_usage_by_packetizer[&ptzr].add(num_bytes);
+  m_total.add(num_bytes);
+}
+
+void
+queue_budget_c::unregister(generic_packetizer_c const &ptzr) {
+  auto itr = m_usage_by_packetizer.find(&ptzr);
+  if (itr == m_usage_by_packetizer.end())
+    return;
+
+  m_total.add(-itr->second.m_current);
+  m_usage_by_packetizer.erase(itr);
+}
+
+int64_t
+queue_budget_c::get_total_queued_bytes()
+  const {
+  return m_total.m_current;
+}
+
+int64_t
+queue_budget_c::get_peak_total_queued_bytes()
+  const {
+  return m_total.m_peak;
+}
+
+int64_t
+queue_budget_c::get_peak_queued_bytes(generic_packetizer_c const &ptzr)
+  const {
+  auto itr = m_usage_by_packetizer.find(&ptzr);
+  return itr != m_usage_by_packetizer.end() ? itr->second.m_peak : 0;
+}
+
+bool
+queue_budget_c::must_hold(int64_t num_queued_bytes_of_reader,
+                          bool audio_or_video,
+                          bool force,
+                          int64_t hard_limit)
+  const {
+  if (force)
+    return false;
+
+  if (   (s_soft_limit < num_queued_bytes_of_reader)
+      && (!audio_or_video || (hard_limit < num_queued_bytes_of_reader)))
+    return true;
+
+  return (0 < m_limit) && (m_limit < m_total.m_current);
+}
+
+void
+queue_budget_c::dump_statistics()
+  const {
+  static debugging_option_c s_debug{"queue_statistics"};
+
+  if (!s_debug)
+    return;
+
+  for (auto const &ptzr : g_packetizers) {
+    auto &ti = ptzr.packetizer->m_ti;
+    mxdebug(boost::format("queue statistics: %1% track %2%: peak %3% bytes queued\n") % ti.m_fname % ti.m_id % get_peak_queued_bytes(*ptzr.packetizer));
+  }
+
+  mxdebug(boost::format("queue statistics: peak %1% bytes queued for all tracks, limit %2%\n") % m_total.m_peak % m_limit);
+}
+
+queue_budget_c &
+queue_budget_c::get() {
+  if (!s_queue_budget)
+    s_queue_budget = std::make_shared<queue_budget_c>();
+  return *s_queue_budget;
+}
@@ -0,0 +1,81 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL v2
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   memory budget for queued packets
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_MERGE_QUEUE_BUDGET_H
+#define MTX_MERGE_QUEUE_BUDGET_H
+
+#include "common/common_pch.h"
+
+class generic_packetizer_c;
+class queue_budget_c;
+using queue_budget_cptr = std::shared_ptr<queue_budget_c>;
+
+/** \brief Keeps track of the memory used by packets queued in packetizers
+
+   All packetizers report the number of bytes they add to or remove
+   from their packet queues here. Readers ask before reading more data
+   whether or not they must hold back so that the total amount of
+   memory used by queued packets stays within bounds.
+
+   A reader holds back if the packetizers fed by it have queued more
+   than a soft limit and the requested track is neither an audio nor
+   a video track, or if they've queued more than a reader-specific
+   hard limit. Additionally all readers hold back while the packets
+   queued for all tracks together exceed the global limit set with
+   '--queue-memory-limit'. Reads forced by the main loop because all
+   of a reader's tracks are starving are never held back.
+*/
+class queue_budget_c {
+public:
+  static int64_t const s_soft_limit         =  20 * 1024 * 1024;
+  static int64_t const s_default_hard_limit = 128 * 1024 * 1024;
+
+protected:
+  struct usage_t {
+    int64_t m_current{}, m_peak{};
+
+    void add(int64_t num_bytes) {
+      m_current += num_bytes;
+      m_peak     = std::max(m_peak, m_current);
+    }
+  };
+
+  int64_t m_limit;
+  usage_t m_total;
+  std::unordered_map<generic_packetizer_c const *, usage_t> m_usage_by_packetizer;
+
+protected:
+  static queue_budget_cptr s_queue_budget;
+
+public:
+  queue_budget_c();
+
+  void set_limit(int64_t limit);
+  int64_t get_limit() const;
+
+  void account(generic_packetizer_c const &ptzr, int64_t num_bytes);
+  void unregister(generic_packetizer_c const &ptzr);
+
+  int64_t get_total_queued_bytes() const;
+  int64_t get_peak_total_queued_bytes() const;
+  int64_t get_peak_queued_bytes(generic_packetizer_c const &ptzr) const;
+
+  bool must_hold(int64_t num_queued_bytes_of_reader, bool audio_or_video, bool force, int64_t hard_limit = s_default_hard_limit) const;
+
+  void dump_statistics() const;
+
+public:
+  static queue_budget_c &get();
+};
+
+#endif  // MTX_MERGE_QUEUE_BUDGET_H
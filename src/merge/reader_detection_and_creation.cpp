@@ -15,6 +15,7 @@
 // #include "common/logger.h"
 #include "common/mm_mpls_multi_file_io.h"
 #include "common/mm_read_buffer_io.h"
+#include "common/mm_reopenable_io.h"
 #include "common/strings/formatting.h"
 #include "common/xml/xml.h"
 #include "input/r_aac.h"
@@ -57,6 +58,7 @@
 #include "input/r_webvtt.h"
 #include "merge/filelist.h"
 #include "merge/input_x.h"
+#include "merge/open_readers.h"
 #include "merge/reader_detection_and_creation.h"
 
 static std::vector<bfs::path>
@@ -71,8 +73,10 @@ file_names_to_paths(const std::vector<std::string> &file_names) {
 static mm_io_cptr
 open_input_file(filelist_t &file) {
   try {
-    if (file.all_names.size() == 1)
-      return mm_io_cptr(new mm_read_buffer_io_c(new mm_file_io_c(file.name), 1 << 17));
+    if (file.all_names.size() == 1) {
+      auto file_name = file.name;
+      return mm_io_cptr(new mm_read_buffer_io_c(new mm_reopenable_io_c([file_name]() { return new mm_file_io_c(file_name); }), 1 << 17));
+    }
 
     else {
       std::vector<bfs::path> paths = file_names_to_paths(file.all_names);
@@ -420,6 +424,7 @@ create_readers() {
       }
 
       file->reader->read_headers();
+      open_readers_c::get().mark_as_used(*file->reader);
       file->reader->set_timecode_restrictions(file->restricted_timecode_min, file->restricted_timecode_max);
 
       // Re-calculate file size because the reader might switch to a
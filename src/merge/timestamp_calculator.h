@@ -19,9 +19,7 @@
 #include "common/debugging.h"
 #include "common/samples_to_timestamp_converter.h"
 #include "common/timestamp.h"
-
-class packet_t;
-using packet_cptr = std::shared_ptr<packet_t>;
+#include "merge/packet_fwd.h"
 
 class timestamp_calculator_c {
 private:
@@ -306,6 +306,12 @@ Job::outputFolder()
   return {};
 }
 
+uint64_t
+Job::totalInputSize()
+  const {
+  return 0;
+}
+
 void
 Job::openOutputFolder()
   const {
@@ -88,6 +88,7 @@ public:
   virtual QString displayableType() const = 0;
   virtual QString displayableDescription() const = 0;
   virtual QString outputFolder() const;
+  virtual uint64_t totalInputSize() const;
 
   void setPendingAuto();
   void setPendingManual();
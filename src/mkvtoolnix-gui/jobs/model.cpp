@@ -4,6 +4,9 @@
 #include <QDebug>
 #include <QMutexLocker>
 #include <QSettings>
+#if QT_VERSION >= QT_VERSION_CHECK(5, 4, 0)
+# include <QStorageInfo>
+#endif
 #include <QTimer>
 
 #include "common/list_utils.h"
@@ -298,8 +301,10 @@ Model::onStatusChanged(uint64_t id,
 
   }
 
-  if ((Job::Running == oldStatus) && (Job::Running != newStatus))
+  if ((Job::Running == oldStatus) && (Job::Running != newStatus)) {
     ++m_queueNumDone;
+    updateProgress();
+  }
 
   startNextAutoJob();
 
@@ -389,23 +394,18 @@ Model::startNextAutoJob() {
   if (!m_started)
     return;
 
-  Job *toStart = nullptr;
-  for (auto row = 0, numRows = rowCount(); row < numRows; ++row) {
-    auto job = m_jobsById[idFromRow(row)].get();
-
-    if (Job::Running == job->status())
-      return;
-    if (!toStart && (Job::PendingAuto == job->status()))
-      toStart = job;
+  // Starting a job changes its status, which re-enters this function
+  // via onStatusChanged(). Therefore the limits are re-evaluated from
+  // scratch for each job to start.
+  while (auto toStart = nextAutoJobToStart()) {
+    MainWindow::watchCurrentJobTab()->connectToJob(*toStart);
+    toStart->start();
   }
 
-  if (toStart) {
-    MainWindow::watchCurrentJobTab()->connectToJob(*toStart);
+  updateJobStats();
 
-    toStart->start();
-    updateJobStats();
+  if (hasRunningJobs())
     return;
-  }
 
   // All jobs are done. Clear total progress.
   m_toBeProcessed.clear();
@@ -418,6 +418,70 @@ Model::startNextAutoJob() {
     emit queueStatusChanged(QueueStatus::Stopped);
 }
 
+Job *
+Model::nextAutoJobToStart() {
+  auto const &cfg         = Util::Settings::get();
+  auto numRunning         = 0;
+  auto numRunningPerDrive = QHash<QString, int>{};
+  auto pendingJobs        = QList<Job *>{};
+
+  for (auto row = 0, numRows = rowCount(); row < numRows; ++row) {
+    auto job = m_jobsById[idFromRow(row)].get();
+
+    if (Job::Running == job->status()) {
+      ++numRunning;
+      ++numRunningPerDrive[destinationDriveForJob(*job)];
+
+    } else if (Job::PendingAuto == job->status())
+      pendingJobs << job;
+  }
+
+  if (numRunning >= std::max(cfg.m_maximumConcurrentJobs, 1))
+    return nullptr;
+
+  sortPendingAutoJobs(pendingJobs);
+
+  for (auto const &job : pendingJobs)
+    if (   !cfg.m_maximumConcurrentJobsPerDrive
+        || (numRunningPerDrive.value(destinationDriveForJob(*job)) < cfg.m_maximumConcurrentJobsPerDrive))
+      return job;
+
+  return nullptr;
+}
+
+void
+Model::sortPendingAutoJobs(QList<Job *> &jobs)
+  const {
+  auto order = Util::Settings::get().m_jobQueueOrder;
+
+  if (Util::Settings::JobQueueOrder::AsListed == order)
+    return;
+
+  auto sizes = QHash<Job *, uint64_t>{};
+  for (auto const &job : jobs)
+    sizes[job] = job->totalInputSize();
+
+  if (Util::Settings::JobQueueOrder::SmallestInputFirst == order)
+    std::stable_sort(jobs.begin(), jobs.end(), [&sizes](Job *a, Job *b) { return sizes[a] < sizes[b]; });
+  else
+    std::stable_sort(jobs.begin(), jobs.end(), [&sizes](Job *a, Job *b) { return sizes[a] > sizes[b]; });
+}
+
+QString
+Model::destinationDriveForJob(Job const &job) {
+  auto folder = job.outputFolder();
+  if (folder.isEmpty())
+    return {};
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 4, 0)
+  auto storage = QStorageInfo{folder};
+  if (storage.isValid())
+    return storage.rootPath();
+#endif
+
+  return QDir{folder}.absolutePath();
+}
+
 void
 Model::startJobImmediately(Job &job) {
   QMutexLocker locked{&m_mutex};
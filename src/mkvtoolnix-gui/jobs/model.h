@@ -124,7 +124,11 @@ protected:
 
   void sortJobs(QList<Job *> &jobs, bool reverse);
 
+  Job *nextAutoJobToStart();
+  void sortPendingAutoJobs(QList<Job *> &jobs) const;
+
 public:
+  static QString destinationDriveForJob(Job const &job);
   static void convertJobQueueToSeparateIniFiles();
 };
 
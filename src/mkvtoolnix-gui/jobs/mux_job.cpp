@@ -197,6 +197,26 @@ MuxJob::outputFolder()
   return info.dir().path();
 }
 
+uint64_t
+MuxJob::totalInputSize()
+  const {
+  Q_D(const MuxJob);
+
+  auto size = uint64_t{};
+
+  for (auto const &file : d->config->m_files) {
+    size += QFileInfo{file->m_fileName}.size();
+
+    for (auto const &additionalPart : file->m_additionalParts)
+      size += QFileInfo{additionalPart->m_fileName}.size();
+
+    for (auto const &appendedFile : file->m_appendedFiles)
+      size += QFileInfo{appendedFile->m_fileName}.size();
+  }
+
+  return size;
+}
+
 void
 MuxJob::saveJobInternal(Util::ConfigFile &settings)
   const {
@@ -39,6 +39,7 @@ public:
   virtual QString displayableType() const override;
   virtual QString displayableDescription() const override;
   virtual QString outputFolder() const override;
+  virtual uint64_t totalInputSize() const override;
 
   virtual Merge::MuxConfig const &config() const;
 
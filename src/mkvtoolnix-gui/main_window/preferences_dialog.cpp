@@ -63,6 +63,7 @@ PreferencesDialog::PreferencesDialog(QWidget *parent,
   ui->sbGuiRemoveOldJobsDays->setValue(m_cfg.m_removeOldJobsDays);
   adjustRemoveOldJobsControls();
   setupJobRemovalPolicy();
+  setupConcurrentJobs();
 
   setupCommonLanguages();
   setupCommonCountries();
@@ -236,6 +237,17 @@ PreferencesDialog::setupToolTips() {
                    .arg(QY("Normally completed jobs stay in the queue even over restarts until the user clears them out manually."))
                    .arg(QY("You can opt for having them removed automatically under certain conditions.")));
 
+  Util::setToolTip(ui->sbGuiMaximumConcurrentJobs,
+                   Q("%1 %2")
+                   .arg(QY("The maximum number of jobs from the queue that are run at the same time."))
+                   .arg(QY("Jobs started manually via \"start immediately\" are not subject to this limit.")));
+  auto concurrentJobsPerDriveToolTip = Q("%1 %2")
+    .arg(QY("If enabled, the GUI will not start a job if the configured number of jobs writing to the same drive as that job's destination file are already running."))
+    .arg(QY("Other pending jobs writing to different drives may be started instead."));
+  Util::setToolTip(ui->cbGuiLimitConcurrentJobsPerDrive,   concurrentJobsPerDriveToolTip);
+  Util::setToolTip(ui->sbGuiMaximumConcurrentJobsPerDrive, concurrentJobsPerDriveToolTip);
+  Util::setToolTip(ui->cbGuiJobQueueOrder, QY("Determines which of the jobs pending automatic processing is started next. The source files' total size is used as an estimate for the job's duration."));
+
   Util::setToolTip(ui->leCENameTemplate, ChapterEditor::Tool::chapterNameTemplateToolTip());
   Util::setToolTip(ui->cbCEDefaultLanguage, QY("This is the language that newly added chapter names get assigned automatically."));
   Util::setToolTip(ui->cbCEDefaultCountry, QY("This is the country that newly added chapter names get assigned automatically."));
@@ -414,6 +426,7 @@ PreferencesDialog::setupConnections() {
   connect(ui->cbGuiRemoveJobs,                            &QCheckBox::toggled,                                           ui->cbGuiJobRemovalPolicy,            &QComboBox::setEnabled);
   connect(ui->cbGuiRemoveOldJobs,                         &QCheckBox::toggled,                                           this,                                 &PreferencesDialog::adjustRemoveOldJobsControls);
   connect(ui->sbGuiRemoveOldJobsDays,                     static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this,                                 &PreferencesDialog::adjustRemoveOldJobsControls);
+  connect(ui->cbGuiLimitConcurrentJobsPerDrive,           &QCheckBox::toggled,                                           ui->sbGuiMaximumConcurrentJobsPerDrive, &QSpinBox::setEnabled);
 
   connect(ui->sbMMinPlaylistDuration,                     static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this,                                 &PreferencesDialog::adjustPlaylistControls);
 
@@ -454,6 +467,17 @@ PreferencesDialog::setupJobRemovalPolicy() {
   ui->cbGuiJobRemovalPolicy->setCurrentIndex(idx);
 }
 
+void
+PreferencesDialog::setupConcurrentJobs() {
+  auto limitPerDrive = 0 < m_cfg.m_maximumConcurrentJobsPerDrive;
+
+  ui->sbGuiMaximumConcurrentJobs->setValue(m_cfg.m_maximumConcurrentJobs);
+  ui->cbGuiLimitConcurrentJobsPerDrive->setChecked(limitPerDrive);
+  ui->sbGuiMaximumConcurrentJobsPerDrive->setEnabled(limitPerDrive);
+  ui->sbGuiMaximumConcurrentJobsPerDrive->setValue(limitPerDrive ? m_cfg.m_maximumConcurrentJobsPerDrive : 1);
+  ui->cbGuiJobQueueOrder->setCurrentIndex(static_cast<int>(m_cfg.m_jobQueueOrder));
+}
+
 void
 PreferencesDialog::setupCommonLanguages() {
   auto &allLanguages = App::iso639Languages();
@@ -651,6 +675,9 @@ PreferencesDialog::save() {
   m_cfg.m_jobRemovalPolicy                   = static_cast<Util::Settings::JobRemovalPolicy>(idx);
   m_cfg.m_removeOldJobs                      = ui->cbGuiRemoveOldJobs->isChecked();
   m_cfg.m_removeOldJobsDays                  = ui->sbGuiRemoveOldJobsDays->value();
+  m_cfg.m_maximumConcurrentJobs              = ui->sbGuiMaximumConcurrentJobs->value();
+  m_cfg.m_maximumConcurrentJobsPerDrive      = ui->cbGuiLimitConcurrentJobsPerDrive->isChecked() ? ui->sbGuiMaximumConcurrentJobsPerDrive->value() : 0;
+  m_cfg.m_jobQueueOrder                      = static_cast<Util::Settings::JobQueueOrder>(ui->cbGuiJobQueueOrder->currentIndex());
 
   m_cfg.m_chapterNameTemplate                = ui->leCENameTemplate->text();
   m_cfg.m_ceTextFileCharacterSet             = ui->cbCETextFileCharacterSet->currentData().toString();
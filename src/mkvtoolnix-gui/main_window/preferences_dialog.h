@@ -79,6 +79,7 @@ protected:
   void setupTabPositions();
   void setupWhenToSetDefaultLanguage();
   void setupJobRemovalPolicy();
+  void setupConcurrentJobs();
   void setupCommonLanguages();
   void setupCommonCountries();
   void setupCommonCharacterSets();
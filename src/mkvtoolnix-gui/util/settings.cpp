@@ -273,6 +273,9 @@ Settings::load() {
   m_jobRemovalPolicy                   = static_cast<JobRemovalPolicy>(reg.value("jobRemovalPolicy", static_cast<int>(JobRemovalPolicy::Never)).toInt());
   m_removeOldJobs                      = reg.value("removeOldJobs",                                  true).toBool();
   m_removeOldJobsDays                  = reg.value("removeOldJobsDays",                              14).toInt();
+  m_maximumConcurrentJobs              = std::max(reg.value("maximumConcurrentJobs",                  1).toInt(), 1);
+  m_maximumConcurrentJobsPerDrive      = std::max(reg.value("maximumConcurrentJobsPerDrive",          0).toInt(), 0);
+  m_jobQueueOrder                      = static_cast<JobQueueOrder>(reg.value("jobQueueOrder", static_cast<int>(JobQueueOrder::AsListed)).toInt());
 
   m_disableAnimations                  = reg.value("disableAnimations", false).toBool();
   m_showToolSelector                   = reg.value("showToolSelector", true).toBool();
@@ -518,6 +521,9 @@ Settings::save()
   reg.setValue("jobRemovalPolicy",                   static_cast<int>(m_jobRemovalPolicy));
   reg.setValue("removeOldJobs",                      m_removeOldJobs);
   reg.setValue("removeOldJobsDays",                  m_removeOldJobsDays);
+  reg.setValue("maximumConcurrentJobs",              m_maximumConcurrentJobs);
+  reg.setValue("maximumConcurrentJobsPerDrive",      m_maximumConcurrentJobsPerDrive);
+  reg.setValue("jobQueueOrder",                      static_cast<int>(m_jobQueueOrder));
 
   reg.setValue("disableAnimations",                  m_disableAnimations);
   reg.setValue("showToolSelector",                   m_showToolSelector);
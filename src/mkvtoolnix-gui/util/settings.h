@@ -76,6 +76,12 @@ public:
     Always,
   };
 
+  enum class JobQueueOrder {
+    AsListed,
+    SmallestInputFirst,
+    LargestInputFirst,
+  };
+
   enum class ClearMergeSettingsAction {
     None,
     NewSettings,
@@ -152,6 +158,8 @@ public:
   JobRemovalPolicy m_jobRemovalPolicy;
   bool m_removeOldJobs;
   int m_removeOldJobsDays;
+  int m_maximumConcurrentJobs, m_maximumConcurrentJobsPerDrive;
+  JobQueueOrder m_jobQueueOrder;
   bool m_useDefaultJobDescription, m_showOutputOfAllJobs, m_switchToJobOutputAfterStarting, m_resetJobWarningErrorCountersOnExit;
 
   bool m_checkForUpdates;
@@ -125,7 +125,7 @@ aac_packetizer_c::process(packet_cptr packet) {
   while (m_parser.frames_available()) {
     auto frame = m_parser.get_frame();
 
-    process_headerless(std::make_shared<packet_t>(frame.m_data));
+    process_headerless(packet_t::create(frame.m_data));
 
     if (verbose && frame.m_garbage_size)
       mxwarn_tid(m_ti.m_fname, m_ti.m_id, boost::format(Y("Skipping %1% bytes (no valid AAC header found). This might cause audio/video desynchronisation.\n")) % frame.m_garbage_size);
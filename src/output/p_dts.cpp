@@ -170,7 +170,7 @@ dts_packetizer_c::process_available_packets() {
     auto samples_in_packet = header.get_packet_length_in_core_samples();
     auto new_timecode      = m_timestamp_calculator.get_next_timestamp(samples_in_packet, packet_position);
 
-    add_packet(std::make_shared<packet_t>(data, new_timecode.to_ns(), header.get_packet_length_in_nanoseconds().to_ns()));
+    add_packet(packet_t::create(data, new_timecode.to_ns(), header.get_packet_length_in_nanoseconds().to_ns()));
   }
 
   m_queued_packets.clear();
@@ -70,7 +70,7 @@ truehd_packetizer_c::process_framed(truehd_frame_cptr const &frame,
   auto timecode  = m_timestamp_calculator.get_next_timestamp(samples).to_ns();
   auto duration  = m_timestamp_calculator.get_duration(samples).to_ns();
 
-  add_packet(std::make_shared<packet_t>(frame->m_data, timecode, duration, frame->is_sync() ? -1 : m_ref_timecode));
+  add_packet(packet_t::create(frame->m_data, timecode, duration, frame->is_sync() ? -1 : m_ref_timecode));
 
   m_ref_timecode = timecode;
 }
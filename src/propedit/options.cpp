@@ -14,6 +14,8 @@
 #include <matroska/KaxTag.h>
 #include <matroska/KaxTags.h>
 
+#include "common/mm_io_x.h"
+#include "common/strings/parsing.h"
 #include "propedit/chapter_target.h"
 #include "propedit/options.h"
 #include "propedit/propedit.h"
@@ -24,12 +26,13 @@
 options_c::options_c()
   : m_show_progress(false)
   , m_parse_mode(kax_analyzer_c::parse_mode_fast)
+  , m_num_jobs(1)
 {
 }
 
 void
 options_c::validate() {
-  if (m_file_name.empty())
+  if (m_file_name.empty() && m_file_list_names.empty())
     mxerror(Y("No file name given.\n"));
 
   if (!has_changes())
@@ -124,10 +127,62 @@ options_c::add_delete_track_statistics_tags(tag_target_c::tag_operation_mode_e o
 
 void
 options_c::set_file_name(const std::string &file_name) {
-  if (!m_file_name.empty())
-    mxerror(boost::format(Y("More than one file name has been given ('%1%' and '%2%').\n")) % m_file_name % file_name);
+  if (m_file_name.empty())
+    m_file_name = file_name;
+
+  m_file_names.push_back(file_name);
+}
+
+void
+options_c::add_file_list(std::string const &file_name) {
+  m_file_list_names.push_back(file_name);
+}
+
+void
+options_c::set_num_jobs(std::string const &num_jobs) {
+  if (!parse_number(num_jobs, m_num_jobs) || !m_num_jobs)
+    throw false;
+}
+
+void
+options_c::set_summary_file_name(std::string const &file_name) {
+  m_summary_file_name = file_name;
+}
+
+bool
+options_c::is_batch_mode()
+  const
+{
+  return (1 < m_file_names.size()) || !m_file_list_names.empty() || !m_summary_file_name.empty();
+}
+
+/** \brief All files to process in batch mode
+
+   Returns the file names given on the command line followed by the
+   ones read from the file lists. File lists contain one file name per
+   line; empty lines are ignored.
+*/
+std::vector<std::string>
+options_c::get_all_file_names()
+  const
+{
+  auto file_names = m_file_names;
+
+  for (auto const &list_name : m_file_list_names) {
+    try {
+      mm_text_io_c in{new mm_file_io_c{list_name}};
+      std::string line;
+
+      while (in.getline2(line))
+        if (!line.empty())
+          file_names.push_back(line);
+
+    } catch (mtx::mm_io::exception &ex) {
+      mxerror(boost::format(Y("The file '%1%' could not be opened for reading: %2%.\n")) % list_name % ex);
+    }
+  }
 
-  m_file_name = file_name;
+  return file_names;
 }
 
 void
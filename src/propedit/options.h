@@ -26,6 +26,11 @@ public:
   bool m_show_progress;
   kax_analyzer_c::parse_mode_e m_parse_mode;
 
+  // Batch mode: several files are processed with the same changes.
+  std::vector<std::string> m_file_names, m_file_list_names;
+  std::string m_summary_file_name;
+  unsigned int m_num_jobs;
+
 public:
   options_c();
 
@@ -38,6 +43,11 @@ public:
   void add_attachment_command(attachment_target_c::command_e command, std::string const &spec, attachment_target_c::options_t const &options);
   void add_delete_track_statistics_tags(tag_target_c::tag_operation_mode_e operation_mode);
   void set_file_name(const std::string &file_name);
+  void add_file_list(std::string const &file_name);
+  void set_num_jobs(std::string const &num_jobs);
+  void set_summary_file_name(std::string const &file_name);
+  bool is_batch_mode() const;
+  std::vector<std::string> get_all_file_names() const;
   void set_parse_mode(const std::string &parse_mode);
   void dump_info() const;
   bool has_changes() const;
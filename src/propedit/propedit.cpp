@@ -16,12 +16,51 @@
 #include <matroska/KaxTracks.h>
 
 #include "common/command_line.h"
+#include "common/fs_sys_helpers.h"
+#include "common/json.h"
 #include "common/list_utils.h"
 #include "common/mm_io_x.h"
+#include "common/parallel.h"
 #include "common/unique_numbers.h"
 #include "common/version.h"
 #include "propedit/propedit_cli_parser.h"
 
+extern bool g_warning_issued;
+
+namespace {
+
+// Thrown instead of exiting by mxerror() while processing a file in
+// batch mode so that the remaining files can still be processed.
+class file_failed_x: public mtx::exception {
+protected:
+  std::string m_message;
+
+public:
+  file_failed_x(std::string const &message)
+    : m_message{message}
+  {
+  }
+
+  virtual const char *what() const throw() {
+    return m_message.c_str();
+  }
+};
+
+struct file_result_t {
+  enum class status_e {
+    modified,
+    unchanged,
+    failed,
+  };
+
+  std::string m_file_name;
+  status_e m_status{status_e::failed};
+  std::vector<std::string> m_warnings;
+  std::string m_error;
+};
+
+}
+
 static void
 display_update_element_result(const EbmlCallbacks &callbacks,
                               kax_analyzer_c::update_element_result_e result) {
@@ -106,8 +145,8 @@ write_changes(options_cptr &options,
   }
 }
 
-static void
-run(options_cptr &options) {
+static bool
+process_file(options_cptr &options) {
   console_kax_analyzer_cptr analyzer;
 
   try {
@@ -155,12 +194,300 @@ run(options_cptr &options) {
 
     mxinfo(Y("Done.\n"));
 
-  } else
-    mxinfo(Y("No changes were made.\n"));
+    return true;
+  }
+
+  mxinfo(Y("No changes were made.\n"));
+
+  return false;
+}
+
+static void
+run(options_cptr &options) {
+  process_file(options);
 
   mxexit();
 }
 
+// ------------------------------------------------------------
+// Batch mode
+
+static char const *
+file_result_status_name(file_result_t::status_e status) {
+  return status == file_result_t::status_e::modified  ? "modified"
+       : status == file_result_t::status_e::unchanged ? "unchanged"
+       :                                                "failed";
+}
+
+static nlohmann::json
+file_results_to_json(std::vector<file_result_t> const &results) {
+  auto json = nlohmann::json::array();
+
+  for (auto const &result : results) {
+    auto entry = nlohmann::json{
+      { "file_name", result.m_file_name                          },
+      { "status",    file_result_status_name(result.m_status)     },
+      { "warnings",  result.m_warnings                           },
+    };
+
+    if (result.m_status == file_result_t::status_e::failed)
+      entry["error"] = result.m_error;
+
+    json.push_back(entry);
+  }
+
+  return json;
+}
+
+static std::vector<file_result_t>
+file_results_from_json(std::string const &file_name) {
+  std::vector<file_result_t> results;
+
+  try {
+    std::string content;
+    mm_text_io_c in{new mm_file_io_c{file_name}};
+    in.read(content, in.get_size());
+
+    for (auto const &entry : mtx::json::parse(content)) {
+      file_result_t result;
+      auto status = entry.at("status").get<std::string>();
+
+      result.m_file_name = entry.at("file_name").get<std::string>();
+      result.m_status    = status == "modified"  ? file_result_t::status_e::modified
+                         : status == "unchanged" ? file_result_t::status_e::unchanged
+                         :                         file_result_t::status_e::failed;
+      result.m_warnings  = entry.at("warnings").get<std::vector<std::string>>();
+
+      if (entry.count("error"))
+        result.m_error = entry.at("error").get<std::string>();
+
+      results.push_back(result);
+    }
+
+  } catch (mtx::mm_io::exception &) {
+  } catch (std::exception &) {
+  }
+
+  return results;
+}
+
+static void
+write_file_results(std::string const &file_name,
+                   std::vector<file_result_t> const &results) {
+  try {
+    mm_file_io_c out{file_name, MODE_CREATE};
+    out.puts(mtx::json::dump(file_results_to_json(results), 2) + "\n");
+
+  } catch (mtx::mm_io::exception &ex) {
+    mxerror(boost::format(Y("The file '%1%' could not be opened for writing: %2%.\n")) % file_name % ex);
+  }
+}
+
+/** \brief Process files one after the other in this process
+
+   Each file is processed with its own set of options parsed from the
+   original command line. Errors only abort processing of the current
+   file: mxerror() throws an exception instead of exiting while a file
+   is processed. Warnings are recorded for the file they occur in.
+*/
+static std::vector<file_result_t>
+process_files_sequentially(std::vector<std::string> const &args,
+                           std::vector<std::string> const &file_names) {
+  std::vector<file_result_t> results;
+  file_result_t *current_result = nullptr;
+
+  set_mxmsg_handler(MXMSG_WARNING, [&current_result](unsigned int, std::string const &message) {
+    if (current_result)
+      current_result->m_warnings.push_back(message);
+
+    if (g_suppress_warnings)
+      return;
+
+    mxmsg(MXMSG_WARNING, message);
+    g_warning_issued = true;
+  });
+
+  set_mxmsg_handler(MXMSG_ERROR, [](unsigned int, std::string const &message) {
+    mxmsg(MXMSG_ERROR, message);
+    throw file_failed_x{message};
+  });
+
+  results.reserve(file_names.size());
+
+  for (auto const &file_name : file_names) {
+    results.emplace_back();
+    current_result              = &results.back();
+    current_result->m_file_name = file_name;
+
+    mxinfo(boost::format(Y("Processing the file '%1%'.\n")) % file_name);
+
+    try {
+      clear_list_of_unique_numbers(UNIQUE_ALL_IDS);
+
+      auto file_args = args;
+      file_args.insert(file_args.begin(), file_name);
+
+      auto options            = propedit_cli_parser_c{file_args, false}.run();
+      options->m_file_name    = file_name;
+      auto modified           = process_file(options);
+      current_result->m_status = modified ? file_result_t::status_e::modified : file_result_t::status_e::unchanged;
+
+    } catch (file_failed_x &ex) {
+      current_result->m_error = ex.what();
+      balg::trim_right(current_result->m_error);
+    }
+  }
+
+  current_result = nullptr;
+
+  set_mxmsg_handler(MXMSG_ERROR, [](unsigned int, std::string const &message) {
+    mxmsg(MXMSG_ERROR, message);
+    mxexit(2);
+  });
+
+  return results;
+}
+
+/** \brief Process files concurrently by several worker processes
+
+   Each worker is an mkvpropedit process that gets the same common
+   options (except for '--redirect-output') and actions and every n-th
+   file and processes its files sequentially. Its output is redirected into a
+   temporary file which is shown once the worker has finished. Its
+   results are read from a temporary summary file. Files of a worker
+   that terminated abnormally without reporting a result are marked as
+   failed.
+*/
+static std::vector<file_result_t>
+process_files_in_parallel(std::vector<std::string> const &common_args,
+                          std::vector<std::string> const &args,
+                          std::vector<std::string> const &file_names,
+                          unsigned int num_jobs) {
+  num_jobs = std::min<std::size_t>(num_jobs, file_names.size());
+
+#if defined(SYS_WINDOWS)
+  auto exe = mtx::sys::get_installation_path() / "mkvpropedit.exe";
+#else
+  auto exe = mtx::sys::get_installation_path() / "mkvpropedit";
+#endif
+
+  std::vector<bfs::path> temp_files;
+  std::vector<std::string> commands;
+
+  auto remove_temp_files = [&temp_files]() {
+    boost::system::error_code ec;
+    for (auto const &temp_file : temp_files)
+      bfs::remove(temp_file, ec);
+  };
+
+  auto temp_file_name = [&temp_files](std::string const &pattern) -> std::string {
+    temp_files.push_back(bfs::temp_directory_path() / bfs::unique_path(pattern));
+    return temp_files.back().string();
+  };
+
+  for (auto job = 0u; job < num_jobs; ++job) {
+    auto option_file_name  = temp_file_name("mkvpropedit-%%%%-%%%%-%%%%-%%%%.json");
+    auto summary_file_name = temp_file_name("mkvpropedit-summary-%%%%-%%%%-%%%%-%%%%.json");
+    auto output_file_name  = temp_file_name("mkvpropedit-output-%%%%-%%%%-%%%%-%%%%.txt");
+    auto job_args          = common_args;
+
+    job_args.insert(job_args.end(), args.begin(), args.end());
+    job_args.insert(job_args.end(), { "--jobs", "1", "--summary-file", summary_file_name, "--redirect-output", output_file_name });
+
+    for (auto idx = job; idx < file_names.size(); idx += num_jobs)
+      job_args.push_back(file_names[idx]);
+
+    try {
+      mm_file_io_c out{option_file_name, MODE_CREATE};
+      out.puts(mtx::json::dump(nlohmann::json(job_args)));
+
+    } catch (mtx::mm_io::exception &ex) {
+      remove_temp_files();
+      mxerror(boost::format(Y("The file '%1%' could not be opened for writing: %2%.\n")) % option_file_name % ex);
+    }
+
+    commands.emplace_back((boost::format("\"%1%\" \"@%2%\"") % exe.string() % option_file_name).str());
+  }
+
+  mtx::parallel::for_each_index(commands.size(), [&commands](std::size_t job) {
+    mtx::sys::system(commands[job]);
+  }, num_jobs);
+
+  std::vector<file_result_t> results(file_names.size());
+
+  for (auto job = 0u; job < num_jobs; ++job) {
+    auto const &output_file_name = temp_files[job * 3 + 2];
+
+    try {
+      std::string output;
+      mm_text_io_c in{new mm_file_io_c{output_file_name.string()}};
+      in.read(output, in.get_size());
+      mxinfo(output);
+
+    } catch (mtx::mm_io::exception &) {
+    }
+
+    auto job_results = file_results_from_json(temp_files[job * 3 + 1].string());
+    auto result_idx  = 0u;
+
+    for (auto idx = job; idx < file_names.size(); idx += num_jobs, ++result_idx) {
+      if (result_idx < job_results.size())
+        results[idx] = job_results[result_idx];
+
+      else {
+        results[idx].m_file_name = file_names[idx];
+        results[idx].m_error     = Y("The process handling this file terminated abnormally.");
+      }
+    }
+  }
+
+  remove_temp_files();
+
+  return results;
+}
+
+/** \brief Apply the same changes to several files
+
+   Used if more than one file name or a file list or a summary file has
+   been given. The files are processed either sequentially or by up to
+   \c m_num_jobs worker processes concurrently. A failure only affects
+   the file it occurs in. Afterwards the number of modified, unchanged
+   and failed files is shown and each file's result is written to the
+   summary file if requested.
+*/
+static void
+run_batch(options_cptr &options,
+          std::vector<std::string> const &common_args,
+          std::vector<std::string> const &args) {
+  auto file_names = options->get_all_file_names();
+
+  if (file_names.empty())
+    mxerror(Y("No file name given.\n"));
+
+  auto results = 1 < options->m_num_jobs ? process_files_in_parallel(common_args, args, file_names, options->m_num_jobs)
+               :                           process_files_sequentially(args, file_names);
+
+  if (!options->m_summary_file_name.empty())
+    write_file_results(options->m_summary_file_name, results);
+
+  auto count = [&results](file_result_t::status_e status) {
+    return boost::count_if(results, [status](file_result_t const &result) { return result.m_status == status; });
+  };
+
+  auto num_failed = count(file_result_t::status_e::failed);
+
+  mxinfo(boost::format(Y("%1% files processed: %2% modified, %3% unchanged, %4% failed.\n"))
+         % results.size() % count(file_result_t::status_e::modified) % count(file_result_t::status_e::unchanged) % num_failed);
+
+  for (auto const &result : results)
+    if (result.m_status == file_result_t::status_e::failed)
+      mxinfo(boost::format(Y("Failed: '%1%': %2%\n")) % result.m_file_name % result.m_error);
+
+  auto has_warnings = mtx::any(results, [](file_result_t const &result) { return !result.m_warnings.empty(); });
+
+  mxexit(num_failed ? 2 : has_warnings ? 1 : 0);
+}
+
 static
 void setup(char **argv) {
   mtx_common_init("mkvpropedit", argv[0]);
@@ -178,13 +505,17 @@ main(int argc,
      char **argv) {
   setup(argv);
 
-  options_cptr options = propedit_cli_parser_c(command_line_utf8(argc, argv)).run();
+  propedit_cli_parser_c parser{command_line_utf8(argc, argv)};
+  options_cptr options = parser.run();
 
   if (debugging_c::requested("dump_options")) {
     mxinfo("\nDumping options after parsing the command line\n\n");
     options->dump_info();
   }
 
+  if (options->is_batch_mode())
+    run_batch(options, parser.get_common_args(), parser.get_args_without_file_names());
+
   run(options);
 
   mxexit();
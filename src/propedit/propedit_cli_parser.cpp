@@ -19,11 +19,13 @@
 #include "common/translation.h"
 #include "propedit/propedit_cli_parser.h"
 
-propedit_cli_parser_c::propedit_cli_parser_c(const std::vector<std::string> &args)
+propedit_cli_parser_c::propedit_cli_parser_c(const std::vector<std::string> &args,
+                                             bool handle_common_args)
   : cli_parser_c(args)
   , m_options(options_cptr(new options_c))
   , m_target(m_options->add_track_or_segmentinfo_target("segment_info"))
 {
+  m_no_common_cli_args = !handle_common_args;
 }
 
 void
@@ -199,6 +201,25 @@ propedit_cli_parser_c::set_file_name() {
   m_options->set_file_name(m_current_arg);
 }
 
+void
+propedit_cli_parser_c::add_file_list() {
+  m_options->add_file_list(m_next_arg);
+}
+
+void
+propedit_cli_parser_c::set_num_jobs() {
+  try {
+    m_options->set_num_jobs(m_next_arg);
+  } catch (...) {
+    mxerror(boost::format(Y("Invalid number of jobs in '%1% %2%'.\n")) % m_current_arg % m_next_arg);
+  }
+}
+
+void
+propedit_cli_parser_c::set_summary_file_name() {
+  m_options->set_summary_file_name(m_next_arg);
+}
+
 #define OPT(spec, func, description) add_option(spec, std::bind(&propedit_cli_parser_c::func, this), description)
 
 void
@@ -209,6 +230,11 @@ propedit_cli_parser_c::init_parser() {
   OPT("l|list-property-names",      list_property_names, YT("List all valid property names and exit"));
   OPT("p|parse-mode=<mode>",        set_parse_mode,      YT("Sets the Matroska parser mode to 'fast' (default) or 'full'"));
 
+  add_section_header(YT("Options for processing several files"));
+  OPT("file-list=<filename>",       add_file_list,         YT("Read the names of the files to process from 'filename' (one per line)"));
+  OPT("jobs=<n>",                   set_num_jobs,          YT("Process up to 'n' files at the same time (default: 1)"));
+  OPT("summary-file=<filename>",    set_summary_file_name, YT("Write each file's result to 'filename' in JSON format"));
+
   add_section_header(YT("Actions for handling properties"));
   OPT("e|edit=<selector>",          add_target,          YT("Sets the Matroska file section that all following add/set/delete "
                                                             "actions operate on (see below and man page for syntax)"));
@@ -241,6 +267,7 @@ propedit_cli_parser_c::init_parser() {
 
   add_separator();
   add_information(YT("The order of the various options is not important."));
+  add_information(YT("If more than one file is given then the same actions are applied to each of them."));
 
   add_section_header(YT("Edit selectors for properties"), 0);
   add_section_header(YT("Segment information"), 1);
@@ -288,3 +315,63 @@ propedit_cli_parser_c::run() {
 
   return m_options;
 }
+
+/** \brief The command line arguments without the files to process
+
+   Returns the options that have been parsed and their arguments
+   without the names of the files to process, without the options for
+   processing several files and without the common options like
+   '--redirect-output'. Must be called after \c run(). The result is
+   used for processing each file of a batch individually.
+*/
+std::vector<std::string>
+propedit_cli_parser_c::get_args_without_file_names()
+  const {
+  static auto const s_options_to_skip = std::vector<std::string>{ "--file-list", "--jobs", "--summary-file" };
+
+  auto args = std::vector<std::string>{};
+
+  // The common options have already been removed from m_args. Apart
+  // from the options and their arguments only file names remain.
+  for (auto arg = m_args.begin(), end = m_args.end(); arg != end; ++arg) {
+    auto option_it = m_option_map.find(*arg);
+    if (option_it == m_option_map.end())
+      continue;
+
+    auto has_arg = option_it->second.m_needs_arg && ((arg + 1) != end);
+
+    if (brng::find(s_options_to_skip, *arg) != s_options_to_skip.end()) {
+      if (has_arg)
+        ++arg;
+      continue;
+    }
+
+    args.push_back(*arg);
+    if (has_arg)
+      args.push_back(*++arg);
+  }
+
+  return args;
+}
+
+/** \brief The common options given on the command line
+
+   Returns the options consumed by \c handle_common_cli_args() while
+   parsing with their arguments, e.g. '--ui-language' or '--debug',
+   except for '--redirect-output'. Must be called after \c run(). They're
+   passed on to the worker processes.
+*/
+std::vector<std::string>
+propedit_cli_parser_c::get_common_args()
+  const {
+  auto args = std::vector<std::string>{};
+
+  for (auto arg = m_common_args.begin(), end = m_common_args.end(); arg != end; ++arg) {
+    if ((*arg == "-r") || (*arg == "--redirect-output"))
+      ++arg;
+    else
+      args.push_back(*arg);
+  }
+
+  return args;
+}
@@ -24,9 +24,11 @@ protected:
   attachment_target_c::options_t m_attachment;
 
 public:
-  propedit_cli_parser_c(const std::vector<std::string> &args);
+  propedit_cli_parser_c(const std::vector<std::string> &args, bool handle_common_args = true);
 
   options_cptr run();
+  std::vector<std::string> get_args_without_file_names() const;
+  std::vector<std::string> get_common_args() const;
 
 protected:
   void init_parser();
@@ -38,6 +40,9 @@ protected:
   void add_chapters();
   void set_parse_mode();
   void set_file_name();
+  void add_file_list();
+  void set_num_jobs();
+  void set_summary_file_name();
 
   void set_attachment_name();
   void set_attachment_description();
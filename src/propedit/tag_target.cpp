@@ -20,8 +20,10 @@
 
 #include "common/hacks.h"
 #include "common/kax_analyzer.h"
+#include "common/kax_block_header_scanner.h"
 #include "common/kax_file.h"
 #include "common/list_utils.h"
+#include "common/mm_read_buffer_io.h"
 #include "common/output.h"
 #include "common/strings/editing.h"
 #include "common/strings/parsing.h"
@@ -323,8 +325,56 @@ tag_target_c::account_one_cluster(KaxCluster &cluster) {
   }
 }
 
+bool
+tag_target_c::account_all_block_headers() {
+  auto &file             = m_analyzer->get_file();
+  auto file_size         = file.get_size();
+  auto previous_progress = 0;
+
+  // Only the element and block headers are read. Small frames are
+  // skipped within the read buffer; larger ones by seeking.
+  mm_read_buffer_io_c buffered_file{&file, 128 * 1024, false};
+  kax_block_header_scanner_c scanner{buffered_file, static_cast<int64_t>(m_timecode_scale)};
+
+  scanner.set_progress_callback([file_size, &previous_progress](uint64_t position) {
+    auto current_progress = std::lround(position * 100ull / static_cast<double>(file_size));
+    if (current_progress != previous_progress) {
+      mxinfo(boost::format(Y("Progress: %1%%%%2%")) % current_progress % "\r");
+      previous_progress = current_progress;
+    }
+  });
+
+  return scanner.scan(m_analyzer->get_segment_data_start_pos(), m_analyzer->get_segment_end(), [this](kax_block_header_scanner_c::block_t const &block) {
+    auto num_frames = block.m_frame_sizes.size();
+    auto stats_itr  = m_track_statistics_by_number.find(block.m_track_number);
+
+    if (!num_frames || (stats_itr == m_track_statistics_by_number.end()))
+      return;
+
+    auto frame_duration = block.m_duration ? static_cast<uint64_t>(*block.m_duration * m_timecode_scale / num_frames) : m_default_durations_by_number[block.m_track_number];
+
+    for (size_t idx = 0; idx < num_frames; ++idx)
+      stats_itr->second.account(block.m_timestamp + idx * frame_duration, frame_duration, block.m_frame_sizes[idx]);
+  });
+}
+
 void
 tag_target_c::account_all_clusters() {
+  mxinfo(Y("The file is read in order to create track statistics.\n"));
+  mxinfo(boost::format(Y("Progress: %1%%%%2%")) % 0 % "\r");
+
+  if (!debugging_c::requested("track_statistics_full_read")) {
+    if (account_all_block_headers()) {
+      mxinfo(boost::format(Y("Progress: %1%%%%2%")) % 100 % "\n");
+      return;
+    }
+
+    // The file structure is damaged. Start over reading complete
+    // clusters as reading them includes re-syncing.
+    for (auto &stats : m_track_statistics_by_number)
+      stats.second.reset();
+  }
+
   auto &file             = m_analyzer->get_file();
   auto kax_file          = std::make_shared<kax_file_c>(file);
   auto file_size         = file.get_size();
@@ -332,9 +382,6 @@ tag_target_c::account_all_clusters() {
 
   file.setFilePointer(m_analyzer->get_segment_data_start_pos());
 
-  mxinfo(Y("The file is read in order to create track statistics.\n"));
-  mxinfo(boost::format(Y("Progress: %1%%%%2%")) % 0 % "\r");
-
   while (true) {
     auto cluster = std::unique_ptr<KaxCluster>{kax_file->read_next_cluster()};
     if (!cluster)
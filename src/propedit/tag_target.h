@@ -77,6 +77,7 @@ protected:
   virtual void account_block_group(KaxBlockGroup &block_group, KaxCluster &cluster);
   virtual void account_simple_block(KaxSimpleBlock &simple_block, KaxCluster &cluster);
   virtual void account_one_cluster(KaxCluster &cluster);
+  virtual bool account_all_block_headers();
   virtual void account_all_clusters();
   virtual void create_track_statistics_tags();
 };
@@ -0,0 +1,16 @@
+#!/usr/bin/ruby -w
+
+# T_613mkvinfo_json_summary
+describe "mkvinfo / JSON output in summary mode"
+
+test "every line is a JSON object, tracks are output as objects" do
+  lines  = sys("../src/mkvinfo --ui-language en_US -J -s data/mkv/complex.mkv").first
+  lines  = lines.map { |line| JSON.load(line) }
+  tracks = lines.select { |json| json["type"] == "track" }
+
+  fail "no track objects" if tracks.empty?
+  fail "incomplete track object" if tracks.any? { |json| %w{number track_type codec_id track_id}.any? { |key| !json.has_key?(key) } }
+  fail "frame with unknown track" if lines.any? { |json| (json["type"] == "frame") && !tracks.any? { |track| track["number"] == json["track"] } }
+
+  :ok
+end
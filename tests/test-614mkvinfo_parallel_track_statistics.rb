@@ -0,0 +1,18 @@
+#!/usr/bin/ruby -w
+
+# T_614mkvinfo_parallel_track_statistics
+describe "mkvinfo / track statistics with clusters analyzed concurrently in several rounds"
+
+test "parallel and sequential analysis yield the same output" do
+  # One block per cluster results in far more ranges of clusters than
+  # two threads handle in one round.
+  merge "--cluster-length 1 data/avi/v.avi"
+
+  parallel   = info("-t --debug mkvinfo_cluster_threads=2 #{tmp}",  :output => :return).first
+  sequential = info("-t --debug mkvinfo_no_parallel_clusters #{tmp}", :output => :return).first
+
+  fail "no track statistics" if !sequential.any? { |line| /Statistics for track number/.match(line) }
+  fail "output differs"      if parallel != sequential
+
+  :ok
+end
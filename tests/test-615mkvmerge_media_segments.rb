@@ -0,0 +1,47 @@
+#!/usr/bin/ruby -w
+
+# T_615mkvmerge_media_segments
+describe "mkvmerge / media segments and their index"
+
+test "segments are contiguous and start with video key frames" do
+  index_file = "#{tmp}.json"
+
+  merge "--media-segment-duration 2s --media-segment-index #{index_file} data/avi/v.avi"
+
+  index = JSON.load(File.read(index_file))
+  File.unlink(index_file)
+
+  frames   = info("-J -s #{tmp}", :output => :return).first.map { |line| JSON.load(line) }
+  video    = frames.detect { |json| (json["type"] == "track") && (json["track_type"] == "video") }["number"]
+  frames   = frames.select { |json| (json["type"] == "frame") && (json["track"] == video) }
+  segments = index["media_segments"]
+
+  fail "too few media segments" if segments.size < 2
+  fail "init segment doesn't end where the first media segment starts" if index["init_segment"]["size"] != segments.first["position"]
+
+  segments.each_cons(2) do |current, following|
+    fail "gap or overlap at #{current["position"]}" if (current["position"] + current["size"]) != following["position"]
+  end
+
+  if index["cues"]
+    fail "cues overlap the last media segment" if (segments.last["position"] + segments.last["size"]) > index["cues"]["position"]
+  end
+
+  segments.each do |segment|
+    first = frames.detect { |json| (json["position"] >= segment["position"]) && (json["position"] < (segment["position"] + segment["size"])) }
+    fail "segment at #{segment["position"]} contains no video frame"        if !first
+    fail "segment at #{segment["position"]} doesn't start with a key frame" if first["frame_type"] != "I"
+  end
+
+  :ok
+end
+
+test "the index requires the segment duration" do
+  merge "--media-segment-index #{tmp}.json data/avi/v.avi", :exit_code => :error
+  :ok
+end
+
+test "segments cannot be combined with splitting" do
+  merge "--media-segment-duration 2s --split 10s data/avi/v.avi", :exit_code => :error
+  :ok
+end
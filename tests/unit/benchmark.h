@@ -0,0 +1,50 @@
+/*
+   mkvmerge -- utility for splicing together matroska files
+   from component media subtypes
+
+   Distributed under the GPL
+   see the file COPYING for details
+   or visit http://www.gnu.org/copyleft/gpl.html
+
+   helper functions for benchmarks in unit tests
+
+   Written by Moritz Bunkus <moritz@bunkus.org>.
+*/
+
+#ifndef MTX_TESTS_UNIT_BENCHMARK_H
+#define MTX_TESTS_UNIT_BENCHMARK_H
+
+#include "common/common_pch.h"
+
+#include <chrono>
+#include <iostream>
+
+// Benchmarks are disabled tests named "DISABLED_Throughput" or similar
+// so that they aren't run by default. Use e.g.
+// "--gtest_also_run_disabled_tests --gtest_filter=BitReader.DISABLED_Throughput"
+// for running one of them.
+
+namespace mtxut {
+
+// Calls 'code' with the loop counter 'num_loops' times and returns the
+// number of seconds one call took on average.
+template<typename T>
+double
+seconds_per_loop(std::size_t num_loops,
+                 T const &code) {
+  auto start = std::chrono::steady_clock::now();
+
+  for (auto loop = std::size_t{}; loop < num_loops; ++loop)
+    code(loop);
+
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / num_loops;
+}
+
+inline void
+show_benchmark_result(boost::format const &result) {
+  std::cout << result.str() << std::endl;
+}
+
+}
+
+#endif // MTX_TESTS_UNIT_BENCHMARK_H
@@ -1,12 +1,88 @@
 #include "common/common_pch.h"
 
+#include <random>
+
 #include "common/bit_reader.h"
 #include "common/endian.h"
 
 #include "gtest/gtest.h"
+#include "tests/unit/benchmark.h"
 
 namespace {
 
+// An H.264 sequence parameter set (High profile, level 4.0,
+// 1920x1080) and the start of an IDR slice referring to it, both
+// without the NAL unit header byte and without emulation prevention
+// bytes.
+unsigned char const s_sps[]          = { 0x64, 0x00, 0x28, 0xac, 0xd9, 0x40, 0x78, 0x02, 0x27, 0xe5, 0xc0, 0x44, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0xc8, 0x3c, 0x60, 0xc6, 0x58 };
+unsigned char const s_slice_header[] = { 0x88, 0x84, 0x00, 0x33, 0xff };
+
+struct sps_fields_t {
+  unsigned int profile_idc, level_idc, chroma_format_idc, log2_max_frame_num, poc_type, log2_max_poc_lsb, num_ref_frames, width, height;
+  bool vui_present;
+};
+
+struct slice_fields_t {
+  unsigned int first_mb, type, pps_id, frame_num, idr_pic_id, poc_lsb;
+  int qp_delta;
+};
+
+// Parses the fields of an SPS up to vui_parameters_present_flag. Only
+// handles what's present in s_sps.
+sps_fields_t
+parse_sps_fields(bit_reader_c &r) {
+  sps_fields_t sps{};
+
+  sps.profile_idc = r.get_bits(8);
+  r.skip_bits(8);               // constraint flags
+  sps.level_idc   = r.get_bits(8);
+  r.get_unsigned_golomb();      // seq_parameter_set_id
+
+  sps.chroma_format_idc = r.get_unsigned_golomb();
+  r.get_unsigned_golomb();      // bit_depth_luma_minus8
+  r.get_unsigned_golomb();      // bit_depth_chroma_minus8
+  r.skip_bits(2);               // qpprime_y_zero_transform_bypass_flag, seq_scaling_matrix_present_flag
+
+  sps.log2_max_frame_num = r.get_unsigned_golomb() + 4;
+  sps.poc_type           = r.get_unsigned_golomb();
+  sps.log2_max_poc_lsb   = r.get_unsigned_golomb() + 4;
+  sps.num_ref_frames     = r.get_unsigned_golomb();
+  r.skip_bit();                 // gaps_in_frame_num_value_allowed_flag
+
+  auto width_in_mbs     = r.get_unsigned_golomb() + 1;
+  auto height_in_mbs    = r.get_unsigned_golomb() + 1;
+  r.skip_bits(2);               // frame_mbs_only_flag, direct_8x8_inference_flag
+
+  unsigned int crop[4] = { 0, 0, 0, 0 };
+  if (r.get_bit())
+    for (auto &value : crop)
+      value = r.get_unsigned_golomb();
+
+  sps.width       = width_in_mbs  * 16 - 2 * (crop[0] + crop[1]);
+  sps.height      = height_in_mbs * 16 - 2 * (crop[2] + crop[3]);
+  sps.vui_present = r.get_bit();
+
+  return sps;
+}
+
+// Parses an I slice header for the SPS above.
+slice_fields_t
+parse_slice_fields(bit_reader_c &r,
+                   sps_fields_t const &sps) {
+  slice_fields_t slice{};
+
+  slice.first_mb   = r.get_unsigned_golomb();
+  slice.type       = r.get_unsigned_golomb();
+  slice.pps_id     = r.get_unsigned_golomb();
+  slice.frame_num  = r.get_bits(sps.log2_max_frame_num);
+  slice.idr_pic_id = r.get_unsigned_golomb();
+  slice.poc_lsb    = r.get_bits(sps.log2_max_poc_lsb);
+  r.skip_bits(2);               // no_output_of_prior_pics_flag, long_term_reference_flag
+  slice.qp_delta   = r.get_signed_golomb();
+
+  return slice;
+}
+
 // 0xf    7    2    3    4    a    8    1
 //   1111 0111 0010 0011 0100 1010 1000 0001
 
@@ -92,6 +168,30 @@ TEST(BitReader, GetUnsignedGolomb) {
   EXPECT_EQ(13, b.get_bit_position());
 }
 
+TEST(BitReader, GetUnsignedGolombTooManyLeadingZeros) {
+  unsigned char value[20];
+  std::memset(value, 0, sizeof(value));
+
+  // 63 leading zeros are still fine: the value is 2^63 - 1 + 0.
+  value[7]  = 0x01;
+  auto b    = bit_reader_c{value, 16};
+
+  EXPECT_EQ(0x7fffffffffffffffull, b.get_unsigned_golomb());
+  EXPECT_EQ(127,                   b.get_bit_position());
+
+  // 64 leading zeros aren't.
+  value[7]  = 0x00;
+  value[8]  = 0x80;
+  b         = bit_reader_c{value, 20};
+
+  EXPECT_THROW(b.get_unsigned_golomb(), mtx::mm_io::end_of_file_x);
+
+  std::memset(value, 0, sizeof(value));
+  b         = bit_reader_c{value, 20};
+
+  EXPECT_THROW(b.get_unsigned_golomb(), mtx::mm_io::end_of_file_x);
+}
+
 TEST(BitReader, GetSignedGolomb) {
   unsigned char value[4];
   put_uint32_be(value, 0xf7234a81);
@@ -304,4 +404,164 @@ TEST(BitReader, ExceptionOnReadingBeyondEOF) {
   EXPECT_THROW(b.get_bytes(target, 2), mtx::mm_io::end_of_file_x);
 }
 
+TEST(BitReader, GetBitsAcrossCacheRefills) {
+  unsigned char value[12];
+  put_uint64_be(&value[0], 0x0123456789abcdefull);
+  put_uint32_be(&value[8], 0xfedcba98);
+  auto b = bit_reader_c{value, 12};
+
+  EXPECT_EQ(0x0,                b.get_bits(4));
+  EXPECT_EQ(0x123456789abcdefull, b.get_bits(60));
+  EXPECT_EQ(64,                 b.get_bit_position());
+  EXPECT_EQ(0xfedcba98,         b.get_bits(32));
+  EXPECT_THROW(b.get_bit(), mtx::mm_io::end_of_file_x);
+  EXPECT_TRUE(b.eof());
+
+  b = bit_reader_c{value, 12};
+  EXPECT_EQ(0x1,                b.get_bits(8));
+  EXPECT_EQ(0x23456789abcdeffeull, b.peek_bits(64));
+  EXPECT_EQ(8,                  b.get_bit_position());
+  EXPECT_EQ(0x23456789abcdeffeull, b.get_bits(64));
+  EXPECT_EQ(72,                 b.get_bit_position());
+  EXPECT_EQ(24,                 b.get_remaining_bits());
+}
+
+TEST(BitReader, GetUnsignedGolombLongCodes) {
+  // 31 zeros, a one and 31 value bits: 2^31 - 1 + 0x40000001
+  unsigned char value[8];
+  put_uint64_be(value, 0x0000000180000002ull);
+  auto b = bit_reader_c{value, 8};
+
+  EXPECT_EQ(0x7fffffffull + 0x40000001ull, b.get_unsigned_golomb());
+  EXPECT_EQ(63, b.get_bit_position());
+
+  // The value bits extend beyond the end of the data.
+  put_uint32_be(value, 0x00000100);
+  b = bit_reader_c{value, 4};
+
+  EXPECT_THROW(b.get_unsigned_golomb(), mtx::mm_io::end_of_file_x);
+  EXPECT_TRUE(b.eof());
+}
+
+TEST(BitReader, MatchesBitByBitReading) {
+  std::mt19937 generator{4711};
+  std::vector<unsigned char> data(257);
+
+  for (auto &byte : data)
+    byte = generator() & 0xff;
+
+  auto reference_bit = [&data](std::size_t pos) -> uint64_t {
+    return (data[pos / 8] >> (7 - (pos % 8))) & 1;
+  };
+
+  auto b   = bit_reader_c{data.data(), data.size()};
+  auto pos = std::size_t{};
+
+  while ((pos + 64) < (data.size() * 8)) {
+    auto operation = generator() % 4;
+
+    if (operation == 0) {
+      auto n = std::size_t{generator() % 65};
+      auto expected = uint64_t{};
+      for (auto idx = 0u; idx < n; ++idx)
+        expected = (expected << 1) | reference_bit(pos + idx);
+
+      EXPECT_EQ(expected, b.peek_bits(n));
+      EXPECT_EQ(expected, b.get_bits(n));
+      pos += n;
+
+    } else if (operation == 1) {
+      auto num_zeros = std::size_t{};
+      while (((pos + num_zeros) < (data.size() * 8)) && !reference_bit(pos + num_zeros))
+        ++num_zeros;
+
+      if ((num_zeros > 24) || ((pos + 2 * num_zeros + 1) > (data.size() * 8))) {
+        b.skip_bits(1);
+        ++pos;
+        continue;
+      }
+
+      auto expected = uint64_t{};
+      for (auto idx = 0u; idx < num_zeros; ++idx)
+        expected = (expected << 1) | reference_bit(pos + num_zeros + 1 + idx);
+      expected += (1ull << num_zeros) - 1;
+
+      EXPECT_EQ(expected, b.get_unsigned_golomb());
+      pos += 2 * num_zeros + 1;
+
+    } else if (operation == 2) {
+      auto n = std::size_t{generator() % 64};
+      b.skip_bits(n);
+      pos += n;
+
+    } else {
+      pos = generator() % (data.size() * 8 - 64);
+      b.set_bit_position(pos);
+    }
+
+    ASSERT_EQ(static_cast<int>(pos), b.get_bit_position());
+    ASSERT_EQ(static_cast<int>(data.size() * 8 - pos), b.get_remaining_bits());
+  }
+}
+
+TEST(BitReader, ParameterSetsAndSliceHeaders) {
+  auto r   = bit_reader_c{s_sps, sizeof(s_sps)};
+  auto sps = parse_sps_fields(r);
+
+  EXPECT_EQ(100u,  sps.profile_idc);
+  EXPECT_EQ(40u,   sps.level_idc);
+  EXPECT_EQ(1u,    sps.chroma_format_idc);
+  EXPECT_EQ(4u,    sps.log2_max_frame_num);
+  EXPECT_EQ(0u,    sps.poc_type);
+  EXPECT_EQ(6u,    sps.log2_max_poc_lsb);
+  EXPECT_EQ(4u,    sps.num_ref_frames);
+  EXPECT_EQ(1920u, sps.width);
+  EXPECT_EQ(1080u, sps.height);
+  EXPECT_TRUE(sps.vui_present);
+
+  r          = bit_reader_c{s_slice_header, sizeof(s_slice_header)};
+  auto slice = parse_slice_fields(r, sps);
+
+  EXPECT_EQ(0u, slice.first_mb);
+  EXPECT_EQ(7u, slice.type);
+  EXPECT_EQ(0u, slice.pps_id);
+  EXPECT_EQ(0u, slice.frame_num);
+  EXPECT_EQ(0u, slice.idr_pic_id);
+  EXPECT_EQ(0u, slice.poc_lsb);
+}
+
+TEST(BitReader, DISABLED_Throughput) {
+  auto checksum = uint64_t{};
+  auto seconds  = mtxut::seconds_per_loop(2000000, [&checksum](std::size_t) {
+    auto r     = bit_reader_c{s_sps, sizeof(s_sps)};
+    auto sps   = parse_sps_fields(r);
+
+    r          = bit_reader_c{s_slice_header, sizeof(s_slice_header)};
+    auto slice = parse_slice_fields(r, sps);
+
+    checksum  += sps.width + slice.type + slice.qp_delta;
+  });
+
+  mtxut::show_benchmark_result(boost::format("SPS + slice header: %1$.1f ns per pair (checksum %2%)") % (seconds * 1e9) % checksum);
+
+  std::vector<unsigned char> data(1024 * 1024);
+  std::mt19937 generator{4711};
+  for (auto &byte : data)
+    byte = generator() & 0xff;
+
+  auto num_codes = uint64_t{};
+  seconds        = mtxut::seconds_per_loop(20, [&](std::size_t) {
+    auto r = bit_reader_c{data.data(), data.size()};
+    try {
+      while (true) {
+        checksum += r.get_unsigned_golomb();
+        ++num_codes;
+      }
+    } catch (mtx::mm_io::end_of_file_x &) {
+    }
+  });
+
+  mtxut::show_benchmark_result(boost::format("Exp-Golomb codes: %1$.1f million per second (checksum %2%)") % (num_codes / (seconds * 20) / 1e6) % checksum);
+}
+
 }
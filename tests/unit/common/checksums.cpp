@@ -3,7 +3,9 @@
 #include "gtest/gtest.h"
 
 #include "common/checksums/base.h"
+#include "common/checksums/crc.h"
 #include "common/mm_io.h"
+#include "tests/unit/benchmark.h"
 #include "tests/unit/util.h"
 
 namespace {
@@ -27,11 +29,14 @@ public:
   uint32_t
   calculate_int(mtx::checksum::algorithm_e algorithm,
                 uint32_t initial_value,
-                size_t chunk_size) {
+                size_t chunk_size,
+                mtx::checksum::crc_base_c::implementation_e implementation = mtx::checksum::crc_base_c::implementation_e::automatic) {
     auto ptr       = m_data->get_buffer();
     auto remaining = m_data->get_size();
     auto worker    = mtx::checksum::for_algorithm(algorithm, initial_value);
 
+    dynamic_cast<mtx::checksum::crc_base_c &>(*worker).set_implementation(implementation);
+
     while (remaining) {
       auto to_handle = std::min<size_t>(remaining, chunk_size);
 
@@ -134,4 +139,52 @@ TEST_F(ChecksumTest, FileChunked1000) {
   EXPECT_EQ(*m_data_md5, *calculate_bin(mtx::checksum::algorithm_e::md5,                       1000));
 }
 
+TEST_F(ChecksumTest, AllCrcImplementations) {
+  using impl_e = mtx::checksum::crc_base_c::implementation_e;
+
+  for (auto implementation : { impl_e::byte_wise, impl_e::slice_by_8, impl_e::slice_by_16, impl_e::pclmulqdq }) {
+    if (!mtx::checksum::crc32_ieee_le_c{}.is_implementation_supported(implementation))
+      continue;
+
+    for (auto chunk_size : std::vector<size_t>{ 1, 15, 16, 17, 37, 64, 65, 1000, m_data->get_size() }) {
+      if (mtx::checksum::crc8_atm_c{}.is_implementation_supported(implementation)) {
+        EXPECT_EQ(0xab,       calculate_int(mtx::checksum::algorithm_e::crc8_atm,               0, chunk_size, implementation));
+        EXPECT_EQ(0x18fe,     calculate_int(mtx::checksum::algorithm_e::crc16_ansi,             0, chunk_size, implementation));
+        EXPECT_EQ(0x218f,     calculate_int(mtx::checksum::algorithm_e::crc16_ccitt,            0, chunk_size, implementation));
+        EXPECT_EQ(0x5a0a3951, calculate_int(mtx::checksum::algorithm_e::crc32_ieee,    0xffffffff, chunk_size, implementation));
+      }
+
+      EXPECT_EQ(0x88c5b46f,   calculate_int(mtx::checksum::algorithm_e::crc32_ieee_le, 0xffffffff, chunk_size, implementation));
+    }
+  }
+}
+
+TEST_F(ChecksumTest, DISABLED_Throughput) {
+  using impl_e = mtx::checksum::crc_base_c::implementation_e;
+
+  auto buffer    = memory_c::alloc(64 * 1024 * 1024);
+  auto num_loops = 4u;
+
+  std::memset(buffer->get_buffer(), 0x5a, buffer->get_size());
+
+  for (auto algorithm : { mtx::checksum::algorithm_e::crc32_ieee, mtx::checksum::algorithm_e::crc32_ieee_le }) {
+    for (auto implementation : { impl_e::byte_wise, impl_e::slice_by_8, impl_e::slice_by_16, impl_e::pclmulqdq }) {
+      auto worker = mtx::checksum::for_algorithm(algorithm, 0xffffffff);
+      auto &crc   = dynamic_cast<mtx::checksum::crc_base_c &>(*worker);
+
+      if (!crc.is_implementation_supported(implementation))
+        continue;
+
+      crc.set_implementation(implementation);
+
+      auto seconds = mtxut::seconds_per_loop(num_loops, [&](std::size_t) { worker->add(*buffer); });
+
+      mtxut::show_benchmark_result(boost::format("%1% %|2$-11s| %3$.2f GB/s")
+                                   % (algorithm == mtx::checksum::algorithm_e::crc32_ieee ? "crc32_ieee   " : "crc32_ieee_le")
+                                   % mtx::checksum::crc_base_c::implementation_name(implementation)
+                                   % (buffer->get_size() / seconds / 1e9));
+    }
+  }
+}
+
 }
@@ -0,0 +1,38 @@
+#include "common/common_pch.h"
+
+#include "common/debugging.h"
+#include "common/parallel.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+TEST(Debugging, OptionRequested) {
+  auto option = debugging_option_c{"unit_test_chunky|unit_test_bacon"};
+
+  EXPECT_FALSE(option);
+
+  debugging_c::request("unit_test_bacon");
+  EXPECT_TRUE(option);
+
+  debugging_c::request("unit_test_bacon", false);
+  EXPECT_FALSE(option);
+}
+
+TEST(Debugging, OptionsRegisteredConcurrently) {
+  debugging_c::request("unit_test_option_7");
+
+  auto results = std::vector<int>(256, -1);
+
+  mtx::parallel::for_each_index(results.size(), [&results](std::size_t idx) {
+    auto option  = debugging_option_c{(boost::format("unit_test_option_%1%") % (idx % 32)).str()};
+    results[idx] = option ? 1 : 0;
+  }, 8);
+
+  for (auto idx = 0u; idx < results.size(); ++idx)
+    EXPECT_EQ((idx % 32) == 7 ? 1 : 0, results[idx]) << "index " << idx;
+
+  debugging_c::request("unit_test_option_7", false);
+}
+
+}
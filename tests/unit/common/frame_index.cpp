@@ -0,0 +1,183 @@
+#include "common/common_pch.h"
+
+#include "common/frame_index.h"
+
+#include "gtest/gtest.h"
+
+#include <random>
+
+namespace {
+
+using entry_t = mtx::frame_index_c::entry_t;
+
+void
+expect_same_entries(std::vector<entry_t> const &expected,
+                    mtx::frame_index_c const &index) {
+  ASSERT_EQ(expected.size(), index.size());
+
+  for (auto idx = 0u; idx < expected.size(); ++idx) {
+    auto actual = index[idx];
+
+    EXPECT_EQ(expected[idx].file_pos,    actual.file_pos)    << "entry " << idx;
+    EXPECT_EQ(expected[idx].size,        actual.size)        << "entry " << idx;
+    EXPECT_EQ(expected[idx].timecode,    actual.timecode)    << "entry " << idx;
+    EXPECT_EQ(expected[idx].duration,    actual.duration)    << "entry " << idx;
+    EXPECT_EQ(expected[idx].is_keyframe, actual.is_keyframe) << "entry " << idx;
+  }
+}
+
+// Video frames in decode order with reordered B frames.
+std::vector<entry_t>
+create_regular_entries(std::size_t num_entries,
+                       int64_t frame_duration = 16683333) {
+  std::vector<entry_t> entries;
+  auto file_pos = int64_t{48};
+
+  for (auto idx = 0u; idx < num_entries; ++idx) {
+    auto size     = 1000 + (idx * 7919) % 50000;
+    auto timecode = static_cast<int64_t>((idx + (idx % 3 == 1 ? 2 : idx % 3 == 2 ? -1 : 0)) * frame_duration);
+
+    entries.emplace_back(file_pos, size, timecode, frame_duration, (idx % 60) == 0);
+    file_pos += size + (idx % 10 ? 0 : 20000);
+  }
+
+  return entries;
+}
+
+// AAC frames in interleaved chunks of 20 frames.
+std::vector<entry_t>
+create_audio_entries(std::size_t num_entries) {
+  std::vector<entry_t> entries;
+  auto file_pos = int64_t{48};
+
+  for (auto idx = 0u; idx < num_entries; ++idx) {
+    auto size = 200 + (idx * 7919) % 400;
+
+    entries.emplace_back(file_pos, size, idx * 21333333ll, 21333333, true);
+    file_pos += size + (idx % 20 ? 0 : 50000);
+  }
+
+  return entries;
+}
+
+TEST(FrameIndex, Empty) {
+  mtx::frame_index_c index;
+
+  EXPECT_TRUE(index.empty());
+  EXPECT_EQ(0u, index.size());
+  EXPECT_TRUE(index.begin() == index.end());
+}
+
+TEST(FrameIndex, RegularEntries) {
+  auto entries = create_regular_entries(1000);
+  mtx::frame_index_c index;
+
+  index.reserve(entries.size());
+  for (auto const &entry : entries)
+    index.push_back(entry);
+  index.shrink_to_fit();
+
+  expect_same_entries(entries, index);
+  EXPECT_GT(11 * entries.size(), index.get_memory_usage());
+
+  auto num_iterated = 0u;
+  for (auto const &entry : index)
+    EXPECT_EQ(entries[num_iterated++].timecode, entry.timecode);
+
+  EXPECT_EQ(entries.size(), num_iterated);
+
+  for (auto frame_duration : std::vector<int64_t>{ 41708333, 40000000 }) {
+    entries = create_regular_entries(1000, frame_duration);
+    index.clear();
+
+    for (auto const &entry : entries)
+      index.push_back(entry);
+    index.shrink_to_fit();
+
+    expect_same_entries(entries, index);
+    EXPECT_GT(11 * entries.size(), index.get_memory_usage()) << "frame duration " << frame_duration;
+  }
+
+  entries = create_audio_entries(1000);
+  index.clear();
+
+  for (auto const &entry : entries)
+    index.push_back(entry);
+  index.shrink_to_fit();
+
+  expect_same_entries(entries, index);
+  EXPECT_GT(6 * entries.size(), index.get_memory_usage());
+}
+
+TEST(FrameIndex, IrregularEntries) {
+  auto entries = create_regular_entries(300);
+
+  entries[10].file_pos  = 5;                  // before the previous frame
+  entries[70].timecode += 3600000000000ll;    // one hour later
+  entries[130].duration = -1;
+  entries[200].size     = 5000000000ll;
+  entries[299].timecode = -3000000000ll;
+  entries[250]          = entry_t{ std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max(), true };
+  entries[251]          = entry_t{ std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min(), false };
+
+  mtx::frame_index_c index;
+  for (auto const &entry : entries)
+    index.push_back(entry);
+
+  expect_same_entries(entries, index);
+
+  // Random access in both directions.
+  for (auto idx : std::vector<std::size_t>{ 299, 0, 251, 250, 128, 127, 128, 70, 71, 10 })
+    EXPECT_EQ(entries[idx].timecode, index[idx].timecode) << "entry " << idx;
+}
+
+TEST(FrameIndex, Modifications) {
+  auto entries = create_regular_entries(200);
+  entries[100].file_pos = 0;
+
+  mtx::frame_index_c index;
+  for (auto &entry : entries) {
+    entry.is_keyframe = false;
+    index.emplace_back(entry.file_pos, entry.size, entry.timecode, entry.duration, false);
+  }
+
+  for (auto idx : std::vector<std::size_t>{ 0, 63, 64, 100, 199 }) {
+    index.mark_as_keyframe(idx);
+    entries[idx].is_keyframe = true;
+  }
+
+  index.adjust_timecodes(-5000000000ll);
+  for (auto &entry : entries)
+    entry.timecode -= 5000000000ll;
+
+  expect_same_entries(entries, index);
+
+  index.erase_front(70);
+  entries.erase(entries.begin(), entries.begin() + 70);
+
+  expect_same_entries(entries, index);
+
+  index.erase_front(500);
+  EXPECT_TRUE(index.empty());
+}
+
+TEST(FrameIndex, SameResultsAsVector) {
+  auto generator = std::mt19937{42};
+  std::vector<entry_t> entries;
+  mtx::frame_index_c index;
+  auto file_pos  = int64_t{};
+  auto timecode  = int64_t{};
+
+  for (auto idx = 0u; idx < 5000; ++idx) {
+    auto large = (generator() % 100) == 0;
+    file_pos  += large ? -static_cast<int64_t>(generator() % 100000) : static_cast<int64_t>(generator() % 100000);
+    timecode  += large ? static_cast<int64_t>(generator()) * 10 : static_cast<int64_t>(generator() % 40000000);
+
+    entries.emplace_back(file_pos, generator() % 100000, timecode, generator() % 40000000, generator() % 2);
+    index.push_back(entries.back());
+  }
+
+  expect_same_entries(entries, index);
+}
+
+}
@@ -0,0 +1,86 @@
+#include "common/common_pch.h"
+
+#include "gtest/gtest.h"
+
+#include "common/json.h"
+#include "tests/unit/benchmark.h"
+
+namespace {
+
+TEST(Json, ObjectWriterEmpty) {
+  EXPECT_EQ(std::string{"{}"}, mtx::json::object_writer_c{}.str());
+}
+
+TEST(Json, ObjectWriterMembers) {
+  auto text = mtx::json::object_writer_c{}
+    .add("string",   std::string{"chunky \"bacon\"\n"})
+    .add("literal",  "I")
+    .add("negative", int64_t{-4711})
+    .add("large",    std::numeric_limits<uint64_t>::max())
+    .add("flag",     true)
+    .add("double",   0.5)
+    .add("null",     nlohmann::json{})
+    .add("array",    nlohmann::json::array({ 1, 2 }))
+    .str();
+
+  auto json = mtx::json::parse(text);
+
+  EXPECT_EQ(std::string{"chunky \"bacon\"\n"},      json["string"].get<std::string>());
+  EXPECT_EQ(std::string{"I"},                       json["literal"].get<std::string>());
+  EXPECT_EQ(-4711,                                  json["negative"].get<int64_t>());
+  EXPECT_EQ(std::numeric_limits<uint64_t>::max(),   json["large"].get<uint64_t>());
+  EXPECT_TRUE(json["flag"].get<bool>());
+  EXPECT_EQ(0.5,                                    json["double"].get<double>());
+  EXPECT_TRUE(json["null"].is_null());
+  EXPECT_EQ(nlohmann::json::array({ 1, 2 }),        json["array"]);
+}
+
+TEST(Json, ObjectWriterMatchesNlohmann) {
+  auto expected = nlohmann::json{
+    { "type",      "frame"    },
+    { "track",     2          },
+    { "timestamp", 123456789  },
+    { "key",       false      },
+  };
+
+  auto text = mtx::json::object_writer_c{}
+    .add("type",      "frame")
+    .add("track",     2)
+    .add("timestamp", 123456789)
+    .add("key",       false)
+    .str();
+
+  EXPECT_EQ(expected, mtx::json::parse(text));
+}
+
+// Compares creating one line of mkvinfo's summary output with
+// boost::format with creating the equivalent JSON object. It stands in
+// for comparing whole "mkvinfo -s" and "mkvinfo -J -s" runs: creating
+// these lines is the only part in which the two output modes differ;
+// reading each frame and calculating its checksum is the same for both.
+TEST(Json, DISABLED_ObjectWriterThroughput) {
+  auto num_loops = 1000000;
+  auto total     = std::size_t{};
+  auto format    = boost::format{"%1% frame, track %2%, timecode %3% (%4%), size %5%, adler 0x%|6$08x|%7%\n"};
+
+  auto text_seconds = mtxut::seconds_per_loop(num_loops, [&](std::size_t loop) {
+    total += (format % 'I' % 1 % (loop * 40) % "00:00:01.234000000" % 12345 % 0xdeadbeef % ", position 123456789").str().size();
+  });
+
+  auto json_seconds = mtxut::seconds_per_loop(num_loops, [&](std::size_t loop) {
+    total += (mtx::json::object_writer_c{}
+              .add("type",       "frame")
+              .add("frame_type", "I")
+              .add("track",      1)
+              .add("timestamp",  static_cast<int64_t>(loop) * 40000000)
+              .add("size",       12345)
+              .add("adler32",    0xdeadbeefu)
+              .add("position",   123456789)
+              .str() + "\n").size();
+  });
+
+  mtxut::show_benchmark_result(boost::format("text (boost::format): %1$.1f ns per line; JSON (object writer): %2$.1f ns per line (total %3%)")
+                               % (text_seconds * 1e9) % (json_seconds * 1e9) % total);
+}
+
+}
@@ -0,0 +1,122 @@
+#include "common/common_pch.h"
+
+#include "common/kax_block_header_scanner.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+using block_t  = kax_block_header_scanner_c::block_t;
+using result_e = kax_block_header_scanner_c::header_result_e;
+
+result_e
+parse(std::vector<unsigned char> const &header,
+      uint64_t block_size,
+      block_t &block) {
+  return kax_block_header_scanner_c::parse_block_header(header.data(), header.size(), block_size, block);
+}
+
+TEST(KaxBlockHeaderScanner, NoLacing) {
+  block_t block;
+
+  ASSERT_EQ(result_e::ok, parse({ 0x81, 0xff, 0xfe, 0x80, 0x00 }, 100, block));
+  EXPECT_EQ(1u, block.m_track_number);
+  EXPECT_EQ(-2, block.m_relative_timestamp);
+  EXPECT_EQ(std::vector<uint64_t>{ 96 }, block.m_frame_sizes);
+
+  ASSERT_EQ(result_e::ok, parse({ 0x40, 0x81, 0x00, 0x10, 0x00 }, 10, block));
+  EXPECT_EQ(129u, block.m_track_number);
+  EXPECT_EQ(16, block.m_relative_timestamp);
+  EXPECT_EQ(std::vector<uint64_t>{ 5 }, block.m_frame_sizes);
+}
+
+TEST(KaxBlockHeaderScanner, XiphLacing) {
+  block_t block;
+
+  ASSERT_EQ(result_e::ok, parse({ 0x82, 0x00, 0x00, 0x02, 0x02, 0xff, 0xff, 0x5a, 0x0a }, 1000, block));
+  EXPECT_EQ(2u, block.m_track_number);
+  EXPECT_EQ((std::vector<uint64_t>{ 600, 10, 1000 - 9 - 610 }), block.m_frame_sizes);
+}
+
+TEST(KaxBlockHeaderScanner, EbmlLacing) {
+  block_t block;
+
+  // 100, then 100 - 2, then the rest
+  ASSERT_EQ(result_e::ok, parse({ 0x81, 0x00, 0x00, 0x06, 0x02, 0xe4, 0xbd }, 255, block));
+  EXPECT_EQ((std::vector<uint64_t>{ 100, 98, 50 }), block.m_frame_sizes);
+
+  // 300 as a two-byte value, then 300 + 200 as a two-byte signed value
+  ASSERT_EQ(result_e::ok, parse({ 0x81, 0x00, 0x00, 0x06, 0x02, 0x41, 0x2c, 0x60, 0xc7 }, 1000, block));
+  EXPECT_EQ((std::vector<uint64_t>{ 300, 500, 1000 - 9 - 800 }), block.m_frame_sizes);
+}
+
+TEST(KaxBlockHeaderScanner, FixedSizeLacing) {
+  block_t block;
+
+  ASSERT_EQ(result_e::ok, parse({ 0x81, 0x00, 0x00, 0x04, 0x03 }, 45, block));
+  EXPECT_EQ((std::vector<uint64_t>{ 10, 10, 10, 10 }), block.m_frame_sizes);
+
+  EXPECT_EQ(result_e::invalid, parse({ 0x81, 0x00, 0x00, 0x04, 0x03 }, 46, block));
+}
+
+TEST(KaxBlockHeaderScanner, IncompleteAndInvalidHeaders) {
+  block_t block;
+
+  EXPECT_EQ(result_e::need_more_data, parse({ 0x82, 0x00, 0x00, 0x02, 0x02, 0xff }, 1000, block));
+  EXPECT_EQ(result_e::need_more_data, parse({ 0x40 },                            1000, block));
+  EXPECT_EQ(result_e::invalid,        parse({ 0x82, 0x00, 0x00, 0x02, 0x02, 0xff }, 6,    block));
+  EXPECT_EQ(result_e::invalid,        parse({ 0x00, 0x00, 0x00, 0x00 },             1000, block));
+  EXPECT_EQ(result_e::invalid,        parse({ 0x81, 0x00, 0x00, 0x02, 0x01, 0x20 }, 20,   block));
+}
+
+TEST(KaxBlockHeaderScanner, Scan) {
+  auto data = std::vector<unsigned char>{
+    // cluster with a known size
+    0x1f, 0x43, 0xb6, 0x75, 0xa2,
+    0xe7, 0x81, 0x0a,                                   // timestamp 10
+    0xa3, 0x88, 0x81, 0x00, 0x05, 0x80, 0xaa, 0xbb, 0xcc, 0xdd,
+    0xa0, 0x93,
+    0xa1, 0x8e, 0x82, 0x00, 0x00, 0x02, 0x01, 0x03, 0x01, 0x02, 0x03, 0x01, 0x02, 0x03, 0x04, 0x05,
+    0x9b, 0x81, 0x14,                                   // block duration 20
+
+    // cluster with an unknown size ended by a cues element
+    0x1f, 0x43, 0xb6, 0x75, 0x01, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xe7, 0x81, 0x14,                                   // timestamp 20
+    0xa3, 0x86, 0x81, 0xff, 0xfe, 0x00, 0x11, 0x22,
+    0x1c, 0x53, 0xbb, 0x6b, 0x80,
+  };
+
+  mm_mem_io_c in{data.data(), data.size()};
+  auto blocks = std::vector<block_t>{};
+
+  ASSERT_TRUE(kax_block_header_scanner_c(in, 1000000).scan(0, 0, [&blocks](block_t const &block) { blocks.push_back(block); }));
+  ASSERT_EQ(3u, blocks.size());
+
+  EXPECT_EQ(1u,                            blocks[0].m_track_number);
+  EXPECT_EQ(15000000,                      blocks[0].m_timestamp);
+  EXPECT_FALSE(!!blocks[0].m_duration);
+  EXPECT_EQ(std::vector<uint64_t>{ 4 },    blocks[0].m_frame_sizes);
+
+  EXPECT_EQ(2u,                            blocks[1].m_track_number);
+  EXPECT_EQ(10000000,                      blocks[1].m_timestamp);
+  ASSERT_TRUE(!!blocks[1].m_duration);
+  EXPECT_EQ(20u,                           *blocks[1].m_duration);
+  EXPECT_EQ((std::vector<uint64_t>{ 3, 5 }), blocks[1].m_frame_sizes);
+
+  EXPECT_EQ(1u,                            blocks[2].m_track_number);
+  EXPECT_EQ(18000000,                      blocks[2].m_timestamp);
+  EXPECT_EQ(std::vector<uint64_t>{ 2 },    blocks[2].m_frame_sizes);
+}
+
+TEST(KaxBlockHeaderScanner, ScanDamaged) {
+  auto data = std::vector<unsigned char>{
+    0x1f, 0x43, 0xb6, 0x75, 0x88,
+    0xa3, 0x88, 0x81, 0x00, 0x05, 0x80, 0xaa, 0xbb,     // block larger than its cluster
+  };
+
+  mm_mem_io_c in{data.data(), data.size()};
+
+  EXPECT_FALSE(kax_block_header_scanner_c(in, 1000000).scan(0, 0, [](block_t const &) {}));
+}
+
+}
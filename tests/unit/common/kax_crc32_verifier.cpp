@@ -0,0 +1,67 @@
+#include "common/common_pch.h"
+
+#include <matroska/KaxTags.h>
+
+#include "common/kax_crc32_verifier.h"
+#include "common/mm_io.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+using namespace libmatroska;
+using result_e = kax_crc32_verifier_c::result_e;
+
+TEST(KaxCrc32Verifier, Verification) {
+  // Tags elements with a CRC-32 element as their first child followed
+  // by "123456789" (CRC-32 0xcbf43926) resp. a corrupted copy of it,
+  // one with an EBML void element only and one with an unknown size.
+  unsigned char const data[] = {
+    0x12, 0x54, 0xc3, 0x67, 0x8f, 0xbf, 0x84, 0x26, 0x39, 0xf4, 0xcb, '1', '2', '3', '4', '5', '6', '7', '8', '9',
+    0x12, 0x54, 0xc3, 0x67, 0x8f, 0xbf, 0x84, 0x26, 0x39, 0xf4, 0xcb, '1', '2', '3', '4', '5', '6', '7', '8', '0',
+    0x12, 0x54, 0xc3, 0x67, 0x83, 0xec, 0x81, 0x00,
+    0x12, 0x54, 0xc3, 0x67, 0xff,
+  };
+
+  auto file_name = (bfs::temp_directory_path() / bfs::unique_path("mtx-unit-tests-%%%%-%%%%-%%%%.mkv")).string();
+
+  {
+    mm_file_io_c out{file_name, MODE_CREATE};
+    out.write(data, sizeof(data));
+  }
+
+  auto elements = std::vector<kax_analyzer_data_cptr>{
+    kax_analyzer_data_c::create(EBML_ID(KaxTags),    0, 20),
+    kax_analyzer_data_c::create(EBML_ID(KaxTags),   20, 20),
+    kax_analyzer_data_c::create(EBML_ID(KaxTags),   40,  8),
+    kax_analyzer_data_c::create(EBML_ID(KaxTags),   48, -1, false),
+    kax_analyzer_data_c::create(EBML_ID(KaxTags), 1000, 20),
+  };
+
+  kax_crc32_verifier_c verifier{file_name, elements};
+  verifier.set_num_threads(2).verify();
+
+  auto const &results = verifier.get_results();
+
+  ASSERT_EQ(5u, results.size());
+
+  EXPECT_TRUE(result_e::ok           == results[0].m_result);
+  EXPECT_EQ(0xcbf43926u,                results[0].m_stored_crc);
+  EXPECT_EQ(0xcbf43926u,                results[0].m_calculated_crc);
+
+  EXPECT_TRUE(result_e::mismatch     == results[1].m_result);
+  EXPECT_EQ(0xcbf43926u,                results[1].m_stored_crc);
+  EXPECT_NE(0xcbf43926u,                results[1].m_calculated_crc);
+
+  EXPECT_TRUE(result_e::no_crc32     == results[2].m_result);
+  EXPECT_TRUE(result_e::size_unknown == results[3].m_result);
+  EXPECT_TRUE(result_e::read_error   == results[4].m_result);
+
+  EXPECT_EQ(1u, verifier.count(result_e::ok));
+  EXPECT_EQ(1u, verifier.count(result_e::mismatch));
+
+  boost::system::error_code ec;
+  bfs::remove(file_name, ec);
+}
+
+}
@@ -0,0 +1,18 @@
+#include "common/common_pch.h"
+
+#include "common/locale.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+TEST(Locale, CharsetConverterAsciiFastPath) {
+  auto converter = charset_converter_c::init("ISO-8859-15");
+
+  EXPECT_EQ(std::string{"Chunky bacon"},        converter->utf8("Chunky bacon"));
+  EXPECT_EQ(std::string{"Chunky bacon"},        converter->native("Chunky bacon"));
+  EXPECT_EQ(std::string{"gr\xc3\xbc\xc3\x9f"}, converter->utf8("gr\xfc\xdf"));
+  EXPECT_EQ(std::string{"gr\xfc\xdf"},         converter->native("gr\xc3\xbc\xc3\x9f"));
+}
+
+}
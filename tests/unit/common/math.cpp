@@ -33,6 +33,15 @@ TEST(Math, IntLog2) {
   EXPECT_EQ(63, mtx::math::int_log2(0x8000001230000000ull));
 }
 
+TEST(Math, CountLeadingZeros) {
+  EXPECT_EQ(63u, mtx::math::count_leading_zeros(1));
+  EXPECT_EQ(62u, mtx::math::count_leading_zeros(2));
+  EXPECT_EQ(62u, mtx::math::count_leading_zeros(3));
+  EXPECT_EQ(32u, mtx::math::count_leading_zeros(0xffffffffull));
+  EXPECT_EQ(31u, mtx::math::count_leading_zeros(0x100000000ull));
+  EXPECT_EQ( 0u, mtx::math::count_leading_zeros(0x8000000000000000ull));
+}
+
 TEST(Math, ToSigned) {
   unsigned char big_endian_signed_numbers[] = {
     0x83,                                           // 0
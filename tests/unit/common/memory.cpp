@@ -30,4 +30,76 @@ TEST(Memory, OperatorNotEq) {
   EXPECT_TRUE(*m1 != "world");
 }
 
+TEST(Memory, GrabCopiesForeignBuffers) {
+  unsigned char buffer[] = { 1, 2, 3, 4 };
+  auto m                 = std::make_shared<memory_c>(buffer, 4, false);
+
+  EXPECT_EQ(4u, m->grab());
+  EXPECT_TRUE(m->is_free());
+  EXPECT_NE(buffer, m->get_buffer());
+  EXPECT_EQ(0u, m->grab());
+
+  buffer[0] = 42;
+  EXPECT_EQ(1, m->get_buffer()[0]);
+}
+
+TEST(Memory, SlicesKeepTheirParentAlive) {
+  auto parent = memory_c::clone("chunky bacon");
+  auto slice  = memory_c::slice(parent, 7, 5);
+
+  EXPECT_EQ(2, parent.use_count());
+  EXPECT_TRUE(*slice == "bacon");
+  EXPECT_EQ(parent->get_buffer() + 7, slice->get_buffer());
+
+  EXPECT_EQ(0u, slice->grab());
+  EXPECT_EQ(parent->get_buffer() + 7, slice->get_buffer());
+
+  auto weak_parent = std::weak_ptr<memory_c>{parent};
+  parent.reset();
+
+  EXPECT_FALSE(weak_parent.expired());
+  EXPECT_TRUE(*slice == "bacon");
+
+  slice.reset();
+  EXPECT_TRUE(weak_parent.expired());
+}
+
+TEST(Memory, ResizedSlicesReleaseTheirParent) {
+  auto parent = memory_c::clone("chunky bacon");
+  auto slice  = memory_c::slice(parent, 0, 6);
+
+  slice->add(reinterpret_cast<unsigned char const *>("!"), 1);
+
+  EXPECT_TRUE(*slice == "chunky!");
+  EXPECT_TRUE(slice->is_free());
+  EXPECT_EQ(1, parent.use_count());
+}
+
+TEST(Memory, SmallClonesAreOwned) {
+  auto m = memory_c::clone("hello");
+
+  EXPECT_TRUE(*m == "hello");
+  EXPECT_EQ(0u, m->grab());
+
+  m->add(reinterpret_cast<unsigned char const *>(" world"), 6);
+  EXPECT_TRUE(*m == "hello world");
+  EXPECT_TRUE(m->is_free());
+
+  auto large = memory_c::clone(std::string(1000, 'x'));
+  EXPECT_EQ(1000u, large->get_size());
+  EXPECT_TRUE(large->is_free());
+  EXPECT_EQ(0u, large->grab());
+}
+
+TEST(Memory, LockingSmallClonesHandsOverTheirBuffer) {
+  auto m = memory_c::clone("hello");
+  m->lock();
+
+  auto buffer = m->get_buffer();
+  m.reset();
+
+  EXPECT_EQ(0, std::memcmp(buffer, "hello", 5));
+  free(buffer);
+}
+
 }
@@ -4,6 +4,9 @@
 #include "tests/unit/util.h"
 
 #include "common/mm_io_x.h"
+#include "common/mm_read_buffer_io.h"
+#include "common/mm_reopenable_io.h"
+#include "common/mm_write_buffer_io.h"
 
 namespace {
 
@@ -16,4 +19,209 @@ TEST(MmIo, Slurp) {
   ASSERT_THROW(mm_file_io_c::slurp("doesnotexist"), mtx::mm_io::exception);
 }
 
+TEST(MmIo, DropFromPageCache) {
+  auto file_name = (bfs::temp_directory_path() / bfs::unique_path("mtx-unit-tests-%%%%-%%%%-%%%%.bin")).string();
+  auto chunk     = std::string(3 * 1024 * 1024 + 17, 'x');
+
+  mm_file_io_c::set_drop_from_page_cache(true, true);
+
+  {
+    mm_file_io_c out{file_name, MODE_CREATE};
+
+    for (auto idx = 0; idx < 8; ++idx) {
+      std::fill(chunk.begin(), chunk.end(), 'a' + idx);
+      out.write(chunk);
+    }
+
+    // Rewriting the start like when updating the headers
+    out.setFilePointer(0);
+    out.write(std::string{"header"});
+  }
+
+  {
+    mm_file_io_c in{file_name, MODE_READ};
+    auto buffer = std::string(chunk.size(), '\0');
+
+    EXPECT_EQ(static_cast<int64_t>(8 * chunk.size()), in.get_size());
+
+    for (auto idx = 0; idx < 8; ++idx) {
+      auto expected_start = idx ? std::string(6, 'a' + idx) : std::string{"header"};
+
+      ASSERT_EQ(chunk.size(), in.read(&buffer[0], buffer.size()));
+      EXPECT_EQ(expected_start,                             buffer.substr(0, 6));
+      EXPECT_EQ(std::string(chunk.size() - 6, 'a' + idx), buffer.substr(6));
+    }
+  }
+
+  mm_file_io_c::set_drop_from_page_cache(false, false);
+  bfs::remove(file_name);
+}
+
+std::vector<std::string>
+read_lines(std::string const &content) {
+  mm_text_io_c in{new mm_mem_io_c{reinterpret_cast<unsigned char const *>(content.data()), content.size()}};
+  auto lines = std::vector<std::string>{};
+
+  while (!in.eof())
+    lines.push_back(in.getline());
+
+  return lines;
+}
+
+TEST(MmTextIo, LineEndings) {
+  EXPECT_EQ((std::vector<std::string>{ "one", "two", "three" }),     read_lines("one\ntwo\nthree"));
+  EXPECT_EQ((std::vector<std::string>{ "one", "two", "" }),          read_lines("one\r\ntwo\r\n\r\n"));
+  EXPECT_EQ((std::vector<std::string>{ "one", "", "two" }),          read_lines("one\r\rtwo\r"));
+  EXPECT_EQ((std::vector<std::string>{ "one", "two", "three" }),     read_lines("one\ntwo\rthree\n"));
+  EXPECT_EQ((std::vector<std::string>{ "one", "two" }),              read_lines("one\r\r\ntwo\r\n"));
+}
+
+TEST(MmTextIo, Utf8) {
+  EXPECT_EQ((std::vector<std::string>{ "gr\xc3\xbc\xc3\x9f", "\xe2\x82\xac" }), read_lines("\xef\xbb\xbfgr\xc3\xbc\xc3\x9f\n\xe2\x82\xac\n"));
+  EXPECT_EQ((std::vector<std::string>{ "gr\xfc\xdf" }),                         read_lines("gr\xfc\xdf\n"));
+  EXPECT_EQ((std::vector<std::string>{ "bad" }),                                read_lines("\xef\xbb\xbf" "bad\xe2\x82"));
+
+  EXPECT_THROW(read_lines("\xef\xbb\xbf" "bad\x80\n"), mtx::mm_io::text::invalid_utf8_char_x);
+
+  auto utf16 = std::string{"\xff\xfeg\x00r\x00\xfc\x00\n\x00x\x00", 12};
+  EXPECT_EQ((std::vector<std::string>{ "gr\xc3\xbc", "x" }), read_lines(utf16));
+}
+
+TEST(MmTextIo, LongLines) {
+  // Lines longer than the blocks the reader uses internally including
+  // UTF-8 characters crossing the blocks' boundaries.
+  auto long_line = std::string{};
+  for (auto idx = 0; idx < 50000; ++idx)
+    long_line += (idx % 3) ? "\xe2\x82\xac" : "a";
+
+  EXPECT_EQ((std::vector<std::string>{ long_line, "short", long_line }), read_lines("\xef\xbb\xbf" + long_line + "\r\nshort\r\n" + long_line));
+}
+
+TEST(MmTextIo, PositionAfterLine) {
+  auto content = std::string{"one\r\ntwo\nthree"};
+  mm_text_io_c in{new mm_mem_io_c{reinterpret_cast<unsigned char const *>(content.data()), content.size()}};
+
+  EXPECT_EQ(std::string{"one"}, in.getline());
+  EXPECT_EQ(5u,                 in.getFilePointer());
+  EXPECT_EQ(std::string{"tw"},  in.getline(2));
+  EXPECT_EQ(7u,                 in.getFilePointer());
+  EXPECT_EQ(std::string{"o"},   in.getline());
+  EXPECT_EQ(9u,                 in.getFilePointer());
+}
+
+TEST(MmReopenableIo, ReadingContinuesAfterSuspending) {
+  auto content   = std::string{};
+  auto num_opens = 0;
+
+  for (auto idx = 0; idx < 1000; ++idx)
+    content += (boost::format("%1%,") % idx).str();
+
+  auto opener = [&content, &num_opens]() -> mm_io_c * {
+    ++num_opens;
+    return new mm_mem_io_c{reinterpret_cast<unsigned char const *>(content.data()), content.size()};
+  };
+
+  auto reopenable = new mm_reopenable_io_c{opener};
+  mm_read_buffer_io_c in{reopenable, 1024};
+  auto buffer = std::string(1500, '\0');
+
+  EXPECT_EQ(1, num_opens);
+  EXPECT_EQ(static_cast<int64_t>(content.size()), in.get_size());
+
+  ASSERT_EQ(100u, in.read(&buffer[0], 100));
+  EXPECT_EQ(content.substr(0, 100), buffer.substr(0, 100));
+
+  in.suspend();
+  EXPECT_TRUE(reopenable->is_suspended());
+  EXPECT_EQ(100u, in.getFilePointer());
+  EXPECT_EQ(static_cast<int64_t>(content.size()), in.get_size());
+
+  ASSERT_EQ(1500u, in.read(&buffer[0], 1500));
+  EXPECT_EQ(content.substr(100, 1500), buffer);
+  EXPECT_FALSE(reopenable->is_suspended());
+  EXPECT_EQ(2, num_opens);
+
+  // Seeking while suspended doesn't reopen the file.
+  in.suspend();
+  in.setFilePointer(-10, seek_end);
+  EXPECT_EQ(content.size() - 10, in.getFilePointer());
+  EXPECT_EQ(2, num_opens);
+
+  ASSERT_EQ(10u, in.read(&buffer[0], 20));
+  EXPECT_EQ(content.substr(content.size() - 10), buffer.substr(0, 10));
+  EXPECT_TRUE(in.eof());
+  EXPECT_EQ(3, num_opens);
+  EXPECT_EQ(2u, reopenable->get_num_reopens());
+}
+
+TEST(MmReopenableIo, ClosedFilesCannotBeReopened) {
+  auto content = std::string{"Chunky Bacon"};
+  mm_reopenable_io_c in{[&content]() { return new mm_mem_io_c{reinterpret_cast<unsigned char const *>(content.data()), content.size()}; }};
+  auto buffer  = std::string(6, '\0');
+
+  in.suspend();
+  in.close();
+
+  EXPECT_THROW(in.read(&buffer[0], buffer.size()), mtx::mm_io::open_x);
+  EXPECT_THROW(in.write(buffer), mtx::mm_io::wrong_read_write_access_x);
+}
+
+class recording_mem_io_c: public mm_mem_io_c {
+public:
+  std::vector<std::size_t> m_write_sizes;
+
+  recording_mem_io_c()
+    : mm_mem_io_c{nullptr, 0, 1024}
+  {
+  }
+
+protected:
+  virtual size_t _write(const void *buffer, size_t size) {
+    m_write_sizes.push_back(size);
+    return mm_mem_io_c::_write(buffer, size);
+  }
+};
+
+TEST(MmWriteBufferIo, LargeChunksWrittenDirectly) {
+  recording_mem_io_c recorder;
+  auto small    = std::string(100, 's');
+  auto large    = std::string(300 * 1024, 'L');
+  auto expected = std::string{};
+
+  {
+    mm_write_buffer_io_c out{&recorder, 1024 * 1024, false};
+
+    for (auto idx = 0; idx < 3; ++idx) {
+      out.write(small);
+      out.write(small);
+      out.write(large);
+      expected += small + small + large;
+    }
+
+    out.write(small);
+    expected += small;
+
+    EXPECT_EQ(expected.size(), out.getFilePointer());
+    out.flush();
+  }
+
+  EXPECT_EQ((std::vector<std::size_t>{ 200, large.size(), 200, large.size(), 200, large.size(), 100 }), recorder.m_write_sizes);
+  EXPECT_EQ(expected, recorder.get_content());
+}
+
+TEST(MmWriteBufferIo, SmallChunksCoalesced) {
+  recording_mem_io_c recorder;
+  auto chunk = std::string(1000, 'x');
+
+  {
+    mm_write_buffer_io_c out{&recorder, 4096, false};
+
+    for (auto idx = 0; idx < 10; ++idx)
+      out.write(chunk);
+  }
+
+  EXPECT_EQ((std::vector<std::size_t>{ 4096, 4096, 1808 }), recorder.m_write_sizes);
+  EXPECT_EQ(10000u, recorder.get_content().size());
+}
+
 }
@@ -0,0 +1,42 @@
+#include "common/common_pch.h"
+
+#include <atomic>
+#include <stdexcept>
+
+#include "common/parallel.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+TEST(Parallel, DefaultNumThreads) {
+  EXPECT_GE(mtx::parallel::default_num_threads(), 1u);
+}
+
+TEST(Parallel, ForEachIndexVisitsEachIndexOnce) {
+  for (auto num_threads : std::vector<unsigned int>{ 0, 1, 2, 7 }) {
+    std::vector<std::atomic<int>> visits(1000);
+
+    mtx::parallel::for_each_index(visits.size(), [&visits](std::size_t idx) { ++visits[idx]; }, num_threads);
+
+    for (auto const &num_visits : visits)
+      EXPECT_EQ(1, num_visits);
+  }
+}
+
+TEST(Parallel, ForEachIndexWithoutItems) {
+  auto called = false;
+
+  mtx::parallel::for_each_index(0, [&called](std::size_t) { called = true; }, 4);
+
+  EXPECT_FALSE(called);
+}
+
+TEST(Parallel, ForEachIndexRethrowsExceptions) {
+  EXPECT_THROW(mtx::parallel::for_each_index(100, [](std::size_t idx) {
+    if (idx == 10)
+      throw std::runtime_error{"failure"};
+  }, 4), std::runtime_error);
+}
+
+}
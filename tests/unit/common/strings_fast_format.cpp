@@ -0,0 +1,94 @@
+#include "common/common_pch.h"
+
+#include "common/strings/fast_format.h"
+
+#include "gtest/gtest.h"
+#include "tests/unit/benchmark.h"
+
+namespace {
+
+template<typename... Args>
+void
+expect_same_as_boost(std::string const &format,
+                     Args const &... args) {
+  auto expected = boost::format{format};
+  auto actual   = fast_format_c{format};
+
+  using expand_t = int[];
+  (void)expand_t{ 0, ((expected % args), 0)... };
+  (void)expand_t{ 0, ((actual   % args), 0)... };
+
+  EXPECT_EQ(expected.str(), actual.str()) << "format: " << format;
+}
+
+TEST(StringsFastFormat, PlainDirectives) {
+  expect_same_as_boost("no arguments at all, 100%% sure");
+  expect_same_as_boost("%1% and %2%", "chunky", std::string{"bacon"});
+  expect_same_as_boost("%2% before %1%, %1% again", 1, 2);
+  expect_same_as_boost("%1%%2%%3%%4%", -42, 42u, -(int64_t{1} << 40), std::numeric_limits<uint64_t>::max());
+  expect_same_as_boost("%1% %2% %3%", 'x', true, static_cast<unsigned char>('y'));
+  expect_same_as_boost("%1% %2% %3% %4% %5%", 0.5, 1.0 / 3.0, 1234567.0, 1e-10, -2.5f);
+}
+
+TEST(StringsFastFormat, Modifiers) {
+  expect_same_as_boost("Debug> %1%:%|2$04d|: %3%", "file.cpp", 42, "message");
+  expect_same_as_boost("%|1$08x| %|2$02X| %|3$x|", 0xdeadbeefu, 10, -1);
+  expect_same_as_boost("%|1$04d| %|2$5d| %|3$-5d|| %|4$-05d||", -5, 17, 17, -17);
+  expect_same_as_boost("%|1$.3f| %|2$.0f| %|3$08.2f| %|4$f|", 3.14159, 2.5, -1.5, 100.0);
+  expect_same_as_boost("%|1$10s|%|2$-10s||", "right", "left");
+  expect_same_as_boost("%|1$.2f| of %|2$d|", 7, 3u);
+}
+
+TEST(StringsFastFormat, FallbackToBoost) {
+  auto format = fast_format_c{"%|1$+d| and %1%"};
+
+  EXPECT_TRUE(format.uses_fallback());
+  EXPECT_EQ(std::string{"+2 and 2"}, (format % 2).str());
+
+  expect_same_as_boost("%|1$.3s|", "truncated");
+  expect_same_as_boost("%1$d %2$s", 1, "printf style");
+}
+
+TEST(StringsFastFormat, ArgumentHandling) {
+  auto format = fast_format_c{"%1% + %2%"};
+
+  EXPECT_EQ(2u, format.expected_args());
+  EXPECT_EQ(std::string{"1 + 2"}, (format % 1 % 2).str());
+
+  // Starts over after all arguments have been fed.
+  EXPECT_EQ(std::string{"3 + 4"}, (format % 3 % 4).str());
+
+  format % 5;
+  EXPECT_THROW(format.str(),  boost::io::too_few_args);
+
+  auto no_arguments = fast_format_c{"none"};
+  EXPECT_THROW(no_arguments % 1, boost::io::too_many_args);
+}
+
+// Compares the per-element formats used by mkvinfo in verbose mode.
+TEST(StringsFastFormat, DISABLED_Throughput) {
+  auto num_loops = 1000000;
+  auto total     = std::size_t{};
+  auto text      = std::string{"%1%%2% (%3%)%4%%5%"};
+  auto position  = std::string{" at %1%"};
+  auto size      = std::string{" size %1%"};
+
+  auto boost_seconds = mtxut::seconds_per_loop(num_loops, [&](std::size_t loop) {
+    total += (boost::format(text) % "|+ " % "SimpleBlock" % "track number 1, 1 frame(s), timecode 1.234s = 00:00:01.234000000"
+              % (boost::format(position) % (loop * 1234)).str() % (boost::format(size) % 12345).str()).str().size();
+  });
+
+  auto fast_text     = fast_format_c{text};
+  auto fast_position = fast_format_c{position};
+  auto fast_size     = fast_format_c{size};
+
+  auto fast_seconds  = mtxut::seconds_per_loop(num_loops, [&](std::size_t loop) {
+    total += (fast_text % "|+ " % "SimpleBlock" % "track number 1, 1 frame(s), timecode 1.234s = 00:00:01.234000000"
+              % (fast_position % (loop * 1234)).str() % (fast_size % 12345).str()).str().size();
+  });
+
+  mtxut::show_benchmark_result(boost::format("boost::format: %1$.1f ns per element; fast_format_c: %2$.1f ns per element (total %3%)")
+                               % (boost_seconds * 1e9) % (fast_seconds * 1e9) % total);
+}
+
+}
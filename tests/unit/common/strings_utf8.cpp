@@ -0,0 +1,28 @@
+#include "common/common_pch.h"
+
+#include "common/strings/utf8.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+TEST(StringsUtf8, IsAscii) {
+  EXPECT_TRUE(is_ascii(""));
+  EXPECT_TRUE(is_ascii("Chunky bacon"));
+  EXPECT_TRUE(is_ascii(std::string{"\x00\x01\x7f", 3}));
+  EXPECT_FALSE(is_ascii("gr\xc3\xbc\xc3\x9f"));
+  EXPECT_FALSE(is_ascii("\x80"));
+
+  // Non-ASCII characters at every position of strings long enough for
+  // the vectorized code paths
+  auto ascii = std::string(200, 'x');
+  EXPECT_TRUE(is_ascii(ascii));
+
+  for (auto idx = 0u; idx < ascii.size(); ++idx) {
+    auto copy = ascii;
+    copy[idx] = '\xff';
+    EXPECT_FALSE(is_ascii(copy)) << "position " << idx;
+  }
+}
+
+}
@@ -0,0 +1,131 @@
+#include "common/common_pch.h"
+
+#include "common/sync_word_searcher.h"
+
+#include "gtest/gtest.h"
+
+#include <random>
+
+namespace {
+
+std::size_t
+find_bytewise(std::vector<mtx::sync_word_searcher_c::sync_word_t> const &sync_words,
+              std::vector<unsigned char> const &buffer,
+              std::size_t start,
+              std::size_t end) {
+  for (auto pos = start; pos < std::min(end, buffer.size()); ++pos)
+    for (auto const &sync_word : sync_words) {
+      if ((pos + sync_word.m_size) > buffer.size())
+        continue;
+
+      auto value = uint32_t{};
+      for (auto idx = 0u; idx < sync_word.m_size; ++idx)
+        value = (value << 8) | buffer[pos + idx];
+
+      if ((value & sync_word.m_mask) == sync_word.m_value)
+        return pos;
+    }
+
+  return std::string::npos;
+}
+
+TEST(SyncWordSearcher, SingleSyncWord) {
+  auto searcher = mtx::sync_word_searcher_c{ { 0x0b77, 0xffff, 2 } };
+  auto buffer   = std::vector<unsigned char>(100, 0x0b);
+
+  EXPECT_EQ(std::string::npos, searcher.find(buffer.data(), buffer.size()));
+
+  buffer[40] = 0x77;
+  buffer[70] = 0x77;
+
+  EXPECT_EQ(39u,               searcher.find(buffer.data(), buffer.size()));
+  EXPECT_EQ(39u,               searcher.find(buffer.data(), buffer.size(), 39));
+  EXPECT_EQ(69u,               searcher.find(buffer.data(), buffer.size(), 40));
+  EXPECT_EQ(std::string::npos, searcher.find(buffer.data(), buffer.size(), 40, 69));
+  EXPECT_EQ(std::string::npos, searcher.find(buffer.data(), buffer.size(), 70));
+}
+
+TEST(SyncWordSearcher, SyncWordsMustFitIntoBuffer) {
+  auto searcher = mtx::sync_word_searcher_c{ { 0x7ffe8001, 0xffffffff, 4 } };
+  unsigned char buffer[] = { 0x00, 0x7f, 0xfe, 0x80, 0x01, 0x7f, 0xfe, 0x80 };
+
+  EXPECT_EQ(1u,                searcher.find(buffer, sizeof(buffer)));
+  EXPECT_EQ(std::string::npos, searcher.find(buffer, sizeof(buffer), 2));
+  EXPECT_EQ(std::string::npos, searcher.find(buffer, 4));
+  EXPECT_TRUE(searcher.matches_at(buffer, sizeof(buffer), 1));
+  EXPECT_FALSE(searcher.matches_at(buffer, sizeof(buffer), 5));
+}
+
+TEST(SyncWordSearcher, MaskedSyncWords) {
+  // ADTS and LOAS headers as used by the AAC parser.
+  auto searcher = mtx::sync_word_searcher_c{
+    { 0xfff000, 0xfff000, 3 },
+    { 0x56e000, 0xffe000, 3 },
+  };
+  unsigned char buffer[] = { 0x00, 0xff, 0xe0, 0x00, 0x56, 0xff, 0x00, 0xff, 0xf1, 0x50 };
+
+  EXPECT_EQ(4u, searcher.find(buffer, sizeof(buffer)));
+  EXPECT_EQ(7u, searcher.find(buffer, sizeof(buffer), 5));
+}
+
+TEST(SyncWordSearcher, SameResultsAsBytewiseSearch) {
+  auto sync_words = std::vector<mtx::sync_word_searcher_c::sync_word_t>{
+    { 0x0b77,     0xffff,     2 },
+    { 0x56e000,   0xffe000,   3 },
+    { 0xf8726fba, 0xfffffffe, 4 },
+  };
+  auto searcher   = mtx::sync_word_searcher_c{ sync_words[0], sync_words[1], sync_words[2] };
+  auto generator  = std::mt19937{42};
+  auto values     = std::vector<unsigned char>{ 0x0b, 0x77, 0x56, 0xe0, 0xf8, 0x72, 0x6f, 0xba, 0xbb, 0x00, 0xff };
+
+  for (auto loop = 0; loop < 2000; ++loop) {
+    auto buffer = std::vector<unsigned char>(generator() % 80);
+    for (auto &byte : buffer)
+      byte = values[generator() % values.size()];
+
+    auto start = buffer.empty() ? 0 : generator() % buffer.size();
+    auto end   = start + generator() % (buffer.size() + 1);
+
+    for (auto pos = start; ; ++pos) {
+      auto expected = find_bytewise(sync_words, buffer, pos, end);
+      ASSERT_EQ(expected, searcher.find(buffer.data(), buffer.size(), pos, end)) << "loop " << loop << " start " << pos << " end " << end;
+
+      if (std::string::npos == expected)
+        break;
+      pos = expected;
+    }
+  }
+}
+
+TEST(SyncWordSearcher, MatroskaLevel1Ids) {
+  auto sync_words = std::vector<mtx::sync_word_searcher_c::sync_word_t>{
+    { 0x114d9b74, 0xffffffff, 4 },
+    { 0x1549a966, 0xffffffff, 4 },
+    { 0x1654ae6b, 0xffffffff, 4 },
+    { 0x1f43b675, 0xffffffff, 4 },
+    { 0x1c53bb6b, 0xffffffff, 4 },
+    { 0x1941a469, 0xffffffff, 4 },
+    { 0x1043a770, 0xffffffff, 4 },
+    { 0x1254c367, 0xffffffff, 4 },
+  };
+  auto searcher   = mtx::sync_word_searcher_c{ sync_words };
+  auto generator  = std::mt19937{42};
+  auto values     = std::vector<unsigned char>{ 0x1f, 0x43, 0xb6, 0x75, 0x12, 0x54, 0xc3, 0x67, 0x10, 0xa7, 0x70, 0x00 };
+
+  for (auto loop = 0; loop < 2000; ++loop) {
+    auto buffer = std::vector<unsigned char>(generator() % 80);
+    for (auto &byte : buffer)
+      byte = values[generator() % values.size()];
+
+    for (auto pos = std::size_t{}; ; ++pos) {
+      auto expected = find_bytewise(sync_words, buffer, pos, buffer.size());
+      ASSERT_EQ(expected, searcher.find(buffer.data(), buffer.size(), pos)) << "loop " << loop << " start " << pos;
+
+      if (std::string::npos == expected)
+        break;
+      pos = expected;
+    }
+  }
+}
+
+}
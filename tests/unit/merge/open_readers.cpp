@@ -0,0 +1,104 @@
+#include "common/common_pch.h"
+
+#include "common/mm_io.h"
+#include "merge/generic_reader.h"
+#include "merge/open_readers.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+unsigned char s_content[] = "Chunky Bacon";
+
+class suspend_counting_io_c: public mm_mem_io_c {
+public:
+  unsigned int m_num_suspended{};
+
+  suspend_counting_io_c()
+    : mm_mem_io_c{s_content, sizeof(s_content)}
+  {
+  }
+
+  virtual void suspend() {
+    ++m_num_suspended;
+  }
+};
+
+class fake_reader_c: public generic_reader_c {
+public:
+  suspend_counting_io_c &m_counting_in;
+
+  fake_reader_c(std::shared_ptr<suspend_counting_io_c> const &in)
+    : generic_reader_c{track_info_c{}, in}
+    , m_counting_in{*in}
+  {
+  }
+
+  virtual file_type_e get_format_type() const {
+    return FILE_TYPE_IS_UNKNOWN;
+  }
+
+  virtual void read_headers() {
+  }
+
+  virtual file_status_e read(generic_packetizer_c *, bool) {
+    return FILE_STATUS_DONE;
+  }
+
+  virtual void identify() {
+  }
+
+  virtual void create_packetizer(int64_t) {
+  }
+
+  unsigned int get_num_suspended() const {
+    return m_counting_in.m_num_suspended;
+  }
+};
+
+std::vector<std::unique_ptr<fake_reader_c>>
+create_readers(std::size_t num) {
+  std::vector<std::unique_ptr<fake_reader_c>> readers;
+
+  for (auto idx = 0u; idx < num; ++idx)
+    readers.emplace_back(new fake_reader_c{std::make_shared<suspend_counting_io_c>()});
+
+  return readers;
+}
+
+TEST(OpenReaders, LeastRecentlyUsedReadersAreSuspended) {
+  auto readers     = create_readers(4);
+  auto &open       = open_readers_c::get();
+  auto saved_limit = open.get_limit();
+
+  open.set_limit(2);
+
+  open.mark_as_used(*readers[0]);
+  open.mark_as_used(*readers[1]);
+  open.mark_as_used(*readers[0]);
+  EXPECT_EQ(2u, open.get_num_open());
+
+  open.mark_as_used(*readers[2]);
+  EXPECT_EQ(2u, open.get_num_open());
+  EXPECT_EQ(0u, readers[0]->get_num_suspended());
+  EXPECT_EQ(1u, readers[1]->get_num_suspended());
+
+  open.mark_as_used(*readers[3]);
+  EXPECT_EQ(1u, readers[0]->get_num_suspended());
+  EXPECT_EQ(0u, readers[2]->get_num_suspended());
+
+  // Suspending a reader directly makes room for another one.
+  readers[2]->suspend_input();
+  EXPECT_EQ(1u, open.get_num_open());
+
+  open.mark_as_used(*readers[1]);
+  EXPECT_EQ(2u, open.get_num_open());
+  EXPECT_EQ(0u, readers[3]->get_num_suspended());
+
+  readers.clear();
+  EXPECT_EQ(0u, open.get_num_open());
+
+  open.set_limit(saved_limit);
+}
+
+}
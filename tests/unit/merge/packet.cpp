@@ -0,0 +1,127 @@
+#include "common/common_pch.h"
+
+#include "common/mm_io.h"
+#include "merge/generic_packetizer.h"
+#include "merge/generic_reader.h"
+#include "merge/packet.h"
+
+#include "gtest/gtest.h"
+#include "tests/unit/benchmark.h"
+
+namespace {
+
+class fake_reader_c: public generic_reader_c {
+public:
+  fake_reader_c()
+    : generic_reader_c{track_info_c{}, std::make_shared<mm_mem_io_c>(nullptr, 0, 1024)}
+  {
+  }
+
+  virtual file_type_e get_format_type() const {
+    return FILE_TYPE_IS_UNKNOWN;
+  }
+
+  virtual void read_headers() {
+  }
+
+  virtual file_status_e read(generic_packetizer_c *, bool) {
+    return FILE_STATUS_DONE;
+  }
+
+  virtual void identify() {
+  }
+
+  virtual void create_packetizer(int64_t) {
+  }
+};
+
+class fake_packetizer_c: public generic_packetizer_c {
+public:
+  fake_packetizer_c(generic_reader_c *reader,
+                    track_info_c &ti)
+    : generic_packetizer_c{reader, ti}
+  {
+  }
+
+  virtual int process(packet_cptr packet) {
+    add_packet(packet);
+
+    return FILE_STATUS_MOREDATA;
+  }
+
+  virtual void set_headers() {
+  }
+
+  virtual translatable_string_c get_format_name() const {
+    return YT("fake");
+  }
+
+  virtual connection_result_e can_connect_to(generic_packetizer_c *, std::string &) {
+    return CAN_CONNECT_NO_FORMAT;
+  }
+};
+
+TEST(Packet, Defaults) {
+  auto packet = packet_t::create();
+
+  EXPECT_FALSE(packet->data);
+  EXPECT_EQ(1, packet->time_factor);
+  EXPECT_FALSE(packet->has_duration());
+  EXPECT_FALSE(packet->has_discard_padding());
+  EXPECT_TRUE(packet->data_adds.empty());
+  EXPECT_TRUE(packet->extensions.empty());
+
+  packet = packet_t::create(memory_c::clone("chunky bacon"), 1000, 20, 500);
+
+  EXPECT_TRUE(*packet->data == "chunky bacon");
+  EXPECT_EQ(1000, packet->timecode);
+  EXPECT_EQ(20,   packet->duration);
+  EXPECT_TRUE(packet->is_p_frame());
+}
+
+TEST(Packet, ReferenceCounting) {
+  auto packet = packet_t::create(memory_c::clone("chunky bacon"));
+  auto data   = std::weak_ptr<memory_c>{packet->data};
+  auto copy   = packet;
+
+  EXPECT_EQ(packet.get(), copy.get());
+
+  packet.reset();
+  EXPECT_FALSE(data.expired());
+
+  auto moved = std::move(copy);
+  EXPECT_FALSE(copy);
+  EXPECT_FALSE(data.expired());
+
+  moved.reset();
+  EXPECT_TRUE(data.expired());
+}
+
+// Measures how many packets per second a packetizer accepts from its
+// reader via process() and add_packet() and hands on via get_packet()
+// the way the cluster helper fetches them.
+TEST(Packet, DISABLED_Throughput) {
+  for (auto payload_size : std::vector<std::size_t>{ 40, 400, 4000 }) {
+    auto payload = std::string(payload_size, 'x');
+    auto ti      = track_info_c{};
+    fake_reader_c reader;
+    fake_packetizer_c ptzr{&reader, ti};
+    std::vector<packet_cptr> render_group;
+
+    auto seconds = mtxut::seconds_per_loop(5000000, [&](std::size_t idx) {
+      ptzr.process(packet_t::create(memory_c::clone(payload), idx * 1000000ll, 1000000));
+
+      if (idx < 32)
+        return;
+
+      render_group.push_back(ptzr.get_packet());
+
+      if (render_group.size() >= 32)
+        render_group.clear();
+    });
+
+    mtxut::show_benchmark_result(boost::format("payload size %1%: %2$.0f packets/s") % payload_size % (1 / seconds));
+  }
+}
+
+}
@@ -0,0 +1,67 @@
+#include "common/common_pch.h"
+
+#include "merge/queue_budget.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+
+int64_t const s_mib = 1024 * 1024;
+
+// Only the packetizers' addresses are used for keeping track of them.
+char s_fake_packetizers[2];
+auto const &s_ptzr1 = *reinterpret_cast<generic_packetizer_c const *>(&s_fake_packetizers[0]);
+auto const &s_ptzr2 = *reinterpret_cast<generic_packetizer_c const *>(&s_fake_packetizers[1]);
+
+TEST(QueueBudget, Accounting) {
+  auto budget = queue_budget_c{};
+
+  budget.account(s_ptzr1, 10);
+  budget.account(s_ptzr2, 20);
+  budget.account(s_ptzr1, -5);
+  budget.account(s_ptzr2, 30);
+
+  EXPECT_EQ(55, budget.get_total_queued_bytes());
+  EXPECT_EQ(55, budget.get_peak_total_queued_bytes());
+  EXPECT_EQ(10, budget.get_peak_queued_bytes(s_ptzr1));
+  EXPECT_EQ(50, budget.get_peak_queued_bytes(s_ptzr2));
+
+  budget.unregister(s_ptzr2);
+
+  EXPECT_EQ(5,  budget.get_total_queued_bytes());
+  EXPECT_EQ(55, budget.get_peak_total_queued_bytes());
+  EXPECT_EQ(0,  budget.get_peak_queued_bytes(s_ptzr2));
+}
+
+TEST(QueueBudget, ReaderLimits) {
+  auto budget = queue_budget_c{};
+
+  EXPECT_FALSE(budget.must_hold( 20 * s_mib, false, false));
+  EXPECT_TRUE(budget.must_hold(  21 * s_mib, false, false));
+  EXPECT_FALSE(budget.must_hold( 21 * s_mib, false, true));
+  EXPECT_FALSE(budget.must_hold( 21 * s_mib, true,  false));
+  EXPECT_FALSE(budget.must_hold(128 * s_mib, true,  false));
+  EXPECT_TRUE(budget.must_hold( 129 * s_mib, true,  false));
+  EXPECT_FALSE(budget.must_hold(129 * s_mib, true,  false, 512 * s_mib));
+  EXPECT_FALSE(budget.must_hold(129 * s_mib, true,  true));
+}
+
+TEST(QueueBudget, GlobalLimit) {
+  auto budget = queue_budget_c{};
+
+  budget.account(s_ptzr1, 5 * s_mib);
+  budget.account(s_ptzr2, 5 * s_mib);
+
+  EXPECT_FALSE(budget.must_hold(0, true, false));
+
+  budget.set_limit(8 * s_mib);
+
+  EXPECT_TRUE(budget.must_hold(0, true, false));
+  EXPECT_FALSE(budget.must_hold(0, true, true));
+
+  budget.account(s_ptzr2, -3 * s_mib);
+
+  EXPECT_FALSE(budget.must_hold(0, true, false));
+}
+
+}
@@ -64,7 +64,7 @@ TEST(TimestampCalculator, WithTimestampsProvidedByUInt) {
 TEST(TimestampCalculator, WithTimestampsProvidedByPacket) {
   auto calc = timestamp_calculator_c{48000ll};
 
-  auto packet = std::make_shared<packet_t>();
+  auto packet = packet_t::create();
   packet->timecode = 10000000000;
   calc.add_timestamp(packet);
   ASSERT_EQ(timestamp_c::s(10), calc.get_next_timestamp(0));
@@ -90,7 +90,7 @@ TEST(TimestampCalculator, WithTimestampsProvidedByPacket) {
 TEST(TimestampCalculator, WithInvalidTimestampsProvided) {
   auto calc = timestamp_calculator_c{48000ll};
 
-  auto packet = std::make_shared<packet_t>();
+  auto packet = packet_t::create();
   packet->timecode = -1;
   calc.add_timestamp(timestamp_c{});
   calc.add_timestamp(-1);
@@ -0,0 +1,38 @@
+#include "common/common_pch.h"
+
+#include "common/output.h"
+#include "propedit/propedit_cli_parser.h"
+
+#include "gtest/gtest.h"
+#include "tests/unit/init.h"
+
+namespace {
+
+using strings_t = std::vector<std::string>;
+
+TEST(PropeditCliParser, ArgsForProcessingSeveralFiles) {
+  auto redirect_file_name = (bfs::temp_directory_path() / bfs::unique_path("mkvpropedit-unit-test-%%%%-%%%%.txt")).string();
+  auto original_stdio     = g_mm_stdio;
+
+  propedit_cli_parser_c parser{strings_t{ "-r", redirect_file_name, "--jobs", "2", "--debug", "propedit_unit_test", "a.mkv", "--edit", "info", "--set", "title=Movie", "b.mkv" }};
+  auto options = parser.run();
+
+  EXPECT_EQ(2u,                                                        options->m_num_jobs);
+  EXPECT_EQ((strings_t{ "a.mkv", "b.mkv" }),                           options->get_all_file_names());
+  EXPECT_EQ((strings_t{ "--edit", "info", "--set", "title=Movie" }), parser.get_args_without_file_names());
+  EXPECT_EQ((strings_t{ "--debug", "propedit_unit_test" }),            parser.get_common_args());
+
+  g_mm_stdio = original_stdio;
+  boost::system::error_code ec;
+  bfs::remove(redirect_file_name, ec);
+}
+
+TEST(PropeditCliParser, CommonArgsInTheOrderTheyAreHandled) {
+  propedit_cli_parser_c parser{strings_t{ "a.mkv", "--output-charset", "UTF-8", "--edit", "info", "--debug", "propedit_unit_test", "--set", "title=Movie" }};
+  parser.run();
+
+  EXPECT_EQ((strings_t{ "--debug", "propedit_unit_test", "--output-charset", "UTF-8" }), parser.get_common_args());
+  EXPECT_EQ((strings_t{ "--edit", "info", "--set", "title=Movie" }),                    parser.get_args_without_file_names());
+}
+
+}